@@ -0,0 +1,82 @@
+"""Cleartext evaluation suite of MLPSigmoid over test_rows.csv.
+
+The reference for the FHE suites: it classifies the same rows, in the same
+order, and writes the same suite report, so the tuner can compare their
+misclassifications.
+"""
+
+import argparse
+import time
+
+import numpy as np
+import torch
+
+from demos.cc_fraud.torch.model import MLPSigmoid
+from demos.cc_fraud.utils.data_utils import load_all_test_rows
+from demos.common.python import path_utils
+from demos.common.python import suite_report
+
+resolve_path = path_utils.resolve_path
+
+
+def main():
+  parser = argparse.ArgumentParser()
+  parser.add_argument("--csv_path", type=str, default="test_rows.csv")
+  parser.add_argument(
+      "--limit", type=int, default=None, help="Limit number of rows to test"
+  )
+  parser.add_argument(
+      "--report",
+      type=str,
+      default=None,
+      help="Write a suite report to this file",
+  )
+  args = parser.parse_args()
+
+  csv_path = args.csv_path
+  if csv_path == "test_rows.csv":
+    csv_path = resolve_path("demos/cc_fraud/data/test_rows.csv")
+
+  checkpoint = torch.load(
+      resolve_path("demos/cc_fraud/data/mlp_fraud_model_sigmoid.pt"),
+      map_location="cpu",
+      weights_only=False,
+  )
+  model = MLPSigmoid(
+      checkpoint["input_dim"],
+      checkpoint["hidden_dims"],
+      checkpoint["n_classes"],
+  )
+  model.load_state_dict(checkpoint["model_state_dict"])
+  model.eval()
+
+  all_features, expected_labels = load_all_test_rows(csv_path)
+  if args.limit is not None:
+    all_features = all_features[: args.limit]
+    expected_labels = expected_labels[: args.limit]
+  num_rows = len(all_features)
+  report_data = suite_report.SuiteReport("cc_fraud", "cleartext", num_rows)
+
+  misclassifications = []
+  with torch.no_grad():
+    for idx in range(num_rows):
+      t0 = time.perf_counter()
+      logits = model(torch.tensor([all_features[idx]]))
+      report_data.eval_latency_s[idx] = time.perf_counter() - t0
+      report_data.evaluate_s += report_data.eval_latency_s[idx]
+      predicted_class = int(np.argmax(logits.numpy()[0]))
+      if predicted_class == expected_labels[idx]:
+        report_data.correct += 1
+      else:
+        misclassifications.append(
+            (idx, expected_labels[idx], predicted_class)
+        )
+
+  print(f"Correct: {report_data.correct}/{num_rows}")
+  for idx, expected, got in misclassifications:
+    print(f"  Row {idx}: expected {expected}, got {got}")
+  report_data.write(args.report)
+
+
+if __name__ == "__main__":
+  main()
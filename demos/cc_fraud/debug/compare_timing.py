@@ -0,0 +1,136 @@
+"""Aligns the per-operator timings of the Lattigo and OpenFHE timing builds.
+
+Runs both evaluate_fhe_timing binaries on the same row, pairs their sections
+by the debug.name attributes of model_timing.mlir and prints the time ratio
+and level difference of every section, and the totals per layer type (the
+suffix of the section name, e.g. matmul, bias or sigmoid).
+"""
+
+import argparse
+import collections
+import subprocess
+import sys
+
+from demos.common.python import path_utils
+from demos.common.python import timing_log
+
+resolve_path = path_utils.resolve_path
+
+LATTIGO_BINARY = "fully_homomorphic_encryption/demos/cc_fraud/lattigo/evaluate_fhe_timing_/evaluate_fhe_timing"
+OPENFHE_BINARY = (
+    "fully_homomorphic_encryption/demos/cc_fraud/openfhe/evaluate_fhe_timing"
+)
+
+
+def run_timing(cmd, runs):
+  """Runs a timing binary runs times and returns its median sections."""
+  results = []
+  for _ in range(runs):
+    out = subprocess.run(cmd, check=True, capture_output=True, text=True)
+    sections = timing_log.parse(out.stdout)
+    if not sections:
+      raise RuntimeError(f"{cmd[0]} printed no timing sections")
+    results.append(sections)
+  return timing_log.median_sections(results)
+
+
+def ratio(lattigo_s, openfhe_s):
+  return openfhe_s / lattigo_s if lattigo_s > 0 else float("inf")
+
+
+def fmt(value, spec, width):
+  if value is None:
+    return "-".rjust(width)
+  return format(value, f"{width}{spec}")
+
+
+def print_sections(aligned, slow_ratio):
+  header = (
+      f"{'section':<20} {'lattigo s':>10} {'openfhe s':>10}"
+      f" {'O/L':>7} {'lvl L':>6} {'lvl O':>6} {'dlvl':>5}"
+  )
+  print(header)
+  print("-" * len(header))
+  for s in aligned:
+    lat_s = s.a.seconds if s.a else None
+    ofhe_s = s.b.seconds if s.b else None
+    lat_level = s.a.level if s.a else None
+    ofhe_level = s.b.level if s.b else None
+    r = ratio(lat_s, ofhe_s) if s.a and s.b else None
+    dlevel = (
+        ofhe_level - lat_level
+        if lat_level is not None and ofhe_level is not None
+        else None
+    )
+    note = ""
+    if r is not None and r >= slow_ratio:
+      note = "  << OpenFHE slow"
+    elif r is not None and r <= 1 / slow_ratio:
+      note = "  << Lattigo slow"
+    print(
+        f"{s.name:<20} {fmt(lat_s, '.4f', 10)} {fmt(ofhe_s, '.4f', 10)}"
+        f" {fmt(r, '.2f', 7)} {fmt(lat_level, 'd', 6)}"
+        f" {fmt(ofhe_level, 'd', 6)} {fmt(dlevel, '+d', 5)}{note}"
+    )
+
+
+def print_layer_types(aligned):
+  totals = collections.defaultdict(lambda: [0.0, 0.0])
+  for s in aligned:
+    if s.a and s.b:
+      layer_type = s.name.rsplit("_", 1)[-1]
+      totals[layer_type][0] += s.a.seconds
+      totals[layer_type][1] += s.b.seconds
+  totals["total"] = [
+      sum(t[0] for t in totals.values()),
+      sum(t[1] for t in totals.values()),
+  ]
+  header = f"{'layer type':<20} {'lattigo s':>10} {'openfhe s':>10} {'O/L':>7}"
+  print(header)
+  print("-" * len(header))
+  for layer_type, (lat_s, ofhe_s) in totals.items():
+    print(
+        f"{layer_type:<20} {lat_s:10.4f} {ofhe_s:10.4f}"
+        f" {ratio(lat_s, ofhe_s):7.2f}"
+    )
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument(
+      "--row_idx", type=int, default=0, help="Row of test_rows.csv to use"
+  )
+  parser.add_argument(
+      "--runs",
+      type=int,
+      default=3,
+      help="Runs per backend; section times are the median over runs",
+  )
+  parser.add_argument(
+      "--slow_ratio",
+      type=float,
+      default=3.0,
+      help="Flag sections where one backend is this many times slower",
+  )
+  args = parser.parse_args()
+
+  print(f"Running the Lattigo timing build {args.runs}x...", file=sys.stderr)
+  lattigo = run_timing(
+      [resolve_path(LATTIGO_BINARY), f"-row_idx={args.row_idx}"], args.runs
+  )
+  print(f"Running the OpenFHE timing build {args.runs}x...", file=sys.stderr)
+  openfhe = run_timing(
+      [resolve_path(OPENFHE_BINARY), f"--row_idx={args.row_idx}"], args.runs
+  )
+
+  aligned = timing_log.align(lattigo, openfhe)
+  print(f"\ncc_fraud row {args.row_idx}, median of {args.runs} runs")
+  print("O/L is OpenFHE time over Lattigo time; dlvl is OpenFHE level minus")
+  print("Lattigo level after the section.\n")
+  print_sections(aligned, args.slow_ratio)
+  print()
+  print_layer_types(aligned)
+
+
+if __name__ == "__main__":
+  main()
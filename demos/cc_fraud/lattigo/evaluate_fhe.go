@@ -9,6 +9,7 @@ import (
 	"fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo"
 	"fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo_utils"
 	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
 )
 
 func main() {
@@ -52,6 +53,12 @@ func main() {
 	preprocessedWeights := fraud_model_lattigo_utils.Cc_fraud__preprocessing(params, ecd)
 	fmt.Printf("  Took %v\n", time.Since(t0))
 
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Printf("Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
 	// FHE evaluation
 	fmt.Println("Running FHE evaluation (preprocessed)...")
 	t0 = time.Now()
@@ -63,6 +70,10 @@ func main() {
 		preprocessedWeights,
 	)
 	fmt.Printf("  Took %v\n", time.Since(t0))
+	if err := stopProfiles(); err != nil {
+		fmt.Printf("Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
 
 	// Decrypt
 	fmt.Println("Decrypting output...")
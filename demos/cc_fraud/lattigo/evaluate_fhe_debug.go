@@ -10,6 +10,7 @@ import (
 	"fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo_debug"
 	"fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo_debug_utils"
 	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
 )
 
 func main() {
@@ -56,6 +57,12 @@ func main() {
 	preprocessedWeights := fraud_model_lattigo_debug_utils.Cc_fraud__preprocessing(params, ecd)
 	fmt.Printf("  Took %v\n", time.Since(t0))
 
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Printf("Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
 	// FHE evaluation (with debug callbacks)
 	fmt.Println("\n--- Starting FHE Evaluation (with Debug Callbacks) ---")
 	t0 = time.Now()
@@ -67,6 +74,10 @@ func main() {
 		preprocessedWeights,
 	)
 	fmt.Printf("--- FHE Evaluation Completed in %v ---\n\n", time.Since(t0))
+	if err := stopProfiles(); err != nil {
+		fmt.Printf("Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
 
 	// Decrypt
 	fmt.Println("Decrypting final output...")
@@ -1,18 +1,44 @@
 package main
 
 import (
+	"flag"
 	"fmt"
 	"os"
-	"sync"
+	"runtime"
 	"time"
 
 	"fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo"
 	"fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo_utils"
 	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
+	"fully_homomorphic_encryption/demos/common/go/suitereport"
+	"fully_homomorphic_encryption/demos/common/go/workerpool"
+	"fully_homomorphic_encryption/demos/common/lattigo/recycle"
 	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
 )
 
+// worker holds the per-goroutine copies of the Lattigo objects, which are not
+// safe for concurrent use. Only the fields its phase needs are set. With
+// recycling, evaluation workers also own their zero accumulators.
+type worker struct {
+	evaluator *ckks.Evaluator
+	ecd       *ckks.Encoder
+	encryptor *rlwe.Encryptor
+	decryptor *rlwe.Decryptor
+	zeros     *recycle.Zeros
+}
+
 func main() {
+	workersFlag := flag.Int("workers", runtime.NumCPU(), "Number of concurrent evaluation workers")
+	encryptWorkersFlag := flag.Int("encrypt_workers", runtime.NumCPU(), "Number of concurrent encryption workers")
+	decryptWorkersFlag := flag.Int("decrypt_workers", runtime.NumCPU(), "Number of concurrent decryption workers")
+	recycleFlag := flag.Bool("recycle", true, "Keep evaluator copies and zero accumulators per worker and re-encrypt the accumulators in place, instead of allocating both per row")
+	limitFlag := flag.Int("limit", 0, "Limit number of rows to test (0 for all)")
+	reportFlag := flag.String("report", "", "Write a suite report for compare_backends to this file")
+	flag.Parse()
+	recycling := *recycleFlag
+
 	csvPath := "test_rows.csv"
 	if csvPath == "test_rows.csv" {
 		csvPath = pathutils.ResolvePath("fully_homomorphic_encryption/demos/cc_fraud/data/test_rows.csv")
@@ -25,60 +51,130 @@ func main() {
 		fmt.Printf("Error loading test rows: %v\n", err)
 		os.Exit(1)
 	}
+	if *limitFlag > 0 && *limitFlag < len(allFeatures) {
+		allFeatures, expectedLabels = allFeatures[:*limitFlag], expectedLabels[:*limitFlag]
+	}
 	numRows := len(allFeatures)
+	report := suitereport.New("cc_fraud", "lattigo", numRows)
 	fmt.Printf("  Loaded %d rows in %v\n", numRows, time.Since(t0))
 
 	// Configure context (ONCE)
 	fmt.Println("Configuring Lattigo context...")
 	t0 = time.Now()
 	evaluator, params, ecd, encryptor, decryptor := fraud_model_lattigo.Cc_fraud__configure()
+	report.Setup = time.Since(t0).Seconds()
 	fmt.Printf("  Took %v\n", time.Since(t0))
+	if keys, ok := evaluator.GetEvaluationKeySet().(interface{ BinarySize() int }); ok {
+		report.EvalKeyBytes = int64(keys.BinarySize())
+	}
 
 	// Preprocessing (ONCE)
 	fmt.Println("Running preprocessing for model weights...")
 	t0 = time.Now()
 	preprocessedWeights := fraud_model_lattigo_utils.Cc_fraud__preprocessing(params, ecd)
+	report.Preprocessing = time.Since(t0).Seconds()
 	fmt.Printf("  Took %v\n", time.Since(t0))
 
-	// 1. Sequential Encryption (Encryptor is typically not thread-safe)
-	fmt.Println("Encrypting all input features and zero accumulators sequentially...")
-	t0 = time.Now()
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Printf("Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
+	// 1. Parallel Encryption (each worker owns ShallowCopies of the encoder,
+	// encryptor and evaluator, which are not thread-safe)
+	if recycling {
+		fmt.Printf("Encrypting all input features on %d workers...\n", *encryptWorkersFlag)
+	} else {
+		fmt.Printf("Encrypting all input features and zero accumulators on %d workers...\n", *encryptWorkersFlag)
+	}
 	encryptedInputs := make([][]*rlwe.Ciphertext, numRows)
 	ctZeros1 := make([]*rlwe.Ciphertext, numRows)
 	ctZeros2 := make([]*rlwe.Ciphertext, numRows)
-	for i := 0; i < numRows; i++ {
-		encryptedInputs[i] = fraud_model_lattigo.Cc_fraud__encrypt__arg0(evaluator, params, ecd, encryptor, allFeatures[i])
-		ctZeros1[i] = fraud_model_lattigo.Cc_fraud__encrypt__zero__0(evaluator, params, ecd, encryptor)
-		ctZeros2[i] = fraud_model_lattigo.Cc_fraud__encrypt__zero__1(evaluator, params, ecd, encryptor)
-	}
-	fmt.Printf("  Took %v\n", time.Since(t0))
+	encStats := workerpool.Run(numRows, workerpool.Config{Workers: *encryptWorkersFlag},
+		func() worker {
+			return worker{evaluator: evaluator.ShallowCopy(), ecd: ecd.ShallowCopy(), encryptor: encryptor.ShallowCopy()}
+		},
+		func(w worker, i int) {
+			encryptedInputs[i] = fraud_model_lattigo.Cc_fraud__encrypt__arg0(w.evaluator, params, w.ecd, w.encryptor, allFeatures[i])
+			if !recycling {
+				ctZeros1[i] = fraud_model_lattigo.Cc_fraud__encrypt__zero__0(w.evaluator, params, w.ecd, w.encryptor)
+				ctZeros2[i] = fraud_model_lattigo.Cc_fraud__encrypt__zero__1(w.evaluator, params, w.ecd, w.encryptor)
+			}
+		})
+	fmt.Printf("  Took %v\n", encStats.Total)
+	report.Encrypt = encStats.Total.Seconds()
 
 	// 2. Parallel FHE Evaluation (Using ShallowCopy for thread safety)
 	fmt.Println("\nStarting parallel FHE evaluation suite...")
 	encryptedOutputs := make([][]*rlwe.Ciphertext, numRows)
-
-	var wg sync.WaitGroup
-	wg.Add(numRows)
-
-	suiteStartTime := time.Now()
-	for i := 0; i < numRows; i++ {
-		go func(idx int) {
-			defer wg.Done()
-			localEvaluator := evaluator.ShallowCopy()
+	mem := workerpool.TakeMemSnapshot()
+	evalStats := workerpool.Run(numRows, workerpool.Config{Workers: *workersFlag},
+		func() *worker {
+			w := &worker{evaluator: evaluator.ShallowCopy(), ecd: ecd.ShallowCopy()}
+			if recycling {
+				w.encryptor = encryptor.ShallowCopy()
+			}
+			return w
+		},
+		func(w *worker, idx int) {
+			zero1, zero2 := ctZeros1[idx], ctZeros2[idx]
+			localEvaluator := w.evaluator
+			if recycling {
+				if w.zeros == nil {
+					w.zeros = recycle.NewZeros(
+						fraud_model_lattigo.Cc_fraud__encrypt__zero__0(w.evaluator, params, w.ecd, w.encryptor),
+						fraud_model_lattigo.Cc_fraud__encrypt__zero__1(w.evaluator, params, w.ecd, w.encryptor),
+					)
+				} else if err := w.zeros.Refresh(w.encryptor); err != nil {
+					fmt.Printf("Error: %v\n", err)
+					os.Exit(1)
+				}
+				zero1, zero2 = w.zeros.Get(0), w.zeros.Get(1)
+			} else {
+				// Fresh evaluator copy per row, for comparison with recycling.
+				localEvaluator = evaluator.ShallowCopy()
+			}
+			tEval := time.Now()
 			encryptedOutputs[idx] = fraud_model_lattigo.Cc_fraud__preprocessed(
-				localEvaluator, params, ecd, encryptedInputs[idx],
-				ctZeros1[idx], ctZeros2[idx],
+				localEvaluator, params, w.ecd, encryptedInputs[idx],
+				zero1, zero2,
 				preprocessedWeights,
 			)
-		}(i)
+			report.EvalLatency[idx] = time.Since(tEval).Seconds()
+			if recycling {
+				w.zeros.Detach(encryptedOutputs[idx])
+			}
+		})
+	memDelta := mem.Since()
+	totalEvalTime := evalStats.Total
+	report.Evaluate = totalEvalTime.Seconds()
+	fmt.Printf("  Parallel evaluation on %d workers completed in %v (average %v per row, wall time)\n",
+		evalStats.Workers, totalEvalTime, totalEvalTime/time.Duration(numRows))
+	fmt.Printf("  Memory (recycle=%v): %v\n", recycling, memDelta)
+
+	// 3. Parallel Decryption, then Verification in row order
+	fmt.Printf("\nDecrypting results on %d workers...\n", *decryptWorkersFlag)
+	predictedClasses := make([]int, numRows)
+	decStats := workerpool.Run(numRows, workerpool.Config{Workers: *decryptWorkersFlag},
+		func() worker {
+			return worker{evaluator: evaluator.ShallowCopy(), ecd: ecd.ShallowCopy(), decryptor: decryptor.ShallowCopy()}
+		},
+		func(w worker, idx int) {
+			decryptedLogits := fraud_model_lattigo.Cc_fraud__decrypt__result0(w.evaluator, params, w.ecd, w.decryptor, encryptedOutputs[idx])
+
+			// Argmax
+			if decryptedLogits[1] > decryptedLogits[0] {
+				predictedClasses[idx] = 1
+			}
+		})
+	fmt.Printf("  Took %v\n\n", decStats.Total)
+	report.Decrypt = decStats.Total.Seconds()
+	if err := stopProfiles(); err != nil {
+		fmt.Printf("Error writing profiles: %v\n", err)
+		os.Exit(1)
 	}
 
-	wg.Wait()
-	totalEvalTime := time.Since(suiteStartTime)
-	fmt.Printf("  Parallel evaluation completed in %v (average %v per row, wall time)\n", totalEvalTime, totalEvalTime/time.Duration(numRows))
-
-	// 3. Sequential Decryption & Verification (Decryptor is typically not thread-safe)
-	fmt.Println("\nDecrypting and verifying results sequentially...")
 	correctCount := 0
 	var misclassifications []struct {
 		idx  int
@@ -87,14 +183,7 @@ func main() {
 	}
 
 	for idx := 0; idx < numRows; idx++ {
-		decryptedLogits := fraud_model_lattigo.Cc_fraud__decrypt__result0(evaluator, params, ecd, decryptor, encryptedOutputs[idx])
-
-		// Argmax
-		predictedClass := 0
-		if decryptedLogits[1] > decryptedLogits[0] {
-			predictedClass = 1
-		}
-
+		predictedClass := predictedClasses[idx]
 		expectedLabel := expectedLabels[idx]
 		isCorrect := (predictedClass == expectedLabel)
 		status := "MISCLASSIFIED"
@@ -113,6 +202,11 @@ func main() {
 	}
 
 	accuracy := float64(correctCount) / float64(numRows)
+	report.Correct = correctCount
+	if err := report.Write(*reportFlag); err != nil {
+		fmt.Printf("Error writing report: %v\n", err)
+		os.Exit(1)
+	}
 	fmt.Printf("\nAccuracy: %d/%d (%.2f%%)\n", correctCount, numRows, accuracy*100)
 
 	if len(misclassifications) > 0 {
@@ -9,6 +9,7 @@ import (
 	"fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo_timing"
 	"fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo_timing_utils"
 	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
 )
 
 func main() {
@@ -52,6 +53,12 @@ func main() {
 	preprocessedWeights := fraud_model_lattigo_timing_utils.Cc_fraud__preprocessing(params, ecd)
 	fmt.Printf("  Took %v\n", time.Since(t0))
 
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Printf("Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
 	// FHE evaluation (preprocessed with timing callbacks)
 	fmt.Println("Running FHE evaluation (preprocessed with timing callbacks)...")
 	t0 = time.Now()
@@ -63,6 +70,10 @@ func main() {
 		preprocessedWeights,
 	)
 	fmt.Printf("  Took %v\n", time.Since(t0))
+	if err := stopProfiles(); err != nil {
+		fmt.Printf("Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
 	fmt.Printf("  MaxLevel: %d, Output Level: %d\n", params.MaxLevel(), encryptedOutput[0].Level())
 
 	// Decrypt
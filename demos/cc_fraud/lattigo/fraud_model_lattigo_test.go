@@ -0,0 +1,84 @@
+package fraud_model_lattigo_test
+
+import (
+	"encoding/csv"
+	"flag"
+	"os"
+	"testing"
+
+	"fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo"
+	"fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo_utils"
+	"fully_homomorphic_encryption/demos/common/go/bench"
+	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
+	"fully_homomorphic_encryption/demos/common/lattigo/primitives"
+	"fully_homomorphic_encryption/demos/common/lattigo/recycle"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+)
+
+var keyDir = flag.String("key_dir", "", "Directory to load keys from, or to save freshly generated keys to")
+
+// numFeatures returns the width of a row of test_rows.csv without its label.
+func numFeatures(b *testing.B) int {
+	file, err := os.Open(pathutils.ResolvePath("fully_homomorphic_encryption/demos/cc_fraud/data/test_rows.csv"))
+	if err != nil {
+		b.Fatal(err)
+	}
+	defer file.Close()
+	header, err := csv.NewReader(file).Read()
+	if err != nil {
+		b.Fatal(err)
+	}
+	return len(header) - 1
+}
+
+func BenchmarkCcFraud(b *testing.B) {
+	evaluator, params, ecd, encryptor, decryptor, err := keystore.Configure(*keyDir, fraud_model_lattigo.Cc_fraud__configure)
+	if err != nil {
+		b.Fatal(err)
+	}
+	weights := fraud_model_lattigo_utils.Cc_fraud__preprocessing(params, ecd)
+	features := make([]float32, numFeatures(b))
+
+	bench.Run(b, bench.Model[[]*rlwe.Ciphertext, []*rlwe.Ciphertext]{
+		Encrypt: func() func() []*rlwe.Ciphertext {
+			evaluator, ecd, encryptor := evaluator.ShallowCopy(), ecd.ShallowCopy(), encryptor.ShallowCopy()
+			return func() []*rlwe.Ciphertext {
+				return fraud_model_lattigo.Cc_fraud__encrypt__arg0(evaluator, params, ecd, encryptor, features)
+			}
+		},
+		Evaluate: func() func([]*rlwe.Ciphertext) []*rlwe.Ciphertext {
+			evaluator, ecd, encryptor := evaluator.ShallowCopy(), ecd.ShallowCopy(), encryptor.ShallowCopy()
+			var zeros *recycle.Zeros
+			return func(in []*rlwe.Ciphertext) []*rlwe.Ciphertext {
+				if zeros == nil {
+					zeros = recycle.NewZeros(
+						fraud_model_lattigo.Cc_fraud__encrypt__zero__0(evaluator, params, ecd, encryptor),
+						fraud_model_lattigo.Cc_fraud__encrypt__zero__1(evaluator, params, ecd, encryptor),
+					)
+				} else if err := zeros.Refresh(encryptor); err != nil {
+					panic(err)
+				}
+				out := fraud_model_lattigo.Cc_fraud__preprocessed(evaluator, params, ecd, in, zeros.Get(0), zeros.Get(1), weights)
+				zeros.Detach(out)
+				return out
+			}
+		},
+		Decrypt: func() func([]*rlwe.Ciphertext) {
+			evaluator, ecd, decryptor := evaluator.ShallowCopy(), ecd.ShallowCopy(), decryptor.ShallowCopy()
+			return func(out []*rlwe.Ciphertext) {
+				fraud_model_lattigo.Cc_fraud__decrypt__result0(evaluator, params, ecd, decryptor, out)
+			}
+		},
+	})
+}
+
+// BenchmarkPrimitives times each CKKS primitive at every level of the model's
+// parameters.
+func BenchmarkPrimitives(b *testing.B) {
+	evaluator, params, ecd, encryptor, _, err := keystore.Configure(*keyDir, fraud_model_lattigo.Cc_fraud__configure)
+	if err != nil {
+		b.Fatal(err)
+	}
+	primitives.Run(b, params, evaluator, ecd, encryptor, nil)
+}
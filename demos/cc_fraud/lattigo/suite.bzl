@@ -0,0 +1,37 @@
+"""Flags and evaluation suite of the Lattigo fraud model.
+
+Shared by the BUILD file and demos/common/python/tune_params.py, which builds
+variants of the model in another package, so the labels are absolute.
+"""
+
+HEIR_OPT_FLAGS = [
+    "--annotate-module=backend=lattigo scheme=ckks",
+    "--torch-linalg-to-ckks=min-slot-count=8192 greedy-level-budget=15 greedy-modulus-switch-after-mul=true experimental-disable-loop-unroll=true first-mod-bits=30 scaling-mod-bits=24",
+    "--scheme-to-lattigo",
+]
+
+# The model and suite attributes of heir_lattigo_param_sweep.
+SWEEP_ATTRS = {
+    "importpath": "fully_homomorphic_encryption/demos/cc_fraud/lattigo/fraud_model_lattigo",
+    "mlir_src": "//demos/cc_fraud/data:model_annotated.mlir",
+    "rows_flag": "-limit",
+    "split_preprocessing": True,
+    "suite_data": [
+        "//demos/cc_fraud/data:test_rows.csv",
+    ],
+    "suite_deps": [
+        "//demos/cc_fraud/lattigo:fraud_model_lattigo",
+        "//demos/cc_fraud/lattigo:fraud_model_lattigo_utils",
+        "//demos/common/go/pathutils",
+        "//demos/common/go/profiling",
+        "//demos/common/go/suitereport",
+        "//demos/common/go/workerpool",
+        "//demos/common/lattigo/recycle",
+        "@com_github_tuneinsight_lattigo_v6//core/rlwe",
+        "@com_github_tuneinsight_lattigo_v6//schemes/ckks",
+    ],
+    "suite_srcs": [
+        "//demos/cc_fraud/lattigo:evaluate_fhe_suite.go",
+        "//demos/cc_fraud/lattigo:utils.go",
+    ],
+}
@@ -0,0 +1,134 @@
+// Google Benchmark targets for the OpenFHE fraud model, one per phase of
+// evaluate_fhe.py. Each benchmark runs at several OpenMP thread counts; pass
+// --benchmark_out=<file> --benchmark_out_format=json for machine-readable
+// results.
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "demos/cc_fraud/openfhe/fraud_model.inc.h"
+#include "demos/common/openfhe/benchmark_helper.h"
+#include "src/pke/include/openfhe.h"
+
+namespace {
+
+// The model has 82 input features.
+constexpr int kNumFeatures = 82;
+
+// The configured context, keys and preprocessed weights, shared by all
+// benchmarks and built on first use.
+struct Model {
+  CryptoContextT cc;
+  lbcrypto::KeyPair<lbcrypto::DCRTPoly> keys;
+  decltype(cc_fraud__preprocessing(cc)) prep;
+  std::vector<float> features = std::vector<float>(kNumFeatures);
+
+  Model() {
+    cc = cc_fraud__generate_crypto_context();
+    keys = cc->KeyGen();
+    cc = cc_fraud__configure_crypto_context(cc, keys.secretKey);
+    prep = cc_fraud__preprocessing(cc);
+  }
+};
+
+Model& GetModel() {
+  static Model* model = new Model();
+  return *model;
+}
+
+void BM_GenerateCryptoContext(benchmark::State& state) {
+  SetThreads(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cc_fraud__generate_crypto_context());
+  }
+}
+BENCHMARK(BM_GenerateCryptoContext)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Also reports the size of the evaluation keys the configuration generates.
+// Each iteration configures under a new key tag; the keys of the previous one
+// are cleared so that only the last set stays in memory.
+void BM_ConfigureCryptoContext(benchmark::State& state) {
+  SetThreads(state);
+  KeyPairT keys;
+  for (auto _ : state) {
+    state.PauseTiming();
+    ClearEvalKeys(keys);
+    auto cc = cc_fraud__generate_crypto_context();
+    keys = cc->KeyGen();
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(
+        cc_fraud__configure_crypto_context(cc, keys.secretKey));
+  }
+  ReportEvalKeyBytes(state, keys);
+}
+BENCHMARK(BM_ConfigureCryptoContext)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_Encrypt(benchmark::State& state) {
+  Model& m = GetModel();
+  SetThreads(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        cc_fraud__encrypt__arg0(m.cc, m.features, m.keys.publicKey));
+  }
+}
+BENCHMARK(BM_Encrypt)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_Preprocessing(benchmark::State& state) {
+  Model& m = GetModel();
+  SetThreads(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cc_fraud__preprocessing(m.cc));
+  }
+}
+BENCHMARK(BM_Preprocessing)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Times the preprocessed evaluation only. The input and the zero accumulators
+// are encrypted afresh, untimed, for every iteration.
+void BM_Evaluate(benchmark::State& state) {
+  Model& m = GetModel();
+  SetThreads(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto input = cc_fraud__encrypt__arg0(m.cc, m.features, m.keys.publicKey);
+    auto zero0 = cc_fraud__encrypt__zero__0(m.cc, m.keys.publicKey);
+    auto zero1 = cc_fraud__encrypt__zero__1(m.cc, m.keys.publicKey);
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(
+        cc_fraud__preprocessed(m.cc, input, zero0, zero1, m.prep));
+  }
+}
+BENCHMARK(BM_Evaluate)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_Decrypt(benchmark::State& state) {
+  Model& m = GetModel();
+  SetThreads(state);
+  auto output = cc_fraud__preprocessed(
+      m.cc, cc_fraud__encrypt__arg0(m.cc, m.features, m.keys.publicKey),
+      cc_fraud__encrypt__zero__0(m.cc, m.keys.publicKey),
+      cc_fraud__encrypt__zero__1(m.cc, m.keys.publicKey), m.prep);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        cc_fraud__decrypt__result0(m.cc, output, m.keys.secretKey));
+  }
+}
+BENCHMARK(BM_Decrypt)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
@@ -1,15 +1,17 @@
 """Evaluate a suite of test rows using OpenFHE."""
 
 import argparse
+import importlib
 import os
 import time
 
 import numpy as np
 import pandas as pd
 
-from demos.cc_fraud.openfhe import fraud_model_pybind
 from demos.cc_fraud.utils.data_utils import load_all_test_rows
 from demos.common.python import path_utils
+from demos.common.python import pipeline
+from demos.common.python import suite_report
 
 resolve_path = path_utils.resolve_path
 
@@ -20,7 +22,59 @@ def main():
   parser.add_argument(
       "--limit", type=int, default=None, help="Limit number of rows to test"
   )
+  parser.add_argument(
+      "--pipeline",
+      action="store_true",
+      help=(
+          "Run encryption, evaluation and decryption as concurrent stages"
+          " connected by bounded queues"
+      ),
+  )
+  parser.add_argument(
+      "--encrypt_workers",
+      type=int,
+      default=1,
+      help="Number of encryption threads in pipeline mode",
+  )
+  parser.add_argument(
+      "--evaluate_workers",
+      type=int,
+      default=1,
+      help="Number of evaluation threads in pipeline mode",
+  )
+  parser.add_argument(
+      "--decrypt_workers",
+      type=int,
+      default=1,
+      help="Number of decryption threads in pipeline mode",
+  )
+  parser.add_argument(
+      "--queue_depth",
+      type=int,
+      default=2,
+      help="Maximum number of rows waiting between two pipeline stages",
+  )
+  parser.add_argument(
+      "--report",
+      type=str,
+      default=None,
+      help="Write a suite report for compare_backends to this file",
+  )
+  parser.add_argument(
+      "--model_module",
+      type=str,
+      default=None,
+      help=(
+          "Generated module to use instead of fraud_model_pybind, e.g. a"
+          " variant built by the param_sweep target"
+      ),
+  )
   args = parser.parse_args()
+  # The param_sweep variants only depend on their own module, so the default
+  # one is imported only when no other is given.
+  model = importlib.import_module(
+      args.model_module or "demos.cc_fraud.openfhe.fraud_model_pybind"
+  )
 
   csv_path = args.csv_path
   if csv_path == "test_rows.csv":
@@ -36,11 +90,13 @@ def main():
     expected_labels = expected_labels[: args.limit]
   num_rows = len(all_features)
   print(f"  Loaded {num_rows} rows in {time.time() - t0:.4f} seconds")
+  report_data = suite_report.SuiteReport("cc_fraud", "openfhe", num_rows)
 
   # Initialize crypto context (ONCE)
   print("Generating crypto context...")
+  t_setup = time.time()
   t0 = time.time()
-  cc = fraud_model_pybind.cc_fraud__generate_crypto_context()
+  cc = model.cc_fraud__generate_crypto_context()
   print(f"  Took {time.time() - t0:.4f} seconds")
 
   print("Generating key pair...")
@@ -52,46 +108,55 @@ def main():
 
   print("Configuring crypto context...")
   t0 = time.time()
-  cc = fraud_model_pybind.cc_fraud__configure_crypto_context(cc, secret_key)
+  cc = model.cc_fraud__configure_crypto_context(cc, secret_key)
   print(f"  Took {time.time() - t0:.4f} seconds")
+  report_data.setup_s = time.time() - t_setup
 
   # Run preprocessing (ONCE)
   print("Running preprocessing for model weights...")
   t0 = time.time()
-  prep_struct = fraud_model_pybind.cc_fraud__preprocessing(cc)
+  prep_struct = model.cc_fraud__preprocessing(cc)
+  report_data.preprocessing_s = time.time() - t0
   print(f"  Took {time.time() - t0:.4f} seconds")
 
-  print("\nStarting FHE evaluation suite...")
-  correct_count = 0
-  misclassifications = []
-
-  suite_start_time = time.time()
-  for idx in range(num_rows):
-    features = all_features[idx]
-    expected_label = expected_labels[idx]
-
+  def encrypt(idx):
+    t0 = time.perf_counter()
     # Encrypt input features and zero accumulators
-    encrypted_features = fraud_model_pybind.cc_fraud__encrypt__arg0(
-        cc, features, public_key
+    encrypted_features = model.cc_fraud__encrypt__arg0(
+        cc, all_features[idx], public_key
     )
-    ct_zero_1 = fraud_model_pybind.cc_fraud__encrypt__zero__0(cc, public_key)
-    ct_zero_2 = fraud_model_pybind.cc_fraud__encrypt__zero__1(cc, public_key)
+    ct_zero_1 = model.cc_fraud__encrypt__zero__0(cc, public_key)
+    ct_zero_2 = model.cc_fraud__encrypt__zero__1(cc, public_key)
+    report_data.record_phase("encrypt", t0, time.perf_counter())
+    return encrypted_features, ct_zero_1, ct_zero_2
 
+  def evaluate(idx, encrypted_inputs):
+    t0 = time.perf_counter()
     # Call the FHE function (using preprocessed weights)
-    encrypted_output = fraud_model_pybind.cc_fraud__preprocessed(
+    encrypted_output = model.cc_fraud__preprocessed(
         cc,
-        encrypted_features,
-        ct_zero_1,
-        ct_zero_2,
+        *encrypted_inputs,
         prep_struct,
     )
-
-    # Decrypt output
-    decrypted_logits = fraud_model_pybind.cc_fraud__decrypt__result0(
+    t1 = time.perf_counter()
+    report_data.eval_latency_s[idx] = t1 - t0
+    report_data.record_phase("evaluate", t0, t1)
+    return encrypted_output
+
+  def decrypt(idx, encrypted_output):
+    t0 = time.perf_counter()
+    decrypted_logits = model.cc_fraud__decrypt__result0(
         cc, encrypted_output, secret_key
     )
-    predicted_class = int(np.argmax(decrypted_logits))
+    report_data.record_phase("decrypt", t0, time.perf_counter())
+    return int(np.argmax(decrypted_logits))
 
+  correct_count = 0
+  misclassifications = []
+
+  def report(idx, predicted_class):
+    nonlocal correct_count
+    expected_label = expected_labels[idx]
     is_correct = predicted_class == expected_label
     status = "SUCCESS" if is_correct else "MISCLASSIFIED"
 
@@ -105,7 +170,40 @@ def main():
     else:
       misclassifications.append((idx, expected_label, predicted_class))
 
-  total_time = time.time() - suite_start_time
+  if args.pipeline:
+    print("\nStarting pipelined FHE evaluation suite...")
+    print(
+        f"  Workers: {args.encrypt_workers} encrypt /"
+        f" {args.evaluate_workers} evaluate / {args.decrypt_workers} decrypt,"
+        f" queue depth {args.queue_depth}"
+    )
+    stats = pipeline.run_pipeline(
+        num_rows,
+        encrypt,
+        evaluate,
+        decrypt,
+        report,
+        encrypt_workers=args.encrypt_workers,
+        evaluate_workers=args.evaluate_workers,
+        decrypt_workers=args.decrypt_workers,
+        queue_depth=args.queue_depth,
+    )
+    total_time = stats.total_s
+    misclassifications.sort()
+    print(
+        f"\nTime to first result: {stats.first_result_s:.2f} seconds, max rows"
+        f" in flight: {stats.max_in_flight}"
+    )
+  else:
+    print("\nStarting FHE evaluation suite...")
+    suite_start_time = time.time()
+    for idx in range(num_rows):
+      report(idx, decrypt(idx, evaluate(idx, encrypt(idx))))
+    total_time = time.time() - suite_start_time
+
+  report_data.correct = correct_count
+  report_data.write(args.report)
+
   accuracy = correct_count / num_rows if num_rows > 0 else 0
   print(
       f"\nSuite completed in {total_time:.2f} seconds (average"
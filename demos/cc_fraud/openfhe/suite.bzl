@@ -0,0 +1,33 @@
+"""Flags and evaluation suite of the OpenFHE fraud model.
+
+Shared by the BUILD file and demos/common/python/tune_params.py, which builds
+variants of the model in another package, so the labels are absolute.
+"""
+
+load("@demo_pip_deps//:requirements.bzl", "requirement")
+
+HEIR_OPT_FLAGS = [
+    "--annotate-module=backend=openfhe scheme=ckks",
+    "--torch-linalg-to-ckks=min-slot-count=8192 greedy-level-budget=15 greedy-modulus-switch-after-mul=true experimental-disable-loop-unroll=true first-mod-bits=30 scaling-mod-bits=24",
+    "--scheme-to-openfhe=scaling-technique-fixed-manual=true",
+]
+
+# The model and suite attributes of heir_openfhe_param_sweep.
+SWEEP_ATTRS = {
+    "mlir_src": "//demos/cc_fraud/data:model_annotated.mlir",
+    "pybind_target_name": "fraud_model_pybind",
+    "rows_flag": "--limit",
+    "suite_data": [
+        "//demos/cc_fraud/data:test_rows.csv",
+    ],
+    "suite_deps": [
+        "//demos/cc_fraud/openfhe:fraud_model_pybind",
+        "//demos/cc_fraud/utils:data_utils",
+        "//demos/common/python:path_utils",
+        "//demos/common/python:pipeline",
+        "//demos/common/python:suite_report",
+        requirement("numpy"),
+        requirement("pandas"),
+    ],
+    "suite_src": "//demos/cc_fraud/openfhe:evaluate_fhe_suite.py",
+}
@@ -0,0 +1,299 @@
+"""Macros that build a model for a grid of CKKS compilation parameters.
+
+The demos hard-code their --torch-linalg-to-ckks options (level budget,
+modulus bit sizes, slot count, ...). A param sweep compiles the model once per
+point of a grid of those options, builds the model's evaluation suite against
+every variant, and adds a runner that benchmarks all of them on the suite data
+(see demos/common/python/param_sweep.py):
+
+    bazel run -c opt //demos/cc_fraud/lattigo:param_sweep -- --rows=100
+
+Instead of a grid, a sweep can list its variants as points, which is how
+demos/common/python/tune_params.py builds the candidates of its search. The
+suite attributes may then be labels of another package.
+
+All generated targets are tagged manual, so `bazel build //...` does not
+compile the variants.
+"""
+
+load("@rules_go//go:def.bzl", "go_binary")
+load("@rules_heir//heir:lattigo.bzl", "heir_lattigo_lib")
+load("@rules_heir//heir:openfhe.bzl", "heir_openfhe_lib")
+load("@rules_python//python:defs.bzl", "py_binary")
+
+_CKKS_FLAG = "--torch-linalg-to-ckks="
+
+_RUNNER = "//demos/common/python:param_sweep.py"
+
+_RUNNER_DEPS = [
+    "//demos/common/python:path_utils",
+    "//demos/common/python:suite_runner",
+]
+
+def _option_str(value):
+    if type(value) == "bool":
+        return "true" if value else "false"
+    return str(value)
+
+def _abbrev(option):
+    """Returns the initials of an option, e.g. glb for greedy-level-budget."""
+    return "".join([word[0] for word in option.split("-") if word])
+
+def ckks_param_grid(grid):
+    """Returns the points of grid as (suffix, options) pairs.
+
+    Args:
+      grid: dict from --torch-linalg-to-ckks option to the list of values to
+        try, e.g. {"greedy-level-budget": [12, 15]}.
+
+    Returns:
+      One pair per combination of values. suffix names the point, e.g.
+      glb12_fmb30, and options maps every option of grid to its value.
+    """
+    points = [("", {})]
+    for option, values in grid.items():
+        expanded = []
+        for suffix, options in points:
+            for value in values:
+                point = dict(options)
+                point[option] = value
+                name = _abbrev(option) + _option_str(value)
+                expanded.append((suffix + "_" + name if suffix else name, point))
+        points = expanded
+    return points
+
+def _variants(grid, points):
+    if (grid == None) == (points == None):
+        fail("exactly one of grid and points must be set")
+    if grid != None:
+        return ckks_param_grid(grid)
+    return points.items()
+
+def _basename(label):
+    return label.rpartition(":")[2].rpartition("/")[2]
+
+def _replace_dep(deps, target, replacement):
+    """Replaces target, given by name, in deps, given as labels."""
+    return [
+        replacement if dep == ":" + target or dep.endswith(":" + target) else dep
+        for dep in deps
+    ]
+
+def with_ckks_options(heir_opt_flags, options):
+    """Returns heir_opt_flags with options set in its --torch-linalg-to-ckks flag.
+
+    Options the flag already sets are overridden; new ones are appended.
+    """
+    flags = []
+    for flag in heir_opt_flags:
+        if not flag.startswith(_CKKS_FLAG):
+            flags.append(flag)
+            continue
+        merged = {}
+        for option in flag[len(_CKKS_FLAG):].split(" "):
+            if option:
+                key, _, value = option.partition("=")
+                merged[key] = value
+        for key, value in options.items():
+            merged[key] = _option_str(value)
+        flags.append(_CKKS_FLAG + " ".join([
+            "%s=%s" % (key, value)
+            for key, value in merged.items()
+        ]))
+    return flags
+
+def _options_arg(options):
+    return ",".join([
+        "%s=%s" % (key, _option_str(value))
+        for key, value in options.items()
+    ])
+
+def _runner(name, model, backend, rows_flag, variant_args, binaries):
+    py_binary(
+        name = name,
+        srcs = [_RUNNER],
+        args = [
+            "--model=" + model,
+            "--backend=" + backend,
+            "--rows_flag=" + rows_flag,
+        ] + variant_args,
+        data = binaries,
+        main = _RUNNER,
+        tags = [
+            "manual",
+            "nofastbuild",
+        ],
+        deps = _RUNNER_DEPS,
+    )
+
+def heir_lattigo_param_sweep(
+        name,
+        model,
+        heir_opt_flags,
+        mlir_src,
+        importpath,
+        suite_srcs,
+        suite_deps,
+        rows_flag,
+        grid = None,
+        points = None,
+        suite_data = [],
+        split_preprocessing = None):
+    """Builds a Lattigo suite binary per grid point, and their runner.
+
+    For each point, a heir_lattigo_lib named <name>_<suffix>_lib is compiled
+    with the options of the point, and the go_binary <name>_<suffix> is built
+    from suite_srcs against it. The suite sources keep importing the model
+    library by importpath; a copy of them is rewritten to import the variant
+    under the original package name.
+
+    Args:
+      name: name of the runner; the variants are prefixed with it.
+      model: model name shown in the report.
+      heir_opt_flags: the flags of the model library; the grid options
+        override its --torch-linalg-to-ckks options.
+      mlir_src: the model MLIR.
+      importpath: importpath of the model library the suite imports.
+      suite_srcs: Go sources of the suite binary.
+      suite_deps: deps of the suite binary. The model library and its utils
+        library, as :<basename of importpath>[_utils], are replaced by the
+        variant's.
+      rows_flag: flag of the suite that limits the number of rows.
+      grid: dict from --torch-linalg-to-ckks option to the values to try.
+      points: dict from variant suffix to the options of the variant, instead
+        of grid.
+      suite_data: data of the suite binary.
+      split_preprocessing: passed to heir_lattigo_lib, unless None.
+    """
+    package = importpath.rpartition("/")[2]
+    lib_dir = importpath.partition("/")[0] + "/" + native.package_name()
+    variant_args = []
+    binaries = []
+    for suffix, options in _variants(grid, points):
+        variant = "%s_%s" % (name, suffix)
+        lib = variant + "_lib"
+        lib_kwargs = {}
+        if split_preprocessing != None:
+            lib_kwargs["split_preprocessing"] = split_preprocessing
+        heir_lattigo_lib(
+            name = lib,
+            go_library_name = lib,
+            heir_opt_flags = with_ckks_options(heir_opt_flags, options),
+            importpath = lib_dir + "/" + lib,
+            mlir_src = mlir_src,
+            tags = ["manual"],
+            **lib_kwargs
+        )
+
+        srcs = []
+        for src in suite_srcs:
+            out = "%s_srcs/%s" % (variant, _basename(src))
+            native.genrule(
+                name = "%s_%s" % (variant, _basename(src).replace(".", "_")),
+                srcs = [src],
+                outs = [out],
+                cmd = ("sed -e 's#\"{old}\"#{pkg} \"{new}\"#' " +
+                       "-e 's#\"{old}_utils\"#{pkg}_utils \"{new}_utils\"#' " +
+                       "$< > $@").format(
+                    old = importpath,
+                    new = lib_dir + "/" + lib,
+                    pkg = package,
+                ),
+                tags = ["manual"],
+            )
+            srcs.append(out)
+
+        deps = _replace_dep(suite_deps, package, ":" + lib)
+        go_binary(
+            name = variant,
+            srcs = srcs,
+            data = suite_data,
+            pure = "on",
+            tags = ["manual"],
+            deps = _replace_dep(deps, package + "_utils", ":" + lib + "_utils"),
+        )
+        binaries.append(":" + variant)
+        variant_args.append("--variant=%s:%s:$(rlocationpath :%s)" % (
+            suffix,
+            _options_arg(options),
+            variant,
+        ))
+
+    _runner(name, model, "lattigo", rows_flag, variant_args, binaries)
+
+def heir_openfhe_param_sweep(
+        name,
+        model,
+        heir_opt_flags,
+        mlir_src,
+        pybind_target_name,
+        suite_src,
+        suite_deps,
+        rows_flag,
+        grid = None,
+        points = None,
+        suite_data = []):
+    """Builds an OpenFHE suite binary per grid point, and their runner.
+
+    For each point, a heir_openfhe_lib with the pybind module
+    <name>_<suffix>_pybind is compiled with the options of the point, and the
+    py_binary <name>_<suffix> runs suite_src with it. The suite must accept
+    --model_module, the module to use instead of its default one, and import
+    the default module only when the flag is unset: the variants do not
+    depend on it.
+
+    Args:
+      name: name of the runner; the variants are prefixed with it.
+      model: model name shown in the report.
+      heir_opt_flags: the flags of the model library; the grid options
+        override its --torch-linalg-to-ckks options.
+      mlir_src: the model MLIR.
+      pybind_target_name: pybind target of the model library; replaced by the
+        variant's in suite_deps.
+      suite_src: Python main of the suite binary.
+      suite_deps: deps of the suite binary.
+      rows_flag: flag of the suite that limits the number of rows.
+      grid: dict from --torch-linalg-to-ckks option to the values to try.
+      points: dict from variant suffix to the options of the variant, instead
+        of grid.
+      suite_data: data of the suite binary.
+    """
+    module_prefix = native.package_name().replace("/", ".") + "."
+    variant_args = []
+    binaries = []
+    for suffix, options in _variants(grid, points):
+        variant = "%s_%s" % (name, suffix)
+        pybind = variant + "_pybind"
+        heir_openfhe_lib(
+            name = variant + "_lib",
+            cc_lib_linkopts = [],
+            cc_lib_target_name = variant + "_cc_lib",
+            generated_lib_header = variant + ".inc.h",
+            heir_opt_flags = with_ckks_options(heir_opt_flags, options),
+            mlir_src = mlir_src,
+            pybind_target_name = pybind,
+            tags = [
+                "manual",
+                "nofastbuild",
+            ],
+        )
+        py_binary(
+            name = variant,
+            srcs = [suite_src],
+            data = suite_data,
+            main = suite_src,
+            tags = [
+                "manual",
+                "nofastbuild",
+            ],
+            deps = _replace_dep(suite_deps, pybind_target_name, ":" + pybind),
+        )
+        binaries.append(":" + variant)
+        variant_args.append("--variant=%s:%s:$(rlocationpath :%s):%s" % (
+            suffix,
+            _options_arg(options),
+            variant,
+            module_prefix + pybind,
+        ))
+
+    _runner(name, model, "openfhe", rows_flag, variant_args, binaries)
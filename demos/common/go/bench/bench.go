@@ -0,0 +1,116 @@
+// Package bench provides the testing.B benchmarks shared by the generated
+// model libraries, so that `go test -bench` and benchstat can compare them
+// across HEIR and Lattigo versions.
+package bench
+
+import (
+	"sync"
+	"testing"
+)
+
+// Model holds one factory per phase, as in pipeline.Stages. Each factory is
+// called once per benchmark goroutine, outside the timed region, and returns
+// the function that goroutine runs for every iteration, so per-goroutine
+// state (ShallowCopies of the evaluator, encoder, encryptor or decryptor,
+// recycled zero accumulators) can be captured in the returned closure.
+//
+// Keys and preprocessed weights are expected to be set up once by the caller
+// and shared read-only by all factories. CKKS runs the same operations
+// whatever the encrypted values, so Encrypt may encrypt constant inputs, such
+// as zeros, instead of test data.
+type Model[In, Out any] struct {
+	// Encrypt encrypts one input.
+	Encrypt func() func() In
+	// Evaluate runs the preprocessed evaluation of one encrypted input,
+	// including the preparation the generated code needs for every sample,
+	// such as refreshing its zero accumulators.
+	Evaluate func() func(In) Out
+	// Decrypt decrypts and decodes one evaluation output.
+	Decrypt func() func(Out)
+}
+
+// Run benchmarks the encryption, evaluation and decryption of m and the whole
+// round trip as sub-benchmarks of b. Encrypt, Decrypt and RoundTrip also have
+// a b.RunParallel variant that measures multi-core scaling; use -cpu to
+// choose the number of goroutines. Allocations are reported for all of them.
+//
+// Evaluate is only run on one goroutine, as every iteration needs a fresh
+// encryption that is excluded from the timing; the RoundTripParallel variant
+// covers concurrent evaluation.
+func Run[In, Out any](b *testing.B, m Model[In, Out]) {
+	// The encrypted output the Decrypt benchmarks decrypt, computed once and
+	// only if they run.
+	output := sync.OnceValue(func() Out {
+		return m.Evaluate()(m.Encrypt()())
+	})
+
+	b.Run("Encrypt", func(b *testing.B) {
+		encrypt := m.Encrypt()
+		b.ReportAllocs()
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			encrypt()
+		}
+	})
+	b.Run("EncryptParallel", func(b *testing.B) {
+		b.ReportAllocs()
+		b.RunParallel(func(pb *testing.PB) {
+			encrypt := m.Encrypt()
+			for pb.Next() {
+				encrypt()
+			}
+		})
+	})
+
+	b.Run("Evaluate", func(b *testing.B) {
+		encrypt := m.Encrypt()
+		evaluate := m.Evaluate()
+		b.ReportAllocs()
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			b.StopTimer()
+			in := encrypt()
+			b.StartTimer()
+			evaluate(in)
+		}
+	})
+
+	b.Run("Decrypt", func(b *testing.B) {
+		out := output()
+		decrypt := m.Decrypt()
+		b.ReportAllocs()
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			decrypt(out)
+		}
+	})
+	b.Run("DecryptParallel", func(b *testing.B) {
+		out := output()
+		b.ReportAllocs()
+		b.ResetTimer()
+		b.RunParallel(func(pb *testing.PB) {
+			decrypt := m.Decrypt()
+			for pb.Next() {
+				decrypt(out)
+			}
+		})
+	})
+
+	b.Run("RoundTrip", func(b *testing.B) {
+		encrypt, evaluate, decrypt := m.Encrypt(), m.Evaluate(), m.Decrypt()
+		b.ReportAllocs()
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			decrypt(evaluate(encrypt()))
+		}
+	})
+	b.Run("RoundTripParallel", func(b *testing.B) {
+		b.ReportAllocs()
+		b.RunParallel(func(pb *testing.PB) {
+			encrypt, evaluate, decrypt := m.Encrypt(), m.Evaluate(), m.Decrypt()
+			for pb.Next() {
+				decrypt(evaluate(encrypt()))
+			}
+		})
+	})
+}
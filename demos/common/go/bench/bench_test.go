@@ -0,0 +1,32 @@
+package bench
+
+import (
+	"sync/atomic"
+	"testing"
+)
+
+func TestRunCoversEveryPhase(t *testing.T) {
+	var encrypts, evaluates, decrypts atomic.Int64
+	m := Model[int, int]{
+		Encrypt: func() func() int {
+			return func() int { encrypts.Add(1); return 1 }
+		},
+		Evaluate: func() func(int) int {
+			return func(in int) int { evaluates.Add(1); return in + 1 }
+		},
+		Decrypt: func() func(int) {
+			return func(out int) {
+				if out != 2 {
+					t.Errorf("Decrypt got %d, want 2", out)
+				}
+				decrypts.Add(1)
+			}
+		},
+	}
+	testing.Benchmark(func(b *testing.B) { Run(b, m) })
+
+	if encrypts.Load() == 0 || evaluates.Load() == 0 || decrypts.Load() == 0 {
+		t.Errorf("phases run: %d encrypt, %d evaluate, %d decrypt; want all non-zero",
+			encrypts.Load(), evaluates.Load(), decrypts.Load())
+	}
+}
@@ -0,0 +1,173 @@
+// Package npy reads the NumPy arrays of .npy and .npz files that the demos
+// use as test data.
+//
+// Only C-ordered arrays are supported. The data is kept raw and decoded by
+// the typed accessors, which check the dtype.
+package npy
+
+import (
+	"archive/zip"
+	"bytes"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
+	"math"
+	"regexp"
+	"strconv"
+	"strings"
+)
+
+// Array is a decoded .npy array.
+type Array struct {
+	// Descr is the NumPy dtype string, e.g. "<f4".
+	Descr string
+	Shape []int
+	// Data holds the elements in row-major order.
+	Data []byte
+}
+
+var (
+	magic   = []byte("\x93NUMPY")
+	descrRe = regexp.MustCompile(`'descr':\s*'([^']*)'`)
+	orderRe = regexp.MustCompile(`'fortran_order':\s*(True|False)`)
+	shapeRe = regexp.MustCompile(`'shape':\s*\(([^)]*)\)`)
+)
+
+// Read reads a .npy stream.
+func Read(r io.Reader) (*Array, error) {
+	var prefix [8]byte
+	if _, err := io.ReadFull(r, prefix[:]); err != nil {
+		return nil, err
+	}
+	if !bytes.Equal(prefix[:6], magic) {
+		return nil, errors.New("invalid NPY magic")
+	}
+	// Version 1 has a 2-byte header length, later versions a 4-byte one.
+	var headerLen int
+	if prefix[6] == 1 {
+		var n uint16
+		if err := binary.Read(r, binary.LittleEndian, &n); err != nil {
+			return nil, err
+		}
+		headerLen = int(n)
+	} else {
+		var n uint32
+		if err := binary.Read(r, binary.LittleEndian, &n); err != nil {
+			return nil, err
+		}
+		headerLen = int(n)
+	}
+	header := make([]byte, headerLen)
+	if _, err := io.ReadFull(r, header); err != nil {
+		return nil, err
+	}
+
+	descr := descrRe.FindSubmatch(header)
+	order := orderRe.FindSubmatch(header)
+	dims := shapeRe.FindSubmatch(header)
+	if descr == nil || order == nil || dims == nil {
+		return nil, fmt.Errorf("malformed NPY header %q", header)
+	}
+	if string(order[1]) != "False" {
+		return nil, errors.New("Fortran order is not supported")
+	}
+	a := &Array{Descr: string(descr[1])}
+	for _, part := range strings.Split(string(dims[1]), ",") {
+		if part = strings.TrimSpace(part); part == "" {
+			continue
+		}
+		dim, err := strconv.Atoi(part)
+		if err != nil {
+			return nil, fmt.Errorf("malformed shape dimension %q: %w", part, err)
+		}
+		a.Shape = append(a.Shape, dim)
+	}
+	var err error
+	if a.Data, err = io.ReadAll(r); err != nil {
+		return nil, err
+	}
+	return a, nil
+}
+
+// ReadNPZ reads every array of an NPZ file, keyed by its name without the
+// .npy suffix.
+func ReadNPZ(path string) (map[string]*Array, error) {
+	r, err := zip.OpenReader(path)
+	if err != nil {
+		return nil, err
+	}
+	defer r.Close()
+
+	arrays := make(map[string]*Array, len(r.File))
+	for _, f := range r.File {
+		rc, err := f.Open()
+		if err != nil {
+			return nil, err
+		}
+		a, err := Read(rc)
+		rc.Close()
+		if err != nil {
+			return nil, fmt.Errorf("%s: %s: %w", path, f.Name, err)
+		}
+		arrays[strings.TrimSuffix(f.Name, ".npy")] = a
+	}
+	return arrays, nil
+}
+
+// Len returns the number of elements of a.
+func (a *Array) Len() int {
+	n := 1
+	for _, dim := range a.Shape {
+		n *= dim
+	}
+	return n
+}
+
+// check verifies that a holds Len elements of the dtype descr, each size
+// bytes long.
+func (a *Array) check(descr string, size int) error {
+	if a.Descr != descr {
+		return fmt.Errorf("dtype %s, want %s", a.Descr, descr)
+	}
+	if len(a.Data) != size*a.Len() {
+		return fmt.Errorf("%d bytes of data for shape %v", len(a.Data), a.Shape)
+	}
+	return nil
+}
+
+// Float32s decodes a little-endian float32 array.
+func (a *Array) Float32s() ([]float32, error) {
+	if err := a.check("<f4", 4); err != nil {
+		return nil, err
+	}
+	out := make([]float32, a.Len())
+	for i := range out {
+		out[i] = math.Float32frombits(binary.LittleEndian.Uint32(a.Data[4*i:]))
+	}
+	return out, nil
+}
+
+// Int32s decodes a little-endian int32 array.
+func (a *Array) Int32s() ([]int32, error) {
+	if err := a.check("<i4", 4); err != nil {
+		return nil, err
+	}
+	out := make([]int32, a.Len())
+	for i := range out {
+		out[i] = int32(binary.LittleEndian.Uint32(a.Data[4*i:]))
+	}
+	return out, nil
+}
+
+// Int64s decodes a little-endian int64 array.
+func (a *Array) Int64s() ([]int64, error) {
+	if err := a.check("<i8", 8); err != nil {
+		return nil, err
+	}
+	out := make([]int64, a.Len())
+	for i := range out {
+		out[i] = int64(binary.LittleEndian.Uint64(a.Data[8*i:]))
+	}
+	return out, nil
+}
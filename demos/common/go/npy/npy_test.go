@@ -0,0 +1,126 @@
+package npy
+
+import (
+	"archive/zip"
+	"bytes"
+	"encoding/binary"
+	"math"
+	"os"
+	"path/filepath"
+	"reflect"
+	"strings"
+	"testing"
+)
+
+// encode returns a .npy file of the given format version holding data.
+func encode(version byte, header string, data []byte) []byte {
+	b := append([]byte(nil), magic...)
+	b = append(b, version, 0)
+	if version == 1 {
+		b = binary.LittleEndian.AppendUint16(b, uint16(len(header)))
+	} else {
+		b = binary.LittleEndian.AppendUint32(b, uint32(len(header)))
+	}
+	b = append(b, header...)
+	return append(b, data...)
+}
+
+func float32Data(values ...float32) []byte {
+	var b []byte
+	for _, v := range values {
+		b = binary.LittleEndian.AppendUint32(b, math.Float32bits(v))
+	}
+	return b
+}
+
+func TestReadFloat32Matrix(t *testing.T) {
+	file := encode(1, "{'descr': '<f4', 'fortran_order': False, 'shape': (2, 3), }\n",
+		float32Data(1, 2, 3, 4, 5, 6))
+	a, err := Read(bytes.NewReader(file))
+	if err != nil {
+		t.Fatal(err)
+	}
+	if a.Descr != "<f4" || !reflect.DeepEqual(a.Shape, []int{2, 3}) || a.Len() != 6 {
+		t.Errorf("Read() = %s %v with %d elements, want <f4 [2 3] with 6", a.Descr, a.Shape, a.Len())
+	}
+	got, err := a.Float32s()
+	if err != nil || !reflect.DeepEqual(got, []float32{1, 2, 3, 4, 5, 6}) {
+		t.Errorf("Float32s() = %v, %v, want [1 2 3 4 5 6]", got, err)
+	}
+	if _, err := a.Int32s(); err == nil {
+		t.Error("Int32s() of a float32 array succeeded")
+	}
+}
+
+func TestReadVersion2Vector(t *testing.T) {
+	data := binary.LittleEndian.AppendUint64(nil, uint64(1<<40))
+	data = binary.LittleEndian.AppendUint64(data, math.MaxUint64)
+	a, err := Read(bytes.NewReader(encode(2, "{'descr': '<i8', 'fortran_order': False, 'shape': (2,), }\n", data)))
+	if err != nil {
+		t.Fatal(err)
+	}
+	if got, err := a.Int64s(); err != nil || !reflect.DeepEqual(got, []int64{1 << 40, -1}) {
+		t.Errorf("Int64s() = %v, %v, want [%d -1]", got, err, int64(1<<40))
+	}
+}
+
+func TestReadErrors(t *testing.T) {
+	for _, tc := range []struct {
+		name, want string
+		file       []byte
+	}{
+		{"magic", "magic", []byte("\x93NUMPX\x01\x00\x00\x00")},
+		{"fortran order", "Fortran", encode(1, "{'descr': '<f4', 'fortran_order': True, 'shape': (1,), }\n", float32Data(1))},
+		{"missing shape", "malformed", encode(1, "{'descr': '<f4', 'fortran_order': False, }\n", nil)},
+		{"bad dimension", "dimension", encode(1, "{'descr': '<f4', 'fortran_order': False, 'shape': (x,), }\n", nil)},
+	} {
+		if _, err := Read(bytes.NewReader(tc.file)); err == nil || !strings.Contains(err.Error(), tc.want) {
+			t.Errorf("%s: Read() = %v, want an error mentioning %q", tc.name, err, tc.want)
+		}
+	}
+
+	a, err := Read(bytes.NewReader(encode(1, "{'descr': '<i4', 'fortran_order': False, 'shape': (3,), }\n", make([]byte, 8))))
+	if err != nil {
+		t.Fatal(err)
+	}
+	if _, err := a.Int32s(); err == nil {
+		t.Error("Int32s() of a truncated array succeeded")
+	}
+}
+
+func TestReadNPZ(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "arrays.npz")
+	f, err := os.Create(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	w := zip.NewWriter(f)
+	for name, file := range map[string][]byte{
+		"x.npy": encode(1, "{'descr': '<f4', 'fortran_order': False, 'shape': (1,), }\n", float32Data(0.5)),
+		"y.npy": encode(1, "{'descr': '<i4', 'fortran_order': False, 'shape': (), }\n", []byte{7, 0, 0, 0}),
+	} {
+		fw, err := w.Create(name)
+		if err != nil {
+			t.Fatal(err)
+		}
+		fw.Write(file)
+	}
+	if err := w.Close(); err != nil {
+		t.Fatal(err)
+	}
+	f.Close()
+
+	arrays, err := ReadNPZ(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(arrays) != 2 || arrays["x"] == nil || arrays["y"] == nil {
+		t.Fatalf("ReadNPZ() = %v, want the arrays x and y", arrays)
+	}
+	if got, err := arrays["x"].Float32s(); err != nil || !reflect.DeepEqual(got, []float32{0.5}) {
+		t.Errorf("x = %v, %v, want [0.5]", got, err)
+	}
+	if got, err := arrays["y"].Int32s(); err != nil || !reflect.DeepEqual(got, []int32{7}) {
+		t.Errorf("y = %v, %v, want the scalar 7", got, err)
+	}
+}
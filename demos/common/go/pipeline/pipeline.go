@@ -0,0 +1,134 @@
+// Package pipeline runs encrypt, evaluate and decrypt as concurrent stages
+// connected by bounded queues.
+//
+// Compared to encrypting every sample, then evaluating every sample, then
+// decrypting every sample, a pipeline keeps at most a bounded number of
+// samples in flight (so peak memory depends on the queue depth, not on the
+// dataset size) and produces the first result after a single sample has gone
+// through all stages.
+package pipeline
+
+import (
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// Config controls the concurrency of each stage and the depth of the queues
+// between stages. Zero or negative values are treated as 1.
+type Config struct {
+	EncryptWorkers  int
+	EvaluateWorkers int
+	DecryptWorkers  int
+	QueueDepth      int
+}
+
+// Stages holds one factory per stage. Each factory is called once per worker
+// goroutine and returns the function that worker runs for every sample, so
+// per-worker state (e.g. a ShallowCopy of an evaluator, encryptor or
+// decryptor) can be captured in the returned closure.
+type Stages[E, O, R any] struct {
+	Encrypt  func() func(idx int) E
+	Evaluate func() func(idx int, in E) O
+	Decrypt  func() func(idx int, out O) R
+}
+
+// Stats summarizes a pipeline run.
+type Stats struct {
+	// FirstResult is the time from the start of the run to the first emitted result.
+	FirstResult time.Duration
+	// Total is the wall time of the whole run.
+	Total time.Duration
+	// MaxInFlight is the largest number of samples that were handed to the
+	// encrypt stage but whose result had not been emitted yet.
+	MaxInFlight int
+}
+
+type item[T any] struct {
+	idx int
+	val T
+}
+
+func atLeastOne(n int) int {
+	if n < 1 {
+		return 1
+	}
+	return n
+}
+
+// runStage starts n workers that apply the function built by newFn to every
+// item of in and forward the result to out. out is closed once all workers
+// are done.
+func runStage[T, U any](n int, in <-chan item[T], out chan<- item[U], newFn func() func(int, T) U) {
+	var wg sync.WaitGroup
+	wg.Add(n)
+	for w := 0; w < n; w++ {
+		fn := newFn()
+		go func() {
+			defer wg.Done()
+			for it := range in {
+				out <- item[U]{it.idx, fn(it.idx, it.val)}
+			}
+		}()
+	}
+	go func() {
+		wg.Wait()
+		close(out)
+	}()
+}
+
+// Run feeds the sample indices 0..n-1 through the stages and calls emit for
+// every result, in completion order, on the calling goroutine.
+func Run[E, O, R any](n int, cfg Config, stages Stages[E, O, R], emit func(idx int, res R)) Stats {
+	depth := atLeastOne(cfg.QueueDepth)
+	indices := make(chan item[struct{}])
+	encrypted := make(chan item[E], depth)
+	evaluated := make(chan item[O], depth)
+	results := make(chan item[R], depth)
+
+	var inFlight, maxInFlight atomic.Int64
+	start := time.Now()
+
+	go func() {
+		defer close(indices)
+		for i := 0; i < n; i++ {
+			cur := inFlight.Add(1)
+			for {
+				prev := maxInFlight.Load()
+				if cur <= prev || maxInFlight.CompareAndSwap(prev, cur) {
+					break
+				}
+			}
+			indices <- item[struct{}]{idx: i}
+		}
+	}()
+
+	runStage(atLeastOne(cfg.EncryptWorkers), indices, encrypted, func() func(int, struct{}) E {
+		fn := stages.Encrypt()
+		return func(idx int, _ struct{}) E { return fn(idx) }
+	})
+	runStage(atLeastOne(cfg.EvaluateWorkers), encrypted, evaluated, stages.Evaluate)
+	runStage(atLeastOne(cfg.DecryptWorkers), evaluated, results, stages.Decrypt)
+
+	var stats Stats
+	for it := range results {
+		if stats.FirstResult == 0 {
+			stats.FirstResult = time.Since(start)
+		}
+		emit(it.idx, it.val)
+		inFlight.Add(-1)
+	}
+	stats.Total = time.Since(start)
+	stats.MaxInFlight = int(maxInFlight.Load())
+	return stats
+}
+
+// Percentile returns the p-th percentile (0 to 100) of sorted latencies, the
+// nearest-rank value, or 0 if there are none.
+func Percentile(sorted []time.Duration, p float64) time.Duration {
+	if len(sorted) == 0 {
+		return 0
+	}
+	idx := int(p/100.0*float64(len(sorted)-1) + 0.5)
+	return sorted[idx]
+}
@@ -0,0 +1,88 @@
+package pipeline
+
+import (
+	"sync/atomic"
+	"testing"
+	"time"
+)
+
+func TestRunEmitsEveryResult(t *testing.T) {
+	const n = 100
+	stages := Stages[int, int, int]{
+		Encrypt: func() func(int) int {
+			return func(idx int) int { return idx }
+		},
+		Evaluate: func() func(int, int) int {
+			return func(_ int, in int) int { return in * 2 }
+		},
+		Decrypt: func() func(int, int) int {
+			return func(_ int, out int) int { return out + 1 }
+		},
+	}
+	seen := make([]bool, n)
+	stats := Run(n, Config{EncryptWorkers: 2, EvaluateWorkers: 4, DecryptWorkers: 2, QueueDepth: 3}, stages,
+		func(idx int, res int) {
+			if res != 2*idx+1 {
+				t.Errorf("result for sample %d = %d, want %d", idx, res, 2*idx+1)
+			}
+			if seen[idx] {
+				t.Errorf("sample %d emitted twice", idx)
+			}
+			seen[idx] = true
+		})
+	for i, ok := range seen {
+		if !ok {
+			t.Errorf("sample %d was never emitted", i)
+		}
+	}
+	if stats.FirstResult <= 0 || stats.FirstResult > stats.Total {
+		t.Errorf("unexpected FirstResult %v for Total %v", stats.FirstResult, stats.Total)
+	}
+}
+
+func TestRunBoundsSamplesInFlight(t *testing.T) {
+	const n = 50
+	cfg := Config{EncryptWorkers: 1, EvaluateWorkers: 2, DecryptWorkers: 1, QueueDepth: 2}
+	var perWorker atomic.Int32
+	stages := Stages[int, int, int]{
+		Encrypt: func() func(int) int {
+			return func(idx int) int { return idx }
+		},
+		Evaluate: func() func(int, int) int {
+			perWorker.Add(1)
+			return func(_ int, in int) int {
+				time.Sleep(time.Millisecond)
+				return in
+			}
+		},
+		Decrypt: func() func(int, int) int {
+			return func(_ int, out int) int { return out }
+		},
+	}
+	stats := Run(n, cfg, stages, func(int, int) {})
+
+	if got := perWorker.Load(); got != int32(cfg.EvaluateWorkers) {
+		t.Errorf("Evaluate factory called %d times, want %d", got, cfg.EvaluateWorkers)
+	}
+	// Every worker holds one sample, every queue holds QueueDepth samples, and
+	// the feeder holds one more while it waits for the encrypt stage.
+	limit := cfg.EncryptWorkers + cfg.EvaluateWorkers + cfg.DecryptWorkers + 3*cfg.QueueDepth + 2
+	if stats.MaxInFlight > limit {
+		t.Errorf("MaxInFlight = %d, want at most %d", stats.MaxInFlight, limit)
+	}
+}
+
+func TestPercentile(t *testing.T) {
+	sorted := []time.Duration{1, 2, 3, 4, 5}
+	for _, tc := range []struct {
+		p    float64
+		want time.Duration
+	}{{0, 1}, {50, 3}, {99, 5}, {100, 5}} {
+		if got := Percentile(sorted, tc.p); got != tc.want {
+			t.Errorf("Percentile(%v, %v) = %v, want %v", sorted, tc.p, got, tc.want)
+		}
+	}
+	if got := Percentile(nil, 50); got != 0 {
+		t.Errorf("Percentile(nil, 50) = %v, want 0", got)
+	}
+}
@@ -0,0 +1,133 @@
+// Package profiling adds pprof and execution trace flags to the demo binaries.
+//
+// Importing the package registers -cpuprofile, -memprofile, -mutexprofile,
+// -blockprofile and -trace on the default flag set. Binaries call Start right
+// before the evaluation and the returned stop function right after it, so the
+// profiles exclude data loading and key generation. The output files can be
+// read with `go tool pprof` and `go tool trace`.
+package profiling
+
+import (
+	"errors"
+	"flag"
+	"fmt"
+	"os"
+	"path/filepath"
+	"runtime"
+	"runtime/pprof"
+	"runtime/trace"
+)
+
+var (
+	cpuProfile   = flag.String("cpuprofile", "", "Write a CPU profile of the evaluation to this file")
+	memProfile   = flag.String("memprofile", "", "Write a heap profile of the evaluation to this file")
+	mutexProfile = flag.String("mutexprofile", "", "Write a mutex contention profile of the evaluation to this file")
+	blockProfile = flag.String("blockprofile", "", "Write a goroutine blocking profile of the evaluation to this file")
+	traceFile    = flag.String("trace", "", "Write an execution trace of the evaluation to this file")
+)
+
+// defaultMemProfileRate is the runtime default, restored by Start.
+var defaultMemProfileRate = runtime.MemProfileRate
+
+func init() {
+	// Allocation samples are cumulative from the first sample on, so sampling
+	// stays off until Start to keep loading and keygen out of -memprofile.
+	runtime.MemProfileRate = 0
+}
+
+// create opens a profile output file. Relative paths are resolved against the
+// directory bazel run was invoked from rather than the runfiles tree.
+func create(path string) (*os.File, error) {
+	if wd := os.Getenv("BUILD_WORKING_DIRECTORY"); wd != "" && !filepath.IsAbs(path) {
+		path = filepath.Join(wd, path)
+	}
+	return os.Create(path)
+}
+
+// Start starts the profiles requested on the command line and returns a
+// function that stops them and writes the remaining profiles. It must be
+// called after flag.Parse, at most once.
+func Start() (func() error, error) {
+	var stops []func() error
+	stop := func() error {
+		var errs []error
+		for i := len(stops) - 1; i >= 0; i-- {
+			errs = append(errs, stops[i]())
+		}
+		return errors.Join(errs...)
+	}
+	fail := func(err error) (func() error, error) {
+		stop()
+		return nil, err
+	}
+
+	// Profiles written from the runtime's records when the evaluation ends.
+	writeProfile := func(name, path string) {
+		stops = append(stops, func() error {
+			f, err := create(path)
+			if err != nil {
+				return fmt.Errorf("%s profile: %w", name, err)
+			}
+			defer f.Close()
+			if err := pprof.Lookup(name).WriteTo(f, 0); err != nil {
+				return fmt.Errorf("%s profile: %w", name, err)
+			}
+			return f.Close()
+		})
+	}
+
+	if *memProfile != "" {
+		runtime.MemProfileRate = defaultMemProfileRate
+		writeProfile("heap", *memProfile)
+		stops = append(stops, func() error {
+			// Flush the in-use statistics up to the end of the evaluation.
+			runtime.GC()
+			return nil
+		})
+	}
+	if *mutexProfile != "" {
+		runtime.SetMutexProfileFraction(1)
+		writeProfile("mutex", *mutexProfile)
+		stops = append(stops, func() error {
+			runtime.SetMutexProfileFraction(0)
+			return nil
+		})
+	}
+	if *blockProfile != "" {
+		runtime.SetBlockProfileRate(1)
+		writeProfile("block", *blockProfile)
+		stops = append(stops, func() error {
+			runtime.SetBlockProfileRate(0)
+			return nil
+		})
+	}
+	if *cpuProfile != "" {
+		f, err := create(*cpuProfile)
+		if err != nil {
+			return fail(fmt.Errorf("cpu profile: %w", err))
+		}
+		if err := pprof.StartCPUProfile(f); err != nil {
+			f.Close()
+			return fail(fmt.Errorf("cpu profile: %w", err))
+		}
+		stops = append(stops, func() error {
+			pprof.StopCPUProfile()
+			return f.Close()
+		})
+	}
+	if *traceFile != "" {
+		f, err := create(*traceFile)
+		if err != nil {
+			return fail(fmt.Errorf("trace: %w", err))
+		}
+		if err := trace.Start(f); err != nil {
+			f.Close()
+			return fail(fmt.Errorf("trace: %w", err))
+		}
+		stops = append(stops, func() error {
+			trace.Stop()
+			return f.Close()
+		})
+	}
+	return stop, nil
+}
@@ -0,0 +1,77 @@
+package profiling
+
+import (
+	"os"
+	"path/filepath"
+	"sync"
+	"testing"
+)
+
+func TestStartWritesRequestedProfiles(t *testing.T) {
+	dir := t.TempDir()
+	paths := map[*string]string{
+		cpuProfile:   filepath.Join(dir, "cpu.pprof"),
+		memProfile:   filepath.Join(dir, "mem.pprof"),
+		mutexProfile: filepath.Join(dir, "mutex.pprof"),
+		blockProfile: filepath.Join(dir, "block.pprof"),
+		traceFile:    filepath.Join(dir, "trace.out"),
+	}
+	for flag, path := range paths {
+		*flag = path
+	}
+	t.Cleanup(func() {
+		for flag := range paths {
+			*flag = ""
+		}
+	})
+
+	stop, err := Start()
+	if err != nil {
+		t.Fatalf("Start: %v", err)
+	}
+	var mu sync.Mutex
+	var wg sync.WaitGroup
+	sink := make([][]byte, 0, 64)
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for j := 0; j < 8; j++ {
+				mu.Lock()
+				sink = append(sink, make([]byte, 1<<16))
+				mu.Unlock()
+			}
+		}()
+	}
+	wg.Wait()
+	if err := stop(); err != nil {
+		t.Fatalf("stop: %v", err)
+	}
+
+	for _, path := range paths {
+		info, err := os.Stat(path)
+		if err != nil {
+			t.Errorf("%s: %v", path, err)
+		} else if info.Size() == 0 {
+			t.Errorf("%s is empty", path)
+		}
+	}
+}
+
+func TestStartWithoutFlagsIsNoop(t *testing.T) {
+	stop, err := Start()
+	if err != nil {
+		t.Fatalf("Start: %v", err)
+	}
+	if err := stop(); err != nil {
+		t.Fatalf("stop: %v", err)
+	}
+}
+
+func TestStartReportsUnwritablePath(t *testing.T) {
+	*cpuProfile = filepath.Join(t.TempDir(), "missing", "cpu.pprof")
+	t.Cleanup(func() { *cpuProfile = "" })
+	if _, err := Start(); err == nil {
+		t.Fatal("Start succeeded with an unwritable profile path")
+	}
+}
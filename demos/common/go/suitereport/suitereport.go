@@ -0,0 +1,48 @@
+// Package suitereport writes the backend-independent summary of an evaluation
+// suite run that //demos/common/python:compare_backends reads. The Python
+// OpenFHE suites write the same format with demos/common/python/suite_report.py.
+package suitereport
+
+import (
+	"encoding/json"
+	"os"
+)
+
+// Report summarizes one suite run. Each phase duration is the wall time of
+// that phase over all rows, whether the rows run one after another or on a
+// pool of workers.
+type Report struct {
+	Model   string `json:"model"`
+	Backend string `json:"backend"`
+	Rows    int    `json:"rows"`
+	Correct int    `json:"correct"`
+	// Setup covers context creation, key generation and configuration.
+	Setup         float64 `json:"setup_s"`
+	Preprocessing float64 `json:"preprocessing_s"`
+	Encrypt       float64 `json:"encrypt_s"`
+	Evaluate      float64 `json:"evaluate_s"`
+	Decrypt       float64 `json:"decrypt_s"`
+	// EvalLatency is the evaluation time of every row, in row order.
+	EvalLatency []float64 `json:"eval_latency_s"`
+	// EvalKeyBytes is the serialized size of the relinearization and Galois
+	// keys, or zero if unknown.
+	EvalKeyBytes int64 `json:"eval_key_bytes"`
+}
+
+// New returns a report for rows rows of model evaluated by backend.
+func New(model, backend string, rows int) *Report {
+	return &Report{Model: model, Backend: backend, Rows: rows, EvalLatency: make([]float64, rows)}
+}
+
+// Write writes the report to path as JSON. An empty path is a no-op, so
+// drivers can pass their -report flag unconditionally.
+func (r *Report) Write(path string) error {
+	if path == "" {
+		return nil
+	}
+	data, err := json.MarshalIndent(r, "", "  ")
+	if err != nil {
+		return err
+	}
+	return os.WriteFile(path, append(data, '\n'), 0o644)
+}
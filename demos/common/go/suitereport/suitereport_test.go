@@ -0,0 +1,49 @@
+package suitereport
+
+import (
+	"encoding/json"
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+)
+
+func TestWrite(t *testing.T) {
+	r := New("cc_fraud", "lattigo", 2)
+	r.Correct = 1
+	r.Evaluate = (1500 * time.Millisecond).Seconds()
+	r.EvalLatency[1] = 0.75
+	path := filepath.Join(t.TempDir(), "report.json")
+	if err := r.Write(path); err != nil {
+		t.Fatal(err)
+	}
+
+	data, err := os.ReadFile(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	var got map[string]any
+	if err := json.Unmarshal(data, &got); err != nil {
+		t.Fatal(err)
+	}
+	for key, want := range map[string]any{
+		"model":      "cc_fraud",
+		"backend":    "lattigo",
+		"rows":       2.0,
+		"correct":    1.0,
+		"evaluate_s": 1.5,
+	} {
+		if got[key] != want {
+			t.Errorf("%s = %v, want %v", key, got[key], want)
+		}
+	}
+	if lat := got["eval_latency_s"].([]any); len(lat) != 2 || lat[1] != 0.75 {
+		t.Errorf("eval_latency_s = %v, want [0 0.75]", lat)
+	}
+}
+
+func TestWriteEmptyPath(t *testing.T) {
+	if err := New("mnist", "lattigo", 0).Write(""); err != nil {
+		t.Fatal(err)
+	}
+}
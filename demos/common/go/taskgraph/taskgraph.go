@@ -0,0 +1,178 @@
+// Package taskgraph runs the steps of one FHE inference as a dependency
+// graph: steps whose inputs are ready run concurrently on a bounded number of
+// workers, each with its own state (e.g. ShallowCopies of the evaluator,
+// encoder and decryptor).
+//
+// Besides the wall time, a run reports the total work (the sum of the step
+// durations) and the span (the duration of the longest dependency chain). The
+// span bounds the latency no number of workers can beat; work / span is the
+// parallelism available in the graph.
+package taskgraph
+
+import (
+	"fmt"
+	"strings"
+	"sync"
+	"time"
+)
+
+type node[W any] struct {
+	name       string
+	fn         func(w W)
+	deps       []int
+	dependents []int
+}
+
+// Graph is a set of named steps and their dependencies. Steps can only depend
+// on steps added before them, so a Graph is acyclic by construction.
+type Graph[W any] struct {
+	nodes  []*node[W]
+	byName map[string]int
+}
+
+// New returns an empty graph whose steps take worker state of type W.
+func New[W any]() *Graph[W] {
+	return &Graph[W]{byName: make(map[string]int)}
+}
+
+// Add adds the step name, which runs fn once all of deps have finished. It
+// panics if name is already taken or a dependency has not been added yet.
+func (g *Graph[W]) Add(name string, fn func(w W), deps ...string) {
+	if _, ok := g.byName[name]; ok {
+		panic(fmt.Sprintf("taskgraph: duplicate step %q", name))
+	}
+	id := len(g.nodes)
+	n := &node[W]{name: name, fn: fn}
+	for _, dep := range deps {
+		depID, ok := g.byName[dep]
+		if !ok {
+			panic(fmt.Sprintf("taskgraph: step %q depends on unknown step %q", name, dep))
+		}
+		n.deps = append(n.deps, depID)
+		g.nodes[depID].dependents = append(g.nodes[depID].dependents, id)
+	}
+	g.nodes = append(g.nodes, n)
+	g.byName[name] = id
+}
+
+// StepStats is the timing of one step, relative to the start of the run.
+type StepStats struct {
+	Name     string
+	Start    time.Duration
+	Duration time.Duration
+}
+
+// Stats summarizes a graph run.
+type Stats struct {
+	// Workers is the number of workers that were started.
+	Workers int
+	// Wall is the time from the start of the run to the end of the last step.
+	Wall time.Duration
+	// Work is the sum of all step durations.
+	Work time.Duration
+	// Span is the summed duration of the steps on CriticalPath.
+	Span time.Duration
+	// CriticalPath is the dependency chain with the largest total duration.
+	CriticalPath []string
+	// Steps holds the timing of every step, in the order they were added.
+	Steps []StepStats
+}
+
+// Parallelism returns Work / Span, the speedup over running the steps one
+// after another that unlimited workers could reach.
+func (s Stats) Parallelism() float64 {
+	if s.Span <= 0 {
+		return 1
+	}
+	return float64(s.Work) / float64(s.Span)
+}
+
+func (s Stats) String() string {
+	return fmt.Sprintf("wall %v on %d workers, work %v, span %v (parallelism %.2f), critical path %s",
+		s.Wall, s.Workers, s.Work, s.Span, s.Parallelism(), strings.Join(s.CriticalPath, " -> "))
+}
+
+// Run executes every step once its dependencies have finished, on up to
+// workers goroutines, and returns once all steps are done. newWorker is called
+// once per goroutine, on that goroutine, to build the state passed to the
+// steps it runs.
+func (g *Graph[W]) Run(workers int, newWorker func() W) Stats {
+	n := len(g.nodes)
+	if workers < 1 {
+		workers = 1
+	}
+	if workers > n {
+		workers = n
+	}
+	stats := Stats{Workers: workers, Steps: make([]StepStats, n)}
+	if n == 0 {
+		return stats
+	}
+
+	pending := make([]int, n)
+	ready := make(chan int, n)
+	for id, nd := range g.nodes {
+		pending[id] = len(nd.deps)
+		if pending[id] == 0 {
+			ready <- id
+		}
+	}
+
+	var mu sync.Mutex
+	finished := 0
+	var wg sync.WaitGroup
+	wg.Add(workers)
+	start := time.Now()
+	for w := 0; w < workers; w++ {
+		go func() {
+			defer wg.Done()
+			state := newWorker()
+			for id := range ready {
+				stepStart := time.Since(start)
+				g.nodes[id].fn(state)
+				stepEnd := time.Since(start)
+
+				mu.Lock()
+				stats.Steps[id] = StepStats{Name: g.nodes[id].name, Start: stepStart, Duration: stepEnd - stepStart}
+				for _, d := range g.nodes[id].dependents {
+					if pending[d]--; pending[d] == 0 {
+						ready <- d
+					}
+				}
+				if finished++; finished == n {
+					close(ready)
+				}
+				mu.Unlock()
+			}
+		}()
+	}
+	wg.Wait()
+	stats.Wall = time.Since(start)
+
+	// Steps are stored in topological order, so one forward pass finds the
+	// longest chain ending at every step.
+	chain := make([]time.Duration, n)
+	prev := make([]int, n)
+	last := 0
+	for id, nd := range g.nodes {
+		prev[id] = -1
+		for _, dep := range nd.deps {
+			if prev[id] < 0 || chain[dep] > chain[prev[id]] {
+				prev[id] = dep
+			}
+		}
+		if prev[id] >= 0 {
+			chain[id] = chain[prev[id]]
+		}
+		chain[id] += stats.Steps[id].Duration
+		stats.Work += stats.Steps[id].Duration
+		if chain[id] > chain[last] {
+			last = id
+		}
+	}
+	stats.Span = chain[last]
+	for id := last; id >= 0; id = prev[id] {
+		stats.CriticalPath = append([]string{g.nodes[id].name}, stats.CriticalPath...)
+	}
+	return stats
+}
@@ -0,0 +1,69 @@
+package taskgraph
+
+import (
+	"sync/atomic"
+	"testing"
+	"time"
+)
+
+func TestRunRespectsDependencies(t *testing.T) {
+	g := New[int]()
+	var order [4]atomic.Int64
+	var clock atomic.Int64
+	step := func(i int) func(int) {
+		return func(int) {
+			time.Sleep(time.Millisecond)
+			order[i].Store(clock.Add(1))
+		}
+	}
+	g.Add("a", step(0))
+	g.Add("b", step(1), "a")
+	g.Add("c", step(2), "a")
+	g.Add("d", step(3), "b", "c")
+	var workers atomic.Int32
+	stats := g.Run(4, func() int { return int(workers.Add(1)) })
+
+	if order[1].Load() < order[0].Load() || order[2].Load() < order[0].Load() {
+		t.Errorf("b or c ran before a: %v %v %v", order[0].Load(), order[1].Load(), order[2].Load())
+	}
+	if order[3].Load() < order[1].Load() || order[3].Load() < order[2].Load() {
+		t.Errorf("d ran before b and c")
+	}
+	if got := workers.Load(); got != 4 || stats.Workers != 4 {
+		t.Errorf("started %d workers (stats %d), want 4", got, stats.Workers)
+	}
+	if len(stats.Steps) != 4 || stats.Steps[3].Name != "d" {
+		t.Errorf("unexpected steps %+v", stats.Steps)
+	}
+}
+
+func TestRunReportsSpan(t *testing.T) {
+	g := New[struct{}]()
+	sleep := func(d time.Duration) func(struct{}) {
+		return func(struct{}) { time.Sleep(d) }
+	}
+	g.Add("short", sleep(5*time.Millisecond))
+	g.Add("long", sleep(30*time.Millisecond))
+	g.Add("join", sleep(5*time.Millisecond), "short", "long")
+	stats := g.Run(2, func() struct{} { return struct{}{} })
+
+	if want := []string{"long", "join"}; len(stats.CriticalPath) != 2 ||
+		stats.CriticalPath[0] != want[0] || stats.CriticalPath[1] != want[1] {
+		t.Errorf("CriticalPath = %v, want %v", stats.CriticalPath, want)
+	}
+	if stats.Span >= stats.Work {
+		t.Errorf("Span %v should be below Work %v", stats.Span, stats.Work)
+	}
+	if stats.Parallelism() <= 1 {
+		t.Errorf("Parallelism() = %v, want > 1", stats.Parallelism())
+	}
+}
+
+func TestAddPanicsOnUnknownDependency(t *testing.T) {
+	defer func() {
+		if recover() == nil {
+			t.Error("Add with an unknown dependency did not panic")
+		}
+	}()
+	New[int]().Add("a", func(int) {}, "missing")
+}
@@ -0,0 +1,72 @@
+package workerpool
+
+import (
+	"fmt"
+	"runtime"
+	"syscall"
+	"time"
+)
+
+// MemSnapshot records the allocation and GC counters of the process at one
+// point in time.
+type MemSnapshot struct {
+	at time.Time
+	ms runtime.MemStats
+}
+
+// TakeMemSnapshot reads the current allocation and GC counters. It briefly
+// stops the world, so call it between phases rather than per operation.
+func TakeMemSnapshot() MemSnapshot {
+	s := MemSnapshot{at: time.Now()}
+	runtime.ReadMemStats(&s.ms)
+	return s
+}
+
+// MemDelta is the allocation and GC activity between two snapshots.
+type MemDelta struct {
+	Elapsed    time.Duration
+	Bytes      uint64
+	Objects    uint64
+	NumGC      uint32
+	PauseTotal time.Duration
+}
+
+// Since returns the activity from s to now.
+func (s MemSnapshot) Since() MemDelta {
+	now := TakeMemSnapshot()
+	return MemDelta{
+		Elapsed:    now.at.Sub(s.at),
+		Bytes:      now.ms.TotalAlloc - s.ms.TotalAlloc,
+		Objects:    now.ms.Mallocs - s.ms.Mallocs,
+		NumGC:      now.ms.NumGC - s.ms.NumGC,
+		PauseTotal: time.Duration(now.ms.PauseTotalNs - s.ms.PauseTotalNs),
+	}
+}
+
+// AllocRate returns the allocated bytes per second.
+func (d MemDelta) AllocRate() float64 {
+	if d.Elapsed <= 0 {
+		return 0
+	}
+	return float64(d.Bytes) / d.Elapsed.Seconds()
+}
+
+func (d MemDelta) String() string {
+	return fmt.Sprintf("allocated %s (%s/s, %d objects), %d GCs, %v total GC pause",
+		FormatBytes(int64(d.Bytes)), FormatBytes(int64(d.AllocRate())), d.Objects, d.NumGC, d.PauseTotal)
+}
+
+// PeakRSS returns the largest resident set size of the process so far, which
+// unlike the Go heap statistics includes memory-mapped key pages and memory
+// not yet returned to the OS. It returns 0 if the OS does not report it.
+func PeakRSS() int64 {
+	var ru syscall.Rusage
+	if err := syscall.Getrusage(syscall.RUSAGE_SELF, &ru); err != nil {
+		return 0
+	}
+	// Maxrss is in bytes on Darwin and in KiB elsewhere.
+	if runtime.GOOS == "darwin" {
+		return int64(ru.Maxrss)
+	}
+	return int64(ru.Maxrss) << 10
+}
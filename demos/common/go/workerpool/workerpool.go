@@ -0,0 +1,259 @@
+// Package workerpool runs per-sample FHE evaluations on a bounded number of
+// goroutines, optionally admitting samples against a memory budget.
+//
+// Every worker owns its own state (e.g. ShallowCopies of the evaluators), so
+// the number of evaluator copies and in-flight ciphertext sets is bounded by
+// the pool size instead of by the number of samples.
+package workerpool
+
+import (
+	"fmt"
+	"runtime"
+	"runtime/metrics"
+	"strconv"
+	"strings"
+	"sync"
+	"time"
+)
+
+// Config controls the size of a pool.
+type Config struct {
+	// Workers is the maximum number of concurrently running tasks. Zero or
+	// negative values are treated as 1.
+	Workers int
+	// MemoryBudget is the number of bytes running tasks may use in total, on
+	// top of what is already in use when the pool starts. Zero means unlimited.
+	MemoryBudget int64
+	// TaskFootprint is the number of bytes a single task keeps alive while it
+	// runs, as returned by MeasureFootprint. Ignored without a MemoryBudget.
+	TaskFootprint int64
+	// Pending is the part of MemoryBudget taken when the pool starts by data
+	// the tasks free as they run, such as inputs encrypted ahead of the
+	// evaluation. Every task returns an equal share of it when it finishes,
+	// so tasks are admitted as the pending data drains.
+	Pending int64
+}
+
+// EffectiveWorkers returns the number of workers that are actually started:
+// Workers, reduced so that that many tasks fit in the memory budget. At least
+// one worker is always started, even if a single task exceeds the budget.
+func (c Config) EffectiveWorkers() int {
+	n := c.Workers
+	if c.MemoryBudget > 0 && c.TaskFootprint > 0 {
+		if fit := c.MemoryBudget / c.TaskFootprint; fit < int64(n) {
+			n = int(fit)
+		}
+	}
+	if n < 1 {
+		return 1
+	}
+	return n
+}
+
+// Stats summarizes a pool run.
+type Stats struct {
+	// Workers is the number of workers that were started.
+	Workers int
+	// Total is the wall time of the whole run.
+	Total time.Duration
+	// AdmissionWait is the summed time workers spent waiting for memory to
+	// become available before starting a task.
+	AdmissionWait time.Duration
+	// PeakReserved is the largest number of bytes reserved by running tasks
+	// and pending data.
+	PeakReserved int64
+}
+
+// budget is a weighted semaphore over the memory budget.
+type budget struct {
+	mu       sync.Mutex
+	cond     *sync.Cond
+	limit    int64
+	reserved int64
+	running  int
+	peak     int64
+}
+
+// acquire blocks until n bytes fit in the budget. A request is always granted
+// when no other task runs, so a task larger than the whole budget, or than
+// what the pending data leaves of it, still runs, alone.
+func (b *budget) acquire(n int64) time.Duration {
+	start := time.Now()
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	for b.running > 0 && b.reserved+n > b.limit {
+		b.cond.Wait()
+	}
+	b.reserved += n
+	b.running++
+	if b.reserved > b.peak {
+		b.peak = b.reserved
+	}
+	return time.Since(start)
+}
+
+// release returns the n bytes of a finished task and the freed bytes of
+// pending data.
+func (b *budget) release(n, freed int64) {
+	b.mu.Lock()
+	b.reserved -= n + freed
+	b.running--
+	b.mu.Unlock()
+	b.cond.Broadcast()
+}
+
+// Run calls fn for every index in [0, n) on cfg.EffectiveWorkers() goroutines
+// and returns once all calls have finished. newWorker is called once per
+// goroutine, on that goroutine, to build the state passed to its fn calls.
+// With a memory budget, each task reserves cfg.TaskFootprint bytes before it
+// starts and releases them, and its share of cfg.Pending, when it returns.
+func Run[W any](n int, cfg Config, newWorker func() W, fn func(w W, idx int)) Stats {
+	numWorkers := cfg.EffectiveWorkers()
+	if numWorkers > n && n > 0 {
+		numWorkers = n
+	}
+	var b *budget
+	var freed int64
+	if cfg.MemoryBudget > 0 && cfg.TaskFootprint > 0 {
+		b = &budget{limit: cfg.MemoryBudget, reserved: cfg.Pending, peak: cfg.Pending}
+		b.cond = sync.NewCond(&b.mu)
+		if n > 0 {
+			freed = cfg.Pending / int64(n)
+		}
+	}
+
+	indices := make(chan int)
+	var waitMu sync.Mutex
+	var wait time.Duration
+	var wg sync.WaitGroup
+	wg.Add(numWorkers)
+	start := time.Now()
+	for w := 0; w < numWorkers; w++ {
+		go func() {
+			defer wg.Done()
+			state := newWorker()
+			var localWait time.Duration
+			for idx := range indices {
+				if b != nil {
+					localWait += b.acquire(cfg.TaskFootprint)
+				}
+				fn(state, idx)
+				if b != nil {
+					b.release(cfg.TaskFootprint, freed)
+				}
+			}
+			waitMu.Lock()
+			wait += localWait
+			waitMu.Unlock()
+		}()
+	}
+	for i := 0; i < n; i++ {
+		indices <- i
+	}
+	close(indices)
+	wg.Wait()
+
+	stats := Stats{Workers: numWorkers, Total: time.Since(start), AdmissionWait: wait}
+	if b != nil {
+		stats.PeakReserved = b.peak
+	}
+	return stats
+}
+
+const heapObjectsMetric = "/memory/classes/heap/objects:bytes"
+
+func heapObjects(sample []metrics.Sample) int64 {
+	metrics.Read(sample)
+	return int64(sample[0].Value.Uint64())
+}
+
+// HeapInUse returns the number of live heap bytes right after a garbage
+// collection, i.e. what is already committed before any task runs.
+func HeapInUse() int64 {
+	runtime.GC()
+	sample := []metrics.Sample{{Name: heapObjectsMetric}}
+	return heapObjects(sample)
+}
+
+// MeasureFootprint runs fn and returns the peak heap growth observed while it
+// ran, relative to the live heap right before it started. The heap is sampled
+// every millisecond, so short-lived peaks between samples may be missed; the
+// result is meant for sizing a pool, not for exact accounting.
+func MeasureFootprint(fn func()) int64 {
+	sample := []metrics.Sample{{Name: heapObjectsMetric}}
+	runtime.GC()
+	base := heapObjects(sample)
+
+	done := make(chan struct{})
+	peakCh := make(chan int64)
+	go func() {
+		sample := []metrics.Sample{{Name: heapObjectsMetric}}
+		peak := base
+		ticker := time.NewTicker(time.Millisecond)
+		defer ticker.Stop()
+		for {
+			select {
+			case <-ticker.C:
+				if cur := heapObjects(sample); cur > peak {
+					peak = cur
+				}
+			case <-done:
+				if cur := heapObjects(sample); cur > peak {
+					peak = cur
+				}
+				peakCh <- peak
+				return
+			}
+		}
+	}()
+	fn()
+	close(done)
+	return <-peakCh - base
+}
+
+var byteUnits = []struct {
+	suffix string
+	scale  int64
+}{
+	{"KiB", 1 << 10}, {"MiB", 1 << 20}, {"GiB", 1 << 30}, {"TiB", 1 << 40},
+	{"KB", 1e3}, {"MB", 1e6}, {"GB", 1e9}, {"TB", 1e12},
+	{"K", 1 << 10}, {"M", 1 << 20}, {"G", 1 << 30}, {"T", 1 << 40},
+	{"B", 1},
+}
+
+// ParseBytes parses a size such as "96GiB", "512M" or "1073741824". Single
+// letter suffixes are binary (K = 1024). An empty string parses as 0.
+func ParseBytes(s string) (int64, error) {
+	orig := s
+	s = strings.TrimSpace(s)
+	if s == "" {
+		return 0, nil
+	}
+	scale := int64(1)
+	for _, u := range byteUnits {
+		if strings.HasSuffix(s, u.suffix) {
+			s = strings.TrimSpace(strings.TrimSuffix(s, u.suffix))
+			scale = u.scale
+			break
+		}
+	}
+	v, err := strconv.ParseFloat(s, 64)
+	if err != nil || v < 0 {
+		return 0, fmt.Errorf("invalid byte size %q", orig)
+	}
+	return int64(v * float64(scale)), nil
+}
+
+// FormatBytes formats n bytes with a binary unit, e.g. "1.50 GiB".
+func FormatBytes(n int64) string {
+	const unit = 1 << 10
+	if n < unit {
+		return fmt.Sprintf("%d B", n)
+	}
+	div, exp := int64(unit), 0
+	for m := n / unit; m >= unit && exp < 3; m /= unit {
+		div *= unit
+		exp++
+	}
+	return fmt.Sprintf("%.2f %ciB", float64(n)/float64(div), "KMGT"[exp])
+}
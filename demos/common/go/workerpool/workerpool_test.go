@@ -0,0 +1,105 @@
+package workerpool
+
+import (
+	"sync/atomic"
+	"testing"
+	"time"
+)
+
+func TestEffectiveWorkers(t *testing.T) {
+	for _, tc := range []struct {
+		cfg  Config
+		want int
+	}{
+		{Config{Workers: 8}, 8},
+		{Config{Workers: 0}, 1},
+		{Config{Workers: 8, MemoryBudget: 30, TaskFootprint: 10}, 3},
+		{Config{Workers: 2, MemoryBudget: 30, TaskFootprint: 10}, 2},
+		{Config{Workers: 8, MemoryBudget: 5, TaskFootprint: 10}, 1},
+	} {
+		if got := tc.cfg.EffectiveWorkers(); got != tc.want {
+			t.Errorf("%+v.EffectiveWorkers() = %d, want %d", tc.cfg, got, tc.want)
+		}
+	}
+}
+
+func TestRunBoundsConcurrency(t *testing.T) {
+	const n = 64
+	cfg := Config{Workers: 16, MemoryBudget: 40, TaskFootprint: 10}
+	var running, maxRunning, workers atomic.Int32
+	done := make([]bool, n)
+	stats := Run(n, cfg, func() int { return int(workers.Add(1)) }, func(_ int, idx int) {
+		cur := running.Add(1)
+		for {
+			prev := maxRunning.Load()
+			if cur <= prev || maxRunning.CompareAndSwap(prev, cur) {
+				break
+			}
+		}
+		time.Sleep(time.Millisecond)
+		done[idx] = true
+		running.Add(-1)
+	})
+
+	for i, ok := range done {
+		if !ok {
+			t.Errorf("task %d never ran", i)
+		}
+	}
+	if got := workers.Load(); got != 4 || stats.Workers != 4 {
+		t.Errorf("started %d workers (stats %d), want 4", got, stats.Workers)
+	}
+	if got := maxRunning.Load(); got > 4 {
+		t.Errorf("%d tasks ran concurrently, want at most 4", got)
+	}
+	if stats.PeakReserved > cfg.MemoryBudget {
+		t.Errorf("PeakReserved = %d, want at most %d", stats.PeakReserved, cfg.MemoryBudget)
+	}
+}
+
+func TestRunAdmitsAsPendingDataDrains(t *testing.T) {
+	const n = 8
+	// The pending inputs fill the budget, so the first tasks run alone; each
+	// finished task frees 5 bytes of them. Four workers never fit.
+	cfg := Config{Workers: 4, MemoryBudget: 40, TaskFootprint: 10, Pending: 40}
+	var running, maxRunning atomic.Int32
+	stats := Run(n, cfg, func() struct{} { return struct{}{} }, func(struct{}, int) {
+		cur := running.Add(1)
+		for {
+			prev := maxRunning.Load()
+			if cur <= prev || maxRunning.CompareAndSwap(prev, cur) {
+				break
+			}
+		}
+		time.Sleep(5 * time.Millisecond)
+		running.Add(-1)
+	})
+
+	if got := maxRunning.Load(); got > 3 {
+		t.Errorf("%d tasks ran concurrently, want at most 3", got)
+	}
+	if stats.AdmissionWait == 0 {
+		t.Error("AdmissionWait = 0, want tasks to wait for the pending data")
+	}
+}
+
+func TestParseBytes(t *testing.T) {
+	for _, tc := range []struct {
+		in   string
+		want int64
+	}{
+		{"", 0},
+		{"1024", 1024},
+		{"96GiB", 96 << 30},
+		{"512M", 512 << 20},
+		{"1.5 GB", 1500000000},
+	} {
+		got, err := ParseBytes(tc.in)
+		if err != nil || got != tc.want {
+			t.Errorf("ParseBytes(%q) = %d, %v, want %d", tc.in, got, err, tc.want)
+		}
+	}
+	if _, err := ParseBytes("lots"); err == nil {
+		t.Error("ParseBytes(\"lots\") succeeded, want error")
+	}
+}
@@ -0,0 +1,228 @@
+package debug
+
+import (
+	"fmt"
+	"math"
+	"sync/atomic"
+	"time"
+
+	"github.com/tuneinsight/lattigo/v6/circuits/ckks/bootstrapping"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
+)
+
+// BootstrapProfile is the cost of one bootstrap, split into its phases.
+type BootstrapProfile struct {
+	ModUp         time.Duration // ScaleDown and ModUp
+	CoeffsToSlots time.Duration
+	EvalMod       time.Duration
+	SlotsToCoeffs time.Duration
+	// Total is the duration of one bootstrap: the sum of the phases, or the
+	// duration of a full Bootstrap call when the phases are not available.
+	Total time.Duration
+	// KeyFetches is the number of evaluation keys one bootstrap fetches from
+	// the bootstrapping key set. It is fixed for given parameters, which is
+	// what lets HeirDebug count the bootstraps run between two debug points.
+	KeyFetches int64
+}
+
+// countingKeySet counts the keys fetched by the bootstrapping evaluator. The
+// generated code only uses that evaluator for Bootstrap calls, so every fetch
+// comes from a bootstrap.
+type countingKeySet struct {
+	rlwe.EvaluationKeySet
+	fetches atomic.Int64
+}
+
+func (s *countingKeySet) GetGaloisKey(galEl uint64) (*rlwe.GaloisKey, error) {
+	s.fetches.Add(1)
+	return s.EvaluationKeySet.GetGaloisKey(galEl)
+}
+
+func (s *countingKeySet) GetRelinearizationKey() (*rlwe.RelinearizationKey, error) {
+	s.fetches.Add(1)
+	return s.EvaluationKeySet.GetRelinearizationKey()
+}
+
+// Bootstrap accounting state, set by ProfileBootstrapping and updated by
+// HeirDebug. Like the timing state above, it is not thread-safe.
+var (
+	btpProfile     *BootstrapProfile
+	btpKeys        *countingKeySet
+	btpLastFetches int64
+	btpCount       int64
+	btpSections    []btpSection
+)
+
+type btpSection struct {
+	name       string
+	duration   time.Duration
+	bootstraps int64
+}
+
+// ProfileBootstrapping measures one bootstrap of a fresh level-0 encryption
+// phase by phase, and instruments btp so that HeirDebug reports how many
+// bootstraps ran in each section and their share of the section time. Call it
+// once after configuring the context and before running the evaluation.
+func ProfileBootstrapping(btp *bootstrapping.Evaluator, params ckks.Parameters, encryptor *rlwe.Encryptor) (BootstrapProfile, error) {
+	var p BootstrapProfile
+
+	// The DFT and EvalMod evaluators share btp.Evaluator, so swapping its key
+	// set in place instruments every phase.
+	keys := &countingKeySet{EvaluationKeySet: btp.Evaluator.GetEvaluationKeySet()}
+	*btp.Evaluator = *btp.Evaluator.WithKey(keys)
+
+	fresh := func() (*rlwe.Ciphertext, error) {
+		ct := ckks.NewCiphertext(params, 1, 0)
+		if err := encryptor.EncryptZero(ct); err != nil {
+			return nil, err
+		}
+		return ct, nil
+	}
+
+	// Warm up and count the key fetches of a full bootstrap.
+	ct, err := fresh()
+	if err != nil {
+		return p, err
+	}
+	before := keys.fetches.Load()
+	t0 := time.Now()
+	if _, err := btp.Bootstrap(ct); err != nil {
+		return p, fmt.Errorf("bootstrap: %w", err)
+	}
+	p.Total = time.Since(t0)
+	p.KeyFetches = keys.fetches.Load() - before
+	if p.KeyFetches == 0 {
+		return p, fmt.Errorf("bootstrap fetched no evaluation keys")
+	}
+
+	// The phases are only exposed for bootstrapping without ring switching;
+	// otherwise only the total is reported.
+	if btp.ResidualParameters.N() == btp.BootstrappingParameters.N() {
+		if ct, err = fresh(); err != nil {
+			return p, err
+		}
+		t0 = time.Now()
+		if ct, _, err = btp.ScaleDown(ct); err != nil {
+			return p, fmt.Errorf("ScaleDown: %w", err)
+		}
+		if ct, err = btp.ModUp(ct); err != nil {
+			return p, fmt.Errorf("ModUp: %w", err)
+		}
+		p.ModUp = time.Since(t0)
+
+		t0 = time.Now()
+		ctReal, ctImag, err := btp.CoeffsToSlots(ct)
+		if err != nil {
+			return p, fmt.Errorf("CoeffsToSlots: %w", err)
+		}
+		p.CoeffsToSlots = time.Since(t0)
+
+		t0 = time.Now()
+		if ctReal, err = btp.EvalMod(ctReal); err != nil {
+			return p, fmt.Errorf("EvalMod: %w", err)
+		}
+		if ctImag != nil {
+			if ctImag, err = btp.EvalMod(ctImag); err != nil {
+				return p, fmt.Errorf("EvalMod: %w", err)
+			}
+		}
+		p.EvalMod = time.Since(t0)
+
+		t0 = time.Now()
+		if _, err = btp.SlotsToCoeffs(ctReal, ctImag); err != nil {
+			return p, fmt.Errorf("SlotsToCoeffs: %w", err)
+		}
+		p.SlotsToCoeffs = time.Since(t0)
+		p.Total = p.ModUp + p.CoeffsToSlots + p.EvalMod + p.SlotsToCoeffs
+	}
+
+	btpProfile = &p
+	btpKeys = keys
+	resetBootstraps()
+	return p, nil
+}
+
+// String formats the profile as one line per phase.
+func (p BootstrapProfile) String() string {
+	s := fmt.Sprintf("Bootstrap: %v (%d key fetches)\n", p.Total, p.KeyFetches)
+	if p.CoeffsToSlots == 0 {
+		return s + "  Phase breakdown unavailable with ring switching\n"
+	}
+	phases := []struct {
+		name string
+		d    time.Duration
+	}{
+		{"ScaleDown+ModUp", p.ModUp},
+		{"CoeffsToSlots", p.CoeffsToSlots},
+		{"EvalMod", p.EvalMod},
+		{"SlotsToCoeffs", p.SlotsToCoeffs},
+	}
+	for _, ph := range phases {
+		s += fmt.Sprintf("  %-16s %12v (%5.1f%%)\n", ph.name, ph.d, 100*ph.d.Seconds()/p.Total.Seconds())
+	}
+	return s
+}
+
+// resetBootstraps starts a new evaluation.
+func resetBootstraps() {
+	if btpKeys == nil {
+		return
+	}
+	btpLastFetches = btpKeys.fetches.Load()
+	btpCount = 0
+	btpSections = nil
+}
+
+// recordBootstraps attributes the bootstraps run since the last debug point
+// to the section that just ended, and prints them if there were any.
+func recordBootstraps(opName string, section time.Duration) {
+	if btpKeys == nil {
+		return
+	}
+	fetches := btpKeys.fetches.Load()
+	n := int64(math.Round(float64(fetches-btpLastFetches) / float64(btpProfile.KeyFetches)))
+	btpLastFetches = fetches
+	btpCount += n
+	btpSections = append(btpSections, btpSection{name: opName, duration: section, bootstraps: n})
+	if n == 0 {
+		return
+	}
+	cost := time.Duration(n) * btpProfile.Total
+	fmt.Printf("[BOOTSTRAP] %-16s | Bootstraps: %3d | Est. time: %8.4f s | Share of section: %5.1f%%\n",
+		opName, n, cost.Seconds(), share(cost, section))
+}
+
+func share(part, whole time.Duration) float64 {
+	if whole <= 0 {
+		return 0
+	}
+	return math.Min(100, 100*part.Seconds()/whole.Seconds())
+}
+
+// PrintBootstrapSummary prints the bootstrap count and estimated time per
+// section, and the split of the total over the bootstrap phases. It is a
+// no-op unless ProfileBootstrapping was called.
+func PrintBootstrapSummary() {
+	if btpProfile == nil {
+		return
+	}
+	var total time.Duration
+	fmt.Println("[BOOTSTRAP] Summary")
+	fmt.Printf("  %-16s %10s %12s %12s %7s\n", "Section", "Bootstraps", "Section (s)", "Btp est (s)", "Share")
+	for _, s := range btpSections {
+		total += s.duration
+		cost := time.Duration(s.bootstraps) * btpProfile.Total
+		fmt.Printf("  %-16s %10d %12.4f %12.4f %6.1f%%\n",
+			s.name, s.bootstraps, s.duration.Seconds(), cost.Seconds(), share(cost, s.duration))
+	}
+	cost := time.Duration(btpCount) * btpProfile.Total
+	fmt.Printf("  %-16s %10d %12.4f %12.4f %6.1f%%\n",
+		"total", btpCount, total.Seconds(), cost.Seconds(), share(cost, total))
+	if btpProfile.CoeffsToSlots != 0 && btpCount > 0 {
+		n := time.Duration(btpCount)
+		fmt.Printf("  Of which: ScaleDown+ModUp %.4f s, CoeffsToSlots %.4f s, EvalMod %.4f s, SlotsToCoeffs %.4f s\n",
+			(n * btpProfile.ModUp).Seconds(), (n * btpProfile.CoeffsToSlots).Seconds(),
+			(n * btpProfile.EvalMod).Seconds(), (n * btpProfile.SlotsToCoeffs).Seconds())
+	}
+}
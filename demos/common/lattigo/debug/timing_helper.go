@@ -33,6 +33,7 @@ func HeirDebug(evaluator *ckks.Evaluator, param ckks.Parameters, encoder *ckks.E
 		startTime = now
 		lastTime = now
 		started = true
+		resetBootstraps()
 		fmt.Printf("[TIMING] Evaluation started at operator: %s\n", opName)
 		fmt.Printf("[DEBUG] Moduli Q: %v (count: %d)\n", param.Q(), len(param.Q()))
 	} else {
@@ -40,6 +41,7 @@ func HeirDebug(evaluator *ckks.Evaluator, param ckks.Parameters, encoder *ckks.E
 		totalDuration := now.Sub(startTime).Seconds()
 		fmt.Printf("[TIMING] After operator: %-16s | Section duration: %8.4f s | Total elapsed: %8.4f s\n",
 			opName, sectionDuration, totalDuration)
+		recordBootstraps(opName, now.Sub(lastTime))
 		lastTime = now
 	}
 
@@ -0,0 +1,64 @@
+package keystore
+
+import (
+	"errors"
+	"flag"
+	"fmt"
+
+	"fully_homomorphic_encryption/demos/common/go/workerpool"
+)
+
+// Flags holds the key store flags of a driver, see RegisterFlags.
+type Flags struct {
+	dir             *string
+	mapKeys         *bool
+	keyCache        *string
+	recordRotations *bool
+	pruneRotations  *string
+}
+
+// RegisterFlags registers -key_dir, -mmap_keys, -key_cache,
+// -record_rotations and -prune_rotations on the default flag set. Call it once, before flag.Parse.
+func RegisterFlags() *Flags {
+	return &Flags{
+		dir:             flag.String("key_dir", "", "Directory to load the parameters and keys from, or to save them to on the first run (empty means generate fresh keys)"),
+		mapKeys:         flag.Bool("mmap_keys", false, "Keep the Galois keys in memory-mapped files under -key_dir and decode them on demand instead of loading them all"),
+		keyCache:        flag.String("key_cache", "8GiB", "Heap budget for decoded Galois keys with -mmap_keys"),
+		recordRotations: flag.Bool("record_rotations", false, "Record the Galois elements the evaluation uses to rotations_used.txt under -key_dir"),
+		pruneRotations:  flag.String("prune_rotations", "", "Rotation record written by -record_rotations; a new -key_dir then gets only the recorded rotation keys"),
+	}
+}
+
+// Dir returns -key_dir, the directory to pass to Configure and
+// ConfigureBootstrapping.
+func (f *Flags) Dir() string {
+	return *f.dir
+}
+
+// Options checks the flags after flag.Parse and returns the options they
+// select.
+func (f *Flags) Options() ([]Option, error) {
+	var opts []Option
+	if *f.mapKeys {
+		if *f.dir == "" {
+			return nil, errors.New("-mmap_keys requires -key_dir")
+		}
+		keyCache, err := workerpool.ParseBytes(*f.keyCache)
+		if err != nil {
+			return nil, fmt.Errorf("invalid -key_cache: %w", err)
+		}
+		opts = append(opts, MapKeys(keyCache))
+	}
+	if *f.recordRotations || *f.pruneRotations != "" {
+		if *f.dir == "" {
+			return nil, errors.New("-record_rotations and -prune_rotations require -key_dir")
+		}
+		if *f.recordRotations {
+			opts = append(opts, RecordRotations())
+		}
+		if *f.pruneRotations != "" {
+			opts = append(opts, PruneRotations(*f.pruneRotations))
+		}
+	}
+	return opts, nil
+}
@@ -0,0 +1,784 @@
+// Package keystore persists the CKKS parameters and keys used by the
+// HEIR-generated Lattigo code, so that drivers can skip key generation on
+// every run but the first.
+//
+// The generated *__configure functions create a fresh key set internally and
+// return the evaluators built on it, but not the secret key. On the first run
+// the store calls configure once, takes the secret key from its decryptor and
+// the evaluation keys from its evaluators, writes them to the key directory
+// with Lattigo's binary marshalling, and rebuilds the evaluators from them.
+// Later runs read the directory and rebuild the evaluators without generating
+// any keys.
+//
+// The directory also holds a fingerprint of the model it was created for: the
+// name of the configure function, the parameters and the Galois elements of
+// the generated key set. Loading fails if the stored keys do not match it or
+// if the directory was created by another model. Configure cannot be asked
+// for its parameters without generating its keys, so recompiling a model with
+// other options under the same name still requires a new key directory.
+//
+// A model compiled for many slot positions may be configured with more
+// rotation keys than an inference ever uses. RecordRotations logs the Galois
+// elements the evaluator actually requests, and PruneRotations generates a
+// new key directory with only those, see the options.
+//
+// The key directory contains the secret key. Its files are created with mode
+// 0600, but the directory itself must be kept private.
+package keystore
+
+import (
+	"bufio"
+	"crypto/sha256"
+	"encoding"
+	"encoding/hex"
+	"errors"
+	"fmt"
+	"io"
+	"os"
+	"path/filepath"
+	"reflect"
+	"runtime"
+	"sort"
+	"strconv"
+	"strings"
+	"time"
+	"unsafe"
+
+	"github.com/tuneinsight/lattigo/v6/circuits/ckks/bootstrapping"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
+)
+
+const (
+	paramsFile    = "params.bin"
+	secretKeyFile = "sk.bin"
+	publicKeyFile = "pk.bin"
+	evalKeysFile  = "evk.bin"
+	btpParamsFile = "btp_params.bin"
+	btpKeysPrefix = "btp_evk_"
+	// prunedRotationsFile lists the Galois keys PruneRotations left out. Its
+	// presence makes the store generate missing keys on demand.
+	prunedRotationsFile = "rotations_pruned.txt"
+	fingerprintFile     = "fingerprint.txt"
+)
+
+// Keys holds everything needed to rebuild the objects returned by a
+// generated configure function.
+type Keys struct {
+	Params         ckks.Parameters
+	SecretKey      *rlwe.SecretKey
+	PublicKey      *rlwe.PublicKey
+	EvaluationKeys *rlwe.MemEvaluationKeySet
+
+	// BootstrappingParams and BootstrappingKeys are nil for models that do
+	// not bootstrap.
+	BootstrappingParams *bootstrapping.Parameters
+	BootstrappingKeys   *bootstrapping.EvaluationKeys
+
+	// Set by LoadMapped instead of EvaluationKeys and the Galois keys of
+	// BootstrappingKeys.
+	mappedKeys    *MappedKeySet
+	mappedBtpKeys *MappedKeySet
+
+	// recordPath and pruned configure the usageKeySet of NewEvaluators.
+	recordPath string
+	pruned     bool
+}
+
+// Option configures ConfigureBootstrapping and Configure.
+type Option func(*options)
+
+type options struct {
+	mapKeys    bool
+	cacheBytes int64
+	record     bool
+	prunePath  string
+}
+
+// MapKeys keeps the Galois keys, including the bootstrapping ones, in
+// memory-mapped files and holds at most cacheBytes of decoded keys on the
+// heap (see MappedKeySet). The run that creates the key directory still
+// generates all keys on the heap.
+func MapKeys(cacheBytes int64) Option {
+	return func(o *options) {
+		o.mapKeys = true
+		o.cacheBytes = cacheBytes
+	}
+}
+
+// RecordRotations writes the Galois elements the model evaluator requests to
+// rotations_used.txt in the key directory, one per line. Run the model on a
+// representative input set with it, then pass the file to PruneRotations.
+func RecordRotations() Option {
+	return func(o *options) {
+		o.record = true
+	}
+}
+
+// PruneRotations stores only the model Galois keys listed in path, a record
+// written by RecordRotations, when the key directory is created. The
+// generated configure function still generates every key on that run, but
+// later runs load only the recorded ones. The store generates a key missing
+// from the record on its first use, with a warning, so an incomplete record
+// costs time but not correctness. It has no effect on an existing key
+// directory.
+func PruneRotations(path string) Option {
+	return func(o *options) {
+		o.prunePath = path
+	}
+}
+
+// btpKeyFiles lists the individually stored bootstrapping evaluation keys.
+func btpKeyFiles(k *bootstrapping.EvaluationKeys) map[string]**rlwe.EvaluationKey {
+	return map[string]**rlwe.EvaluationKey{
+		"n1_to_n2":        &k.EvkN1ToN2,
+		"n2_to_n1":        &k.EvkN2ToN1,
+		"real_to_cmplx":   &k.EvkRealToCmplx,
+		"cmplx_to_real":   &k.EvkCmplxToReal,
+		"dense_to_sparse": &k.EvkDenseToSparse,
+		"sparse_to_dense": &k.EvkSparseToDense,
+	}
+}
+
+func writeFile(path string, obj io.WriterTo) error {
+	f, err := os.OpenFile(path, os.O_WRONLY|os.O_CREATE|os.O_TRUNC, 0o600)
+	if err != nil {
+		return err
+	}
+	w := bufio.NewWriterSize(f, 1<<20)
+	if _, err := obj.WriteTo(w); err != nil {
+		f.Close()
+		return fmt.Errorf("failed to write %s: %w", path, err)
+	}
+	if err := w.Flush(); err != nil {
+		f.Close()
+		return fmt.Errorf("failed to write %s: %w", path, err)
+	}
+	return f.Close()
+}
+
+func readFile(path string, obj io.ReaderFrom) error {
+	f, err := os.Open(path)
+	if err != nil {
+		return err
+	}
+	defer f.Close()
+	if _, err := obj.ReadFrom(bufio.NewReaderSize(f, 1<<20)); err != nil {
+		return fmt.Errorf("failed to read %s: %w", path, err)
+	}
+	return nil
+}
+
+func writeSmall(path string, obj encoding.BinaryMarshaler) error {
+	data, err := obj.MarshalBinary()
+	if err != nil {
+		return fmt.Errorf("failed to marshal %s: %w", path, err)
+	}
+	return os.WriteFile(path, data, 0o600)
+}
+
+func readSmall(path string, obj encoding.BinaryUnmarshaler) error {
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return err
+	}
+	if err := obj.UnmarshalBinary(data); err != nil {
+		return fmt.Errorf("failed to unmarshal %s: %w", path, err)
+	}
+	return nil
+}
+
+// Save writes keys to dir, creating it if needed. The parameters are written
+// last, so a directory with a parameters file always holds a complete set.
+func Save(dir string, keys *Keys) error {
+	if err := os.MkdirAll(dir, 0o700); err != nil {
+		return err
+	}
+	if err := writeFile(filepath.Join(dir, secretKeyFile), keys.SecretKey); err != nil {
+		return err
+	}
+	if err := writeFile(filepath.Join(dir, publicKeyFile), keys.PublicKey); err != nil {
+		return err
+	}
+	if err := writeFile(filepath.Join(dir, evalKeysFile), keys.EvaluationKeys); err != nil {
+		return err
+	}
+	if keys.BootstrappingParams != nil {
+		for name, evk := range btpKeyFiles(keys.BootstrappingKeys) {
+			if *evk == nil {
+				continue
+			}
+			if err := writeFile(filepath.Join(dir, btpKeysPrefix+name+".bin"), *evk); err != nil {
+				return err
+			}
+		}
+		if err := writeFile(filepath.Join(dir, btpKeysPrefix+"galois.bin"), keys.BootstrappingKeys.MemEvaluationKeySet); err != nil {
+			return err
+		}
+		if err := writeSmall(filepath.Join(dir, btpParamsFile), keys.BootstrappingParams); err != nil {
+			return err
+		}
+	}
+	return writeSmall(filepath.Join(dir, paramsFile), keys.Params)
+}
+
+// Exists reports whether dir holds a complete key set written by Save.
+func Exists(dir string) bool {
+	_, err := os.Stat(filepath.Join(dir, paramsFile))
+	return err == nil
+}
+
+// Load reads a key set written by Save.
+func Load(dir string) (*Keys, error) {
+	keys := &Keys{
+		SecretKey:      new(rlwe.SecretKey),
+		PublicKey:      new(rlwe.PublicKey),
+		EvaluationKeys: new(rlwe.MemEvaluationKeySet),
+	}
+	if err := readSmall(filepath.Join(dir, paramsFile), &keys.Params); err != nil {
+		return nil, err
+	}
+	if err := readFile(filepath.Join(dir, secretKeyFile), keys.SecretKey); err != nil {
+		return nil, err
+	}
+	if err := readFile(filepath.Join(dir, publicKeyFile), keys.PublicKey); err != nil {
+		return nil, err
+	}
+	if err := readFile(filepath.Join(dir, evalKeysFile), keys.EvaluationKeys); err != nil {
+		return nil, err
+	}
+
+	btpParams := new(bootstrapping.Parameters)
+	err := readSmall(filepath.Join(dir, btpParamsFile), btpParams)
+	if errors.Is(err, os.ErrNotExist) {
+		return keys, nil
+	}
+	if err != nil {
+		return nil, err
+	}
+	btpKeys, err := loadBtpSwitchingKeys(dir)
+	if err != nil {
+		return nil, err
+	}
+	btpKeys.MemEvaluationKeySet = new(rlwe.MemEvaluationKeySet)
+	if err := readFile(filepath.Join(dir, btpKeysPrefix+"galois.bin"), btpKeys.MemEvaluationKeySet); err != nil {
+		return nil, err
+	}
+	keys.BootstrappingParams = btpParams
+	keys.BootstrappingKeys = btpKeys
+	return keys, nil
+}
+
+// loadBtpSwitchingKeys reads the bootstrapping keys that are not Galois keys.
+func loadBtpSwitchingKeys(dir string) (*bootstrapping.EvaluationKeys, error) {
+	btpKeys := &bootstrapping.EvaluationKeys{}
+	for name, evk := range btpKeyFiles(btpKeys) {
+		key := new(rlwe.EvaluationKey)
+		err := readFile(filepath.Join(dir, btpKeysPrefix+name+".bin"), key)
+		if errors.Is(err, os.ErrNotExist) {
+			continue
+		}
+		if err != nil {
+			return nil, err
+		}
+		*evk = key
+	}
+	return btpKeys, nil
+}
+
+// ensureMapped converts a key set written by Save to the layout of
+// MappedKeySet, once. The conversion decodes the full set on the heap, so
+// loadOrCreate writes the layout directly when it creates a directory for
+// MapKeys; only directories created without MapKeys are converted.
+func ensureMapped(dir, src, base string) error {
+	if mappedExists(dir, base) {
+		return nil
+	}
+	fmt.Printf("  Converting %s for memory mapping (once)\n", src)
+	set := new(rlwe.MemEvaluationKeySet)
+	if err := readFile(filepath.Join(dir, src), set); err != nil {
+		return err
+	}
+	if err := writeMapped(dir, base, set); err != nil {
+		return err
+	}
+	set = nil
+	runtime.GC()
+	return nil
+}
+
+// writeMappedKeys writes the Galois keys of keys in the layout LoadMapped
+// reads, so that it does not have to decode them from the files of Save.
+func writeMappedKeys(dir string, keys *Keys) error {
+	if err := writeMapped(dir, "evk_mapped", keys.EvaluationKeys); err != nil {
+		return err
+	}
+	if keys.BootstrappingKeys == nil {
+		return nil
+	}
+	return writeMapped(dir, btpKeysPrefix+"mapped", keys.BootstrappingKeys.MemEvaluationKeySet)
+}
+
+// LoadMapped reads a key set written by Save but leaves the Galois keys in
+// memory-mapped files, see MappedKeySet. cacheBytes is shared between the
+// model and the bootstrapping keys.
+func LoadMapped(dir string, cacheBytes int64) (*Keys, error) {
+	keys := &Keys{
+		SecretKey: new(rlwe.SecretKey),
+		PublicKey: new(rlwe.PublicKey),
+	}
+	if err := readSmall(filepath.Join(dir, paramsFile), &keys.Params); err != nil {
+		return nil, err
+	}
+	if err := readFile(filepath.Join(dir, secretKeyFile), keys.SecretKey); err != nil {
+		return nil, err
+	}
+	if err := readFile(filepath.Join(dir, publicKeyFile), keys.PublicKey); err != nil {
+		return nil, err
+	}
+
+	btpParams := new(bootstrapping.Parameters)
+	err := readSmall(filepath.Join(dir, btpParamsFile), btpParams)
+	hasBtp := err == nil
+	if err != nil && !errors.Is(err, os.ErrNotExist) {
+		return nil, err
+	}
+	if hasBtp {
+		cacheBytes /= 2
+	}
+
+	if err := ensureMapped(dir, evalKeysFile, "evk_mapped"); err != nil {
+		return nil, err
+	}
+	if keys.mappedKeys, err = openMapped(dir, "evk_mapped", cacheBytes); err != nil {
+		return nil, err
+	}
+	if !hasBtp {
+		return keys, nil
+	}
+
+	if err := ensureMapped(dir, btpKeysPrefix+"galois.bin", btpKeysPrefix+"mapped"); err != nil {
+		return nil, err
+	}
+	if keys.mappedBtpKeys, err = openMapped(dir, btpKeysPrefix+"mapped", cacheBytes); err != nil {
+		return nil, err
+	}
+	btpKeys, err := loadBtpSwitchingKeys(dir)
+	if err != nil {
+		return nil, err
+	}
+	// The bootstrapping evaluator is built with the relinearization key only;
+	// NewEvaluators then points it at the mapped Galois keys.
+	btpKeys.MemEvaluationKeySet = rlwe.NewMemEvaluationKeySet(keys.mappedBtpKeys.relin)
+	keys.BootstrappingParams = btpParams
+	keys.BootstrappingKeys = btpKeys
+	return keys, nil
+}
+
+// NewEvaluators rebuilds the objects a generated configure function returns.
+// The bootstrapping evaluator is nil if keys has no bootstrapping keys.
+func (keys *Keys) NewEvaluators() (*bootstrapping.Evaluator, *ckks.Evaluator, ckks.Parameters, *ckks.Encoder, *rlwe.Encryptor, *rlwe.Decryptor, error) {
+	params := keys.Params
+	var btpEvaluator *bootstrapping.Evaluator
+	if keys.BootstrappingParams != nil {
+		var err error
+		btpEvaluator, err = bootstrapping.NewEvaluator(*keys.BootstrappingParams, keys.BootstrappingKeys)
+		if err != nil {
+			return nil, nil, params, nil, nil, nil, fmt.Errorf("failed to create bootstrapping evaluator: %w", err)
+		}
+		if keys.mappedBtpKeys != nil {
+			// Swap the key set of the CKKS evaluator in place: the DFT and Mod1
+			// evaluators hold the same *ckks.Evaluator, and ShallowCopy keeps
+			// its key set.
+			*btpEvaluator.Evaluator = *btpEvaluator.Evaluator.WithKey(keys.mappedBtpKeys)
+		}
+	}
+	var evk rlwe.EvaluationKeySet = keys.EvaluationKeys
+	if keys.mappedKeys != nil {
+		evk = keys.mappedKeys
+	}
+	if keys.recordPath != "" || keys.pruned {
+		evk = newUsageKeySet(evk, params, keys.SecretKey, keys.pruned, keys.recordPath)
+	}
+	return btpEvaluator,
+		ckks.NewEvaluator(params, evk),
+		params,
+		ckks.NewEncoder(params),
+		rlwe.NewEncryptor(params, keys.PublicKey),
+		rlwe.NewDecryptor(params, keys.SecretKey),
+		nil
+}
+
+// configured holds the objects returned by a generated configure function
+// that the store needs.
+type configured struct {
+	btpEvaluator *bootstrapping.Evaluator
+	evaluator    *ckks.Evaluator
+	params       ckks.Parameters
+	decryptor    *rlwe.Decryptor
+}
+
+// secretKey returns the secret key a decryptor holds. The generated configure
+// functions generate their secret key internally and return only the
+// decryptor built on it, and Lattigo keeps it unexported, so it is read by
+// reflection. TestSecretKeyOfDecryptor catches a Lattigo version that moves
+// the field.
+func secretKey(dec *rlwe.Decryptor) (*rlwe.SecretKey, error) {
+	field := reflect.ValueOf(dec).Elem().FieldByName("sk")
+	if !field.IsValid() || field.Type() != reflect.TypeOf((*rlwe.SecretKey)(nil)) {
+		return nil, errors.New("rlwe.Decryptor has no secret key field")
+	}
+	sk := reflect.NewAt(field.Type(), unsafe.Pointer(field.UnsafeAddr())).Elem().Interface().(*rlwe.SecretKey)
+	if sk == nil {
+		return nil, errors.New("the decryptor has no secret key")
+	}
+	return sk, nil
+}
+
+// adopt returns the key set configure generated, so that the first run does
+// not generate a second one. The public key is derived again from the secret
+// key, which is cheap compared to the evaluation keys.
+func adopt(c configured) (*Keys, error) {
+	sk, err := secretKey(c.decryptor)
+	if err != nil {
+		return nil, err
+	}
+	evk, ok := c.evaluator.GetEvaluationKeySet().(*rlwe.MemEvaluationKeySet)
+	if !ok {
+		return nil, fmt.Errorf("unsupported evaluation key set %T", c.evaluator.GetEvaluationKeySet())
+	}
+	keys := &Keys{
+		Params:         c.params,
+		SecretKey:      sk,
+		PublicKey:      rlwe.NewKeyGenerator(c.params).GenPublicKeyNew(sk),
+		EvaluationKeys: evk,
+	}
+	if c.btpEvaluator != nil {
+		if c.btpEvaluator.EvaluationKeys == nil {
+			return nil, errors.New("the bootstrapping evaluator has no keys")
+		}
+		p := c.btpEvaluator.Parameters
+		keys.BootstrappingParams = &p
+		keys.BootstrappingKeys = c.btpEvaluator.EvaluationKeys
+	}
+	return keys, nil
+}
+
+// fingerprint identifies the model a key set was created for, see the
+// package comment.
+type fingerprint struct {
+	model  string
+	params string
+	galEls []uint64
+}
+
+// newFingerprint fingerprints the full key set keys of the model whose
+// configure function is named model.
+func newFingerprint(model string, keys *Keys) (fingerprint, error) {
+	params, err := paramsDigest(keys)
+	if err != nil {
+		return fingerprint{}, err
+	}
+	galEls := keys.galoisKeysList()
+	sort.Slice(galEls, func(i, j int) bool { return galEls[i] < galEls[j] })
+	return fingerprint{model: model, params: params, galEls: galEls}, nil
+}
+
+// paramsDigest hashes the CKKS and bootstrapping parameters of keys.
+func paramsDigest(keys *Keys) (string, error) {
+	h := sha256.New()
+	data, err := keys.Params.MarshalBinary()
+	if err != nil {
+		return "", err
+	}
+	h.Write(data)
+	if keys.BootstrappingParams != nil {
+		if data, err = keys.BootstrappingParams.MarshalBinary(); err != nil {
+			return "", err
+		}
+		h.Write(data)
+	}
+	return hex.EncodeToString(h.Sum(nil)), nil
+}
+
+func (f fingerprint) write(path string) error {
+	var b strings.Builder
+	fmt.Fprintf(&b, "model %s\nparams %s\ngalois", f.model, f.params)
+	for _, galEl := range f.galEls {
+		b.WriteByte(' ')
+		b.WriteString(strconv.FormatUint(galEl, 10))
+	}
+	b.WriteByte('\n')
+	return os.WriteFile(path, []byte(b.String()), 0o600)
+}
+
+func readFingerprint(path string) (fingerprint, error) {
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return fingerprint{}, err
+	}
+	var f fingerprint
+	for _, line := range strings.Split(strings.TrimSpace(string(data)), "\n") {
+		key, value, _ := strings.Cut(line, " ")
+		switch key {
+		case "model":
+			f.model = value
+		case "params":
+			f.params = value
+		case "galois":
+			for _, field := range strings.Fields(value) {
+				galEl, err := strconv.ParseUint(field, 10, 64)
+				if err != nil {
+					return fingerprint{}, fmt.Errorf("corrupt fingerprint %s: %w", path, err)
+				}
+				f.galEls = append(f.galEls, galEl)
+			}
+		default:
+			return fingerprint{}, fmt.Errorf("corrupt fingerprint %s: unknown line %q", path, line)
+		}
+	}
+	return f, nil
+}
+
+// check verifies that keys, loaded from dir, belong to the model named model
+// and match the fingerprint stored with them. A pruned key set may lack some
+// of the Galois keys of the fingerprint, but no other.
+func (f fingerprint) check(dir, model string, keys *Keys) error {
+	if f.model != model {
+		return fmt.Errorf("the keys in %s were created for %s, not %s; use another key directory", dir, f.model, model)
+	}
+	params, err := paramsDigest(keys)
+	if err != nil {
+		return err
+	}
+	if params != f.params {
+		return fmt.Errorf("the parameters in %s do not match its fingerprint; delete the directory to create new keys", dir)
+	}
+	expected := make(map[uint64]bool, len(f.galEls))
+	for _, galEl := range f.galEls {
+		expected[galEl] = true
+	}
+	stored := keys.galoisKeysList()
+	for _, galEl := range stored {
+		if !expected[galEl] {
+			return fmt.Errorf("the Galois key %d in %s is not in its fingerprint; delete the directory to create new keys", galEl, dir)
+		}
+	}
+	if !keys.pruned && len(stored) != len(f.galEls) {
+		return fmt.Errorf("%s holds %d of the %d Galois keys of its fingerprint; delete the directory to create new keys", dir, len(stored), len(f.galEls))
+	}
+	return nil
+}
+
+// galoisKeysList returns the Galois elements of the model keys.
+func (keys *Keys) galoisKeysList() []uint64 {
+	if keys.mappedKeys != nil {
+		return keys.mappedKeys.GetGaloisKeysList()
+	}
+	return keys.EvaluationKeys.GetGaloisKeysList()
+}
+
+// modelName returns the name of a generated configure function, such as
+// fully_homomorphic_encryption/demos/mnist/lattigo/mnist.Mnist__configure.
+func modelName(configure any) string {
+	if f := runtime.FuncForPC(reflect.ValueOf(configure).Pointer()); f != nil {
+		return f.Name()
+	}
+	return "unknown"
+}
+
+// loadOrCreate loads the keys in dir, or saves the keys generated by a
+// generated configure function there. model names the function.
+func loadOrCreate(dir, model string, opts []Option, configure func() configured) (*Keys, error) {
+	var o options
+	for _, opt := range opts {
+		opt(&o)
+	}
+	load := func() (*Keys, error) {
+		var keys *Keys
+		var err error
+		if o.mapKeys {
+			fmt.Printf("  Mapping keys from %s\n", dir)
+			keys, err = LoadMapped(dir, o.cacheBytes)
+		} else {
+			fmt.Printf("  Loading keys from %s\n", dir)
+			keys, err = Load(dir)
+		}
+		if err != nil {
+			return nil, err
+		}
+		o.trackUsage(dir, keys)
+		f, err := readFingerprint(filepath.Join(dir, fingerprintFile))
+		if errors.Is(err, os.ErrNotExist) {
+			return nil, fmt.Errorf("%s has no fingerprint; delete the directory to create new keys", dir)
+		}
+		if err != nil {
+			return nil, err
+		}
+		if err := f.check(dir, model, keys); err != nil {
+			return nil, err
+		}
+		return keys, nil
+	}
+	if Exists(dir) {
+		return load()
+	}
+
+	fmt.Printf("  No keys in %s yet, generating them\n", dir)
+	keys, err := adopt(configure())
+	if err != nil {
+		return nil, fmt.Errorf("failed to take the keys generated by %s: %w", model, err)
+	}
+	fp, err := newFingerprint(model, keys)
+	if err != nil {
+		return nil, err
+	}
+
+	var pruned []uint64
+	if o.prunePath != "" {
+		used, err := readOrder(o.prunePath)
+		if err != nil {
+			return nil, fmt.Errorf("failed to read the rotation record: %w", err)
+		}
+		galEls := keys.EvaluationKeys.GetGaloisKeysList()
+		var kept []uint64
+		var unknown int
+		kept, pruned, unknown = pruneGaloisElements(galEls, used)
+		if unknown > 0 {
+			fmt.Printf("  Warning: %d recorded Galois elements are not used by this model; was %s recorded with other parameters?\n", unknown, o.prunePath)
+		}
+		fmt.Printf("  Keeping the %d of %d rotation keys recorded in %s\n", len(kept), len(galEls), o.prunePath)
+		reportPruning(keys.Params, keys.SecretKey, keys.EvaluationKeys, len(kept), len(pruned))
+		if keys.EvaluationKeys, err = selectGaloisKeys(keys.EvaluationKeys, kept); err != nil {
+			return nil, err
+		}
+		runtime.GC()
+	}
+
+	if err := os.MkdirAll(dir, 0o700); err != nil {
+		return nil, err
+	}
+	// Written before Save, so a complete directory always has them.
+	if err := fp.write(filepath.Join(dir, fingerprintFile)); err != nil {
+		return nil, err
+	}
+	if o.prunePath != "" {
+		if err := writeRotations(filepath.Join(dir, prunedRotationsFile), pruned); err != nil {
+			return nil, err
+		}
+	}
+	if o.mapKeys {
+		if err := writeMappedKeys(dir, keys); err != nil {
+			return nil, fmt.Errorf("failed to save keys to %s: %w", dir, err)
+		}
+	}
+	if err := Save(dir, keys); err != nil {
+		return nil, fmt.Errorf("failed to save keys to %s: %w", dir, err)
+	}
+	if o.mapKeys {
+		keys = nil
+		runtime.GC()
+		return load()
+	}
+	o.trackUsage(dir, keys)
+	return keys, nil
+}
+
+// trackUsage sets up the usageKeySet of keys stored in dir.
+func (o *options) trackUsage(dir string, keys *Keys) {
+	if _, err := os.Stat(filepath.Join(dir, prunedRotationsFile)); err == nil {
+		keys.pruned = true
+	}
+	if o.record {
+		keys.recordPath = filepath.Join(dir, usedRotationsFile)
+		fmt.Printf("  Recording the rotations used to %s\n", keys.recordPath)
+	}
+}
+
+// selectGaloisKeys returns a key set with the relinearization key of evk, if
+// any, and its Galois keys for galEls.
+func selectGaloisKeys(evk *rlwe.MemEvaluationKeySet, galEls []uint64) (*rlwe.MemEvaluationKeySet, error) {
+	rlk, err := evk.GetRelinearizationKey()
+	if err != nil {
+		rlk = nil
+	}
+	galoisKeys := make([]*rlwe.GaloisKey, 0, len(galEls))
+	for _, galEl := range galEls {
+		gk, err := evk.GetGaloisKey(galEl)
+		if err != nil {
+			return nil, err
+		}
+		galoisKeys = append(galoisKeys, gk)
+	}
+	return rlwe.NewMemEvaluationKeySet(rlk, galoisKeys...), nil
+}
+
+// reportPruning prints the memory the kept and the skipped Galois keys of evk
+// take, and the time generating the skipped keys costs. All Galois keys of a
+// parameter set have the same size and cost, so one key is generated again
+// with sk and timed.
+func reportPruning(params ckks.Parameters, sk *rlwe.SecretKey, evk *rlwe.MemEvaluationKeySet, kept, skipped int) {
+	galEls := evk.GetGaloisKeysList()
+	if len(galEls) == 0 {
+		return
+	}
+	gk, err := evk.GetGaloisKey(galEls[0])
+	if err != nil {
+		return
+	}
+	keyBytes := float64(gk.BinarySize())
+	const gib = float64(1 << 30)
+	fmt.Printf("  Rotation keys: %d kept (%.2f GiB), %d skipped (saves %.2f GiB on every later run)\n",
+		kept, keyBytes*float64(kept)/gib, skipped, keyBytes*float64(skipped)/gib)
+	if skipped == 0 {
+		return
+	}
+	start := time.Now()
+	rlwe.NewKeyGenerator(params).GenGaloisKeyNew(galEls[0], sk)
+	perKey := time.Since(start)
+	fmt.Printf("  Generating the skipped keys takes about %v (%v per key), which a configure restricted to the record would save\n",
+		(perKey * time.Duration(skipped)).Round(time.Millisecond), perKey.Round(time.Millisecond))
+}
+
+// ConfigureBootstrapping wraps a generated configure function of a model that
+// bootstraps. With an empty dir it simply calls configure; otherwise it loads
+// the keys stored in dir, creating them on the first run.
+func ConfigureBootstrapping(
+	dir string,
+	configure func() (*bootstrapping.Evaluator, *ckks.Evaluator, ckks.Parameters, *ckks.Encoder, *rlwe.Encryptor, *rlwe.Decryptor),
+	opts ...Option,
+) (*bootstrapping.Evaluator, *ckks.Evaluator, ckks.Parameters, *ckks.Encoder, *rlwe.Encryptor, *rlwe.Decryptor, error) {
+	if dir == "" {
+		btpEvaluator, evaluator, params, encoder, encryptor, decryptor := configure()
+		return btpEvaluator, evaluator, params, encoder, encryptor, decryptor, nil
+	}
+	keys, err := loadOrCreate(dir, modelName(configure), opts, func() configured {
+		btpEvaluator, evaluator, params, _, _, decryptor := configure()
+		return configured{btpEvaluator, evaluator, params, decryptor}
+	})
+	if err != nil {
+		return nil, nil, ckks.Parameters{}, nil, nil, nil, err
+	}
+	return keys.NewEvaluators()
+}
+
+// Configure is ConfigureBootstrapping for models that do not bootstrap.
+func Configure(
+	dir string,
+	configure func() (*ckks.Evaluator, ckks.Parameters, *ckks.Encoder, *rlwe.Encryptor, *rlwe.Decryptor),
+	opts ...Option,
+) (*ckks.Evaluator, ckks.Parameters, *ckks.Encoder, *rlwe.Encryptor, *rlwe.Decryptor, error) {
+	if dir == "" {
+		evaluator, params, encoder, encryptor, decryptor := configure()
+		return evaluator, params, encoder, encryptor, decryptor, nil
+	}
+	keys, err := loadOrCreate(dir, modelName(configure), opts, func() configured {
+		evaluator, params, _, _, decryptor := configure()
+		return configured{nil, evaluator, params, decryptor}
+	})
+	if err != nil {
+		return nil, ckks.Parameters{}, nil, nil, nil, err
+	}
+	_, evaluator, params, encoder, encryptor, decryptor, err := keys.NewEvaluators()
+	return evaluator, params, encoder, encryptor, decryptor, err
+}
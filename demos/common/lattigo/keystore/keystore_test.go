@@ -0,0 +1,143 @@
+package keystore
+
+import (
+	"path/filepath"
+	"reflect"
+	"testing"
+
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
+)
+
+func TestPruneGaloisElements(t *testing.T) {
+	for _, tc := range []struct {
+		galEls, used, kept, pruned []uint64
+		unknown                    int
+	}{
+		{[]uint64{5, 25, 125}, []uint64{125, 5}, []uint64{5, 125}, []uint64{25}, 0},
+		{[]uint64{5, 25}, nil, nil, []uint64{5, 25}, 0},
+		{[]uint64{5, 25}, []uint64{25, 7, 9}, []uint64{25}, []uint64{5}, 2},
+		{[]uint64{5, 25}, []uint64{5, 5, 25}, []uint64{5, 25}, nil, 0},
+	} {
+		kept, pruned, unknown := pruneGaloisElements(tc.galEls, tc.used)
+		if !reflect.DeepEqual(kept, tc.kept) || !reflect.DeepEqual(pruned, tc.pruned) || unknown != tc.unknown {
+			t.Errorf("pruneGaloisElements(%v, %v) = %v, %v, %d, want %v, %v, %d",
+				tc.galEls, tc.used, kept, pruned, unknown, tc.kept, tc.pruned, tc.unknown)
+		}
+	}
+}
+
+func TestRotationsRoundTrip(t *testing.T) {
+	path := filepath.Join(t.TempDir(), usedRotationsFile)
+	if err := writeRotations(path, []uint64{125, 5, 1 << 40}); err != nil {
+		t.Fatal(err)
+	}
+	got, err := readOrder(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if want := []uint64{5, 125, 1 << 40}; !reflect.DeepEqual(got, want) {
+		t.Errorf("readOrder() = %v, want %v", got, want)
+	}
+	if err := writeRotations(path, nil); err != nil {
+		t.Fatal(err)
+	}
+	if got, err := readOrder(path); err != nil || len(got) != 0 {
+		t.Errorf("readOrder() of an empty record = %v, %v, want no elements", got, err)
+	}
+}
+
+// testKeySet returns small CKKS parameters, a secret key and a key set
+// holding the Galois key of the first of galEls.
+func testKeySet(t *testing.T) (ckks.Parameters, *rlwe.SecretKey, *rlwe.MemEvaluationKeySet, []uint64) {
+	t.Helper()
+	params, err := ckks.NewParametersFromLiteral(ckks.ParametersLiteral{
+		LogN:            10,
+		LogQ:            []int{40, 30},
+		LogP:            []int{40},
+		LogDefaultScale: 30,
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	galEls := []uint64{params.GaloisElement(1), params.GaloisElement(2)}
+	kgen := rlwe.NewKeyGenerator(params)
+	sk := kgen.GenSecretKeyNew()
+	return params, sk, rlwe.NewMemEvaluationKeySet(nil, kgen.GenGaloisKeyNew(galEls[0], sk)), galEls
+}
+
+// TestSecretKeyOfDecryptor fails if a Lattigo upgrade renames or retypes the
+// unexported rlwe.Decryptor field secretKey reads.
+func TestSecretKeyOfDecryptor(t *testing.T) {
+	params, sk, _, _ := testKeySet(t)
+	got, err := secretKey(rlwe.NewDecryptor(params, sk))
+	if err != nil {
+		t.Fatalf("secretKey() = %v; update it for the rlwe.Decryptor of this Lattigo version", err)
+	}
+	if got != sk {
+		t.Errorf("secretKey() = %p, want the decryptor's key %p", got, sk)
+	}
+}
+
+func TestUsageKeySetGeneratesPrunedKeys(t *testing.T) {
+	params, sk, evk, galEls := testKeySet(t)
+	usage := newUsageKeySet(evk, params, sk, true, "")
+
+	stored, err := evk.GetGaloisKey(galEls[0])
+	if err != nil {
+		t.Fatal(err)
+	}
+	if gk, err := usage.GetGaloisKey(galEls[0]); err != nil || gk != stored {
+		t.Errorf("GetGaloisKey(%d) = %p, %v, want the stored key %p", galEls[0], gk, err, stored)
+	}
+
+	gk, err := usage.GetGaloisKey(galEls[1])
+	if err != nil {
+		t.Fatal(err)
+	}
+	if gk.GaloisElement != galEls[1] {
+		t.Errorf("generated key has Galois element %d, want %d", gk.GaloisElement, galEls[1])
+	}
+	if again, err := usage.GetGaloisKey(galEls[1]); err != nil || again != gk {
+		t.Errorf("second GetGaloisKey(%d) = %p, %v, want the generated key %p", galEls[1], again, err, gk)
+	}
+	if len(usage.lazy) != 1 {
+		t.Errorf("generated %d keys, want 1", len(usage.lazy))
+	}
+	if got, want := usage.BinarySize(), evk.BinarySize()+gk.BinarySize(); got != want {
+		t.Errorf("BinarySize() = %d, want %d", got, want)
+	}
+}
+
+func TestUsageKeySetWithoutPruningFailsOnMissingKeys(t *testing.T) {
+	params, sk, evk, galEls := testKeySet(t)
+	usage := newUsageKeySet(evk, params, sk, false, "")
+	if _, err := usage.GetGaloisKey(galEls[1]); err == nil {
+		t.Errorf("GetGaloisKey(%d) of a missing key succeeded on a set that was not pruned", galEls[1])
+	}
+	if len(usage.lazy) != 0 {
+		t.Errorf("generated %d keys, want none", len(usage.lazy))
+	}
+}
+
+func TestUsageKeySetRecordsRotations(t *testing.T) {
+	params, sk, evk, galEls := testKeySet(t)
+	path := filepath.Join(t.TempDir(), usedRotationsFile)
+	usage := newUsageKeySet(evk, params, sk, false, path)
+
+	for _, galEl := range []uint64{galEls[0], galEls[0], galEls[1]} {
+		// The missing key fails, but its request is still recorded.
+		usage.GetGaloisKey(galEl)
+	}
+	got, err := readOrder(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	want := append([]uint64(nil), galEls...)
+	if want[0] > want[1] {
+		want[0], want[1] = want[1], want[0]
+	}
+	if !reflect.DeepEqual(got, want) {
+		t.Errorf("recorded rotations = %v, want %v", got, want)
+	}
+}
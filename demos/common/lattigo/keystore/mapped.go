@@ -0,0 +1,405 @@
+package keystore
+
+import (
+	"bufio"
+	"container/list"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"sort"
+	"strconv"
+	"strings"
+	"sync"
+	"syscall"
+
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+)
+
+const (
+	// prefetchDepth is how many upcoming keys of the recorded rotation order
+	// are prefetched after each key access.
+	prefetchDepth = 4
+)
+
+type span struct {
+	offset, length int64
+}
+
+type cacheEntry struct {
+	galEl uint64
+	key   *rlwe.GaloisKey
+	err   error
+	ready chan struct{}
+	elem  *list.Element
+}
+
+// MappedKeySet is an rlwe.EvaluationKeySet whose Galois keys stay in a
+// memory-mapped file instead of on the Go heap. A key is decoded when an
+// evaluator first asks for it and kept in a cache bounded by a byte budget;
+// evicted keys are decoded again from the mapping on their next use. The
+// file pages are clean and file-backed, so under memory pressure the kernel
+// drops them instead of swapping them out.
+//
+// The set learns the order in which the generated code first requests each
+// rotation. Concurrent workers run the same program, so their first requests
+// follow the program order even though their later requests interleave. The
+// order is recorded next to the keys; later runs use it to prefetch the pages
+// of the next few keys (madvise WILLNEED) and to decode them ahead of use in
+// the background. Every run appends the rotations missing from the recorded
+// order, so an order cut short by an interrupted run is completed by the
+// next one.
+//
+// MappedKeySet is safe for concurrent use, so it can be shared by the
+// ShallowCopies of an evaluator.
+type MappedKeySet struct {
+	relin  *rlwe.RelinearizationKey
+	data   []byte
+	index  map[uint64]span
+	galEls []uint64
+	next   map[uint64][]uint64
+
+	mu         sync.Mutex
+	cache      map[uint64]*cacheEntry
+	lru        *list.List
+	cacheBytes int64
+	budget     int64
+	prefetch   chan struct{}
+
+	orderPath string
+	order     []uint64
+	recorded  map[uint64]bool
+	flushMu   sync.Mutex
+}
+
+var _ rlwe.EvaluationKeySet = (*MappedKeySet)(nil)
+
+// writeMapped stores the keys of set in the layout read by openMapped: the
+// Galois keys back to back in <base>.bin, their offsets in <base>.idx and the
+// relinearization key, if any, in <base>_rlk.bin. The index is written last.
+func writeMapped(dir, base string, set *rlwe.MemEvaluationKeySet) error {
+	if rlk, err := set.GetRelinearizationKey(); err == nil && rlk != nil {
+		if err := writeFile(filepath.Join(dir, base+"_rlk.bin"), rlk); err != nil {
+			return err
+		}
+	}
+
+	galEls := set.GetGaloisKeysList()
+	sort.Slice(galEls, func(i, j int) bool { return galEls[i] < galEls[j] })
+	f, err := os.OpenFile(filepath.Join(dir, base+".bin"), os.O_WRONLY|os.O_CREATE|os.O_TRUNC, 0o600)
+	if err != nil {
+		return err
+	}
+	w := bufio.NewWriterSize(f, 1<<20)
+	index := make([]byte, 8, 8+24*len(galEls))
+	binary.LittleEndian.PutUint64(index, uint64(len(galEls)))
+	var offset int64
+	for _, galEl := range galEls {
+		gk, err := set.GetGaloisKey(galEl)
+		if err != nil {
+			f.Close()
+			return err
+		}
+		n, err := gk.WriteTo(w)
+		if err != nil {
+			f.Close()
+			return fmt.Errorf("failed to write Galois key %d: %w", galEl, err)
+		}
+		index = binary.LittleEndian.AppendUint64(index, galEl)
+		index = binary.LittleEndian.AppendUint64(index, uint64(offset))
+		index = binary.LittleEndian.AppendUint64(index, uint64(n))
+		offset += n
+	}
+	if err := w.Flush(); err != nil {
+		f.Close()
+		return err
+	}
+	if err := f.Close(); err != nil {
+		return err
+	}
+	return os.WriteFile(filepath.Join(dir, base+".idx"), index, 0o600)
+}
+
+func mappedExists(dir, base string) bool {
+	_, err := os.Stat(filepath.Join(dir, base+".idx"))
+	return err == nil
+}
+
+// openMapped maps the keys written by writeMapped. cacheBytes bounds the
+// decoded keys kept on the heap.
+func openMapped(dir, base string, cacheBytes int64) (*MappedKeySet, error) {
+	rawIndex, err := os.ReadFile(filepath.Join(dir, base+".idx"))
+	if err != nil {
+		return nil, err
+	}
+	if len(rawIndex) < 8 {
+		return nil, fmt.Errorf("truncated key index %s", base)
+	}
+	count := int(binary.LittleEndian.Uint64(rawIndex))
+	if len(rawIndex) != 8+24*count {
+		return nil, fmt.Errorf("corrupt key index %s", base)
+	}
+	s := &MappedKeySet{
+		index:     make(map[uint64]span, count),
+		cache:     make(map[uint64]*cacheEntry),
+		lru:       list.New(),
+		budget:    cacheBytes,
+		prefetch:  make(chan struct{}, 1),
+		orderPath: filepath.Join(dir, base+".order"),
+	}
+	for i := 0; i < count; i++ {
+		rec := rawIndex[8+24*i:]
+		galEl := binary.LittleEndian.Uint64(rec)
+		s.index[galEl] = span{
+			offset: int64(binary.LittleEndian.Uint64(rec[8:])),
+			length: int64(binary.LittleEndian.Uint64(rec[16:])),
+		}
+		s.galEls = append(s.galEls, galEl)
+	}
+
+	rlk := new(rlwe.RelinearizationKey)
+	if err := readFile(filepath.Join(dir, base+"_rlk.bin"), rlk); err == nil {
+		s.relin = rlk
+	} else if !errors.Is(err, os.ErrNotExist) {
+		return nil, err
+	}
+
+	if count > 0 {
+		f, err := os.Open(filepath.Join(dir, base+".bin"))
+		if err != nil {
+			return nil, err
+		}
+		defer f.Close()
+		info, err := f.Stat()
+		if err != nil {
+			return nil, err
+		}
+		s.data, err = syscall.Mmap(int(f.Fd()), 0, int(info.Size()), syscall.PROT_READ, syscall.MAP_SHARED)
+		if err != nil {
+			return nil, fmt.Errorf("failed to map %s: %w", f.Name(), err)
+		}
+	}
+
+	order, err := readOrder(s.orderPath)
+	if err != nil && !errors.Is(err, os.ErrNotExist) {
+		return nil, err
+	}
+	s.next = successors(order, prefetchDepth)
+	s.recorded = make(map[uint64]bool, len(order))
+	for _, galEl := range order {
+		if !s.recorded[galEl] {
+			s.recorded[galEl] = true
+			s.order = append(s.order, galEl)
+		}
+	}
+	return s, nil
+}
+
+func readOrder(path string) ([]uint64, error) {
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return nil, err
+	}
+	var order []uint64
+	for _, field := range strings.Fields(string(data)) {
+		galEl, err := strconv.ParseUint(field, 10, 64)
+		if err != nil {
+			return nil, fmt.Errorf("corrupt rotation order %s: %w", path, err)
+		}
+		order = append(order, galEl)
+	}
+	return order, nil
+}
+
+// successors maps every key of order to the distinct keys requested within
+// the next depth accesses after any of its occurrences.
+func successors(order []uint64, depth int) map[uint64][]uint64 {
+	next := make(map[uint64][]uint64)
+	for i, galEl := range order {
+		for j := i + 1; j < len(order) && j <= i+depth; j++ {
+			candidate := order[j]
+			if candidate == galEl {
+				continue
+			}
+			dup := false
+			for _, seen := range next[galEl] {
+				if seen == candidate {
+					dup = true
+					break
+				}
+			}
+			if !dup {
+				next[galEl] = append(next[galEl], candidate)
+			}
+		}
+	}
+	return next
+}
+
+// GetGaloisKeysList returns the Galois elements stored in the file.
+func (s *MappedKeySet) GetGaloisKeysList() []uint64 {
+	return append([]uint64(nil), s.galEls...)
+}
+
+// GetRelinearizationKey returns the relinearization key, which is kept on
+// the heap.
+func (s *MappedKeySet) GetRelinearizationKey() (*rlwe.RelinearizationKey, error) {
+	if s.relin == nil {
+		return nil, fmt.Errorf("relinearization key is not in the key set")
+	}
+	return s.relin, nil
+}
+
+// GetGaloisKey returns the key for galEl, decoding it from the mapping if it
+// is not cached, and starts prefetching the keys that usually follow it.
+func (s *MappedKeySet) GetGaloisKey(galEl uint64) (*rlwe.GaloisKey, error) {
+	if _, ok := s.index[galEl]; !ok {
+		return nil, fmt.Errorf("Galois key for element %d is not in the key set", galEl)
+	}
+	if err := s.record(galEl); err != nil {
+		return nil, err
+	}
+	key, err := s.load(galEl)
+	if err != nil {
+		return nil, err
+	}
+	if err := s.prefetchAfter(galEl); err != nil {
+		return nil, err
+	}
+	return key, nil
+}
+
+// load returns the decoded key for galEl. Concurrent requests for the same
+// key wait for a single decode.
+func (s *MappedKeySet) load(galEl uint64) (*rlwe.GaloisKey, error) {
+	s.mu.Lock()
+	if e, ok := s.cache[galEl]; ok {
+		s.lru.MoveToFront(e.elem)
+		s.mu.Unlock()
+		<-e.ready
+		return e.key, e.err
+	}
+	e := &cacheEntry{galEl: galEl, ready: make(chan struct{})}
+	e.elem = s.lru.PushFront(e)
+	s.cache[galEl] = e
+	sp := s.index[galEl]
+	s.cacheBytes += sp.length
+	s.evictLocked()
+	s.mu.Unlock()
+
+	key := new(rlwe.GaloisKey)
+	if err := key.UnmarshalBinary(s.data[sp.offset : sp.offset+sp.length]); err != nil {
+		e.err = fmt.Errorf("failed to decode Galois key %d: %w", galEl, err)
+	} else {
+		e.key = key
+	}
+	close(e.ready)
+	if e.err != nil {
+		s.mu.Lock()
+		s.removeLocked(e)
+		s.mu.Unlock()
+	}
+	return e.key, e.err
+}
+
+// evictLocked drops least recently used keys until the cache fits its
+// budget. The most recently used key is never dropped.
+func (s *MappedKeySet) evictLocked() {
+	for s.cacheBytes > s.budget && s.lru.Len() > 1 {
+		s.removeLocked(s.lru.Back().Value.(*cacheEntry))
+	}
+}
+
+func (s *MappedKeySet) removeLocked(e *cacheEntry) {
+	if s.cache[e.galEl] != e {
+		return
+	}
+	s.lru.Remove(e.elem)
+	delete(s.cache, e.galEl)
+	s.cacheBytes -= s.index[e.galEl].length
+}
+
+// prefetchAfter advises the kernel to read the pages of the keys that follow
+// galEl in the recorded order, and decodes the first one that is not cached
+// yet in the background. At most one background decode runs at a time, so
+// prefetching never competes with evaluation for more than one core. A failed
+// background decode is not cached, so the next request decodes the key again
+// and gets the error.
+func (s *MappedKeySet) prefetchAfter(galEl uint64) error {
+	next := s.next[galEl]
+	if len(next) == 0 {
+		return nil
+	}
+	for _, n := range next {
+		if err := s.willNeed(s.index[n]); err != nil {
+			return fmt.Errorf("failed to prefetch Galois key %d: %w", n, err)
+		}
+	}
+	s.mu.Lock()
+	var toDecode uint64
+	found := false
+	for _, n := range next {
+		if _, ok := s.cache[n]; !ok {
+			toDecode, found = n, true
+			break
+		}
+	}
+	s.mu.Unlock()
+	if !found {
+		return nil
+	}
+	select {
+	case s.prefetch <- struct{}{}:
+		go func() {
+			defer func() { <-s.prefetch }()
+			s.load(toDecode)
+		}()
+	default:
+	}
+	return nil
+}
+
+// willNeed advises the kernel to read the pages of a key. madvise needs a
+// page-aligned start, and keys start anywhere in the mapping.
+func (s *MappedKeySet) willNeed(sp span) error {
+	start := sp.offset &^ int64(os.Getpagesize()-1)
+	return syscall.Madvise(s.data[start:sp.offset+sp.length], syscall.MADV_WILLNEED)
+}
+
+// record appends galEl to the rotation order if it was not requested before
+// and writes the order out right away. New rotations are rare after the first
+// inference, so the order is written synchronously and is complete whenever
+// the process stops.
+func (s *MappedKeySet) record(galEl uint64) error {
+	s.mu.Lock()
+	if s.recorded[galEl] {
+		s.mu.Unlock()
+		return nil
+	}
+	s.recorded[galEl] = true
+	s.order = append(s.order, galEl)
+	s.mu.Unlock()
+	return s.flushOrder()
+}
+
+func (s *MappedKeySet) flushOrder() error {
+	s.flushMu.Lock()
+	defer s.flushMu.Unlock()
+	s.mu.Lock()
+	var b strings.Builder
+	for _, galEl := range s.order {
+		b.WriteString(strconv.FormatUint(galEl, 10))
+		b.WriteByte('\n')
+	}
+	s.mu.Unlock()
+
+	tmp := s.orderPath + ".tmp"
+	if err := os.WriteFile(tmp, []byte(b.String()), 0o600); err != nil {
+		return fmt.Errorf("failed to write the rotation order: %w", err)
+	}
+	if err := os.Rename(tmp, s.orderPath); err != nil {
+		return fmt.Errorf("failed to write the rotation order: %w", err)
+	}
+	return nil
+}
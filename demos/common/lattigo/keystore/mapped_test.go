@@ -0,0 +1,203 @@
+package keystore
+
+import (
+	"bytes"
+	"reflect"
+	"sort"
+	"sync"
+	"testing"
+
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+)
+
+// writeTestKeys writes a relinearization key and n Galois keys to dir with
+// writeMapped and returns the key set and its Galois elements.
+func writeTestKeys(t *testing.T, dir string, n int) (*rlwe.MemEvaluationKeySet, []uint64) {
+	t.Helper()
+	params, sk, _, _ := testKeySet(t)
+	kgen := rlwe.NewKeyGenerator(params)
+	galEls := make([]uint64, n)
+	for i := range galEls {
+		galEls[i] = params.GaloisElement(i + 1)
+	}
+	evk := rlwe.NewMemEvaluationKeySet(kgen.GenRelinearizationKeyNew(sk), kgen.GenGaloisKeysNew(galEls, sk)...)
+	if err := writeMapped(dir, "galois", evk); err != nil {
+		t.Fatal(err)
+	}
+	return evk, galEls
+}
+
+// sameKey reports whether two Galois keys have the same serialization.
+func sameKey(t *testing.T, a, b *rlwe.GaloisKey) bool {
+	t.Helper()
+	aBytes, err := a.MarshalBinary()
+	if err != nil {
+		t.Fatal(err)
+	}
+	bBytes, err := b.MarshalBinary()
+	if err != nil {
+		t.Fatal(err)
+	}
+	return bytes.Equal(aBytes, bBytes)
+}
+
+func TestMappedRoundTrip(t *testing.T) {
+	dir := t.TempDir()
+	evk, galEls := writeTestKeys(t, dir, 3)
+	s, err := openMapped(dir, "galois", 1<<40)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	want := append([]uint64(nil), galEls...)
+	sort.Slice(want, func(i, j int) bool { return want[i] < want[j] })
+	if got := s.GetGaloisKeysList(); !reflect.DeepEqual(got, want) {
+		t.Errorf("GetGaloisKeysList() = %v, want %v", got, want)
+	}
+	if _, err := s.GetRelinearizationKey(); err != nil {
+		t.Errorf("GetRelinearizationKey() = %v, want the stored key", err)
+	}
+	for _, galEl := range galEls {
+		got, err := s.GetGaloisKey(galEl)
+		if err != nil {
+			t.Fatal(err)
+		}
+		stored, _ := evk.GetGaloisKey(galEl)
+		if !sameKey(t, got, stored) {
+			t.Errorf("GetGaloisKey(%d) differs from the written key", galEl)
+		}
+	}
+	if _, err := s.GetGaloisKey(galEls[0] + 1); err == nil {
+		t.Errorf("GetGaloisKey(%d) of a missing key succeeded", galEls[0]+1)
+	}
+}
+
+func TestMappedEvictsOverBudget(t *testing.T) {
+	dir := t.TempDir()
+	evk, galEls := writeTestKeys(t, dir, 3)
+	probe, err := openMapped(dir, "galois", 0)
+	if err != nil {
+		t.Fatal(err)
+	}
+	keyBytes := probe.index[galEls[0]].length
+
+	// Room for one and a half keys: every load evicts the previous key.
+	s, err := openMapped(dir, "galois", keyBytes+keyBytes/2)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for round := 0; round < 2; round++ {
+		for _, galEl := range galEls {
+			got, err := s.GetGaloisKey(galEl)
+			if err != nil {
+				t.Fatal(err)
+			}
+			stored, _ := evk.GetGaloisKey(galEl)
+			if !sameKey(t, got, stored) {
+				t.Errorf("GetGaloisKey(%d) after eviction differs from the written key", galEl)
+			}
+			s.mu.Lock()
+			cached, cacheBytes := s.lru.Len(), s.cacheBytes
+			_, isCached := s.cache[galEl]
+			s.mu.Unlock()
+			if cached != 1 || !isCached || cacheBytes > s.budget {
+				t.Errorf("after GetGaloisKey(%d): %d keys (%d bytes) cached, want only that key within %d bytes",
+					galEl, cached, cacheBytes, s.budget)
+			}
+		}
+	}
+}
+
+func TestMappedParallelLoads(t *testing.T) {
+	dir := t.TempDir()
+	evk, galEls := writeTestKeys(t, dir, 4)
+	probe, err := openMapped(dir, "galois", 0)
+	if err != nil {
+		t.Fatal(err)
+	}
+	// Room for two of the four keys, so loads, hits and evictions interleave.
+	s, err := openMapped(dir, "galois", 2*probe.index[galEls[0]].length)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	want := make(map[uint64][]byte)
+	for _, galEl := range galEls {
+		stored, _ := evk.GetGaloisKey(galEl)
+		if want[galEl], err = stored.MarshalBinary(); err != nil {
+			t.Fatal(err)
+		}
+	}
+	var wg sync.WaitGroup
+	for w := 0; w < 8; w++ {
+		wg.Add(1)
+		go func(w int) {
+			defer wg.Done()
+			for i := 0; i < 4*len(galEls); i++ {
+				galEl := galEls[(w+i)%len(galEls)]
+				gk, err := s.GetGaloisKey(galEl)
+				if err != nil {
+					t.Error(err)
+					return
+				}
+				got, err := gk.MarshalBinary()
+				if err != nil || !bytes.Equal(got, want[galEl]) {
+					t.Errorf("GetGaloisKey(%d) differs from the written key", galEl)
+					return
+				}
+			}
+		}(w)
+	}
+	wg.Wait()
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if s.cacheBytes > s.budget {
+		t.Errorf("%d bytes cached, want at most %d", s.cacheBytes, s.budget)
+	}
+}
+
+func TestMappedRecordsRotationOrder(t *testing.T) {
+	dir := t.TempDir()
+	_, galEls := writeTestKeys(t, dir, 3)
+	s, err := openMapped(dir, "galois", 1<<40)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for _, galEl := range []uint64{galEls[2], galEls[0], galEls[2]} {
+		if _, err := s.GetGaloisKey(galEl); err != nil {
+			t.Fatal(err)
+		}
+	}
+	// Written on every new rotation, without waiting for the process to end.
+	if got, err := readOrder(s.orderPath); err != nil || !reflect.DeepEqual(got, []uint64{galEls[2], galEls[0]}) {
+		t.Fatalf("recorded order = %v, %v, want %v", got, err, []uint64{galEls[2], galEls[0]})
+	}
+
+	// A later run prefetches along the order and completes it.
+	s, err = openMapped(dir, "galois", 1<<40)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if got := s.next[galEls[2]]; !reflect.DeepEqual(got, []uint64{galEls[0]}) {
+		t.Errorf("successors of %d = %v, want %v", galEls[2], got, []uint64{galEls[0]})
+	}
+	if _, err := s.GetGaloisKey(galEls[1]); err != nil {
+		t.Fatal(err)
+	}
+	want := []uint64{galEls[2], galEls[0], galEls[1]}
+	if got, err := readOrder(s.orderPath); err != nil || !reflect.DeepEqual(got, want) {
+		t.Errorf("completed order = %v, %v, want %v", got, err, want)
+	}
+}
+
+func TestSuccessors(t *testing.T) {
+	got := successors([]uint64{1, 2, 3, 1, 4}, 2)
+	want := map[uint64][]uint64{
+		1: {2, 3, 4},
+		2: {3, 1},
+		3: {1, 4},
+	}
+	if !reflect.DeepEqual(got, want) {
+		t.Errorf("successors() = %v, want %v", got, want)
+	}
+}
@@ -0,0 +1,165 @@
+package keystore
+
+import (
+	"fmt"
+	"os"
+	"sort"
+	"strconv"
+	"strings"
+	"sync"
+
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
+)
+
+// usedRotationsFile is written to the key directory by RecordRotations.
+const usedRotationsFile = "rotations_used.txt"
+
+// usageKeySet wraps the evaluation keys of the model evaluator. It records
+// the distinct Galois elements the generated code requests, and generates the
+// keys a pruned key set lacks on their first use instead of failing.
+//
+// The bootstrapping evaluator keeps its own key set: its rotations depend on
+// the bootstrapping parameters only, not on the model.
+type usageKeySet struct {
+	rlwe.EvaluationKeySet
+	params ckks.Parameters
+	sk     *rlwe.SecretKey
+
+	// stored holds the Galois elements of the wrapped set. Other keys are
+	// generated on demand if the set was pruned.
+	stored map[uint64]bool
+	pruned bool
+	// recordPath is empty unless rotations are recorded.
+	recordPath string
+
+	mu   sync.Mutex
+	used map[uint64]bool
+	lazy map[uint64]*rlwe.GaloisKey
+
+	flushMu sync.Mutex
+}
+
+var _ rlwe.EvaluationKeySet = (*usageKeySet)(nil)
+
+// newUsageKeySet wraps evk. If pruned, keys missing from evk are generated
+// with sk on their first use; a non-empty recordPath records the Galois
+// elements requested there.
+func newUsageKeySet(evk rlwe.EvaluationKeySet, params ckks.Parameters, sk *rlwe.SecretKey, pruned bool, recordPath string) *usageKeySet {
+	s := &usageKeySet{
+		EvaluationKeySet: evk,
+		params:           params,
+		sk:               sk,
+		stored:           make(map[uint64]bool),
+		pruned:           pruned,
+		recordPath:       recordPath,
+		used:             make(map[uint64]bool),
+		lazy:             make(map[uint64]*rlwe.GaloisKey),
+	}
+	for _, galEl := range evk.GetGaloisKeysList() {
+		s.stored[galEl] = true
+	}
+	return s
+}
+
+// GetGaloisKey returns the stored key for galEl, or generates it with a
+// warning if the key set was pruned without it.
+func (s *usageKeySet) GetGaloisKey(galEl uint64) (*rlwe.GaloisKey, error) {
+	if s.recordPath != "" {
+		s.record(galEl)
+	}
+	if s.stored[galEl] || !s.pruned {
+		return s.EvaluationKeySet.GetGaloisKey(galEl)
+	}
+
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if gk, ok := s.lazy[galEl]; ok {
+		return gk, nil
+	}
+	fmt.Printf("  Warning: Galois key %d is not in the pruned key set, generating it; record the rotations on a more representative input set\n", galEl)
+	gk := rlwe.NewKeyGenerator(s.params).GenGaloisKeyNew(galEl, s.sk)
+	s.lazy[galEl] = gk
+	return gk, nil
+}
+
+// BinarySize returns the serialized size of the wrapped key set, if it has
+// one, plus the keys generated on demand.
+func (s *usageKeySet) BinarySize() int {
+	sized, ok := s.EvaluationKeySet.(interface{ BinarySize() int })
+	if !ok {
+		return 0
+	}
+	size := sized.BinarySize()
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	for _, gk := range s.lazy {
+		size += gk.BinarySize()
+	}
+	return size
+}
+
+// record adds galEl to the set of used Galois elements and rewrites the
+// record when it grows. New elements are rare after the first inference, so
+// the record is written synchronously and is complete whenever the process
+// stops.
+func (s *usageKeySet) record(galEl uint64) {
+	s.mu.Lock()
+	if s.used[galEl] {
+		s.mu.Unlock()
+		return
+	}
+	s.used[galEl] = true
+	s.mu.Unlock()
+	s.flushRecord()
+}
+
+func (s *usageKeySet) flushRecord() {
+	s.flushMu.Lock()
+	defer s.flushMu.Unlock()
+	s.mu.Lock()
+	galEls := make([]uint64, 0, len(s.used))
+	for galEl := range s.used {
+		galEls = append(galEls, galEl)
+	}
+	s.mu.Unlock()
+	if err := writeRotations(s.recordPath, galEls); err != nil {
+		fmt.Printf("  Warning: cannot write the rotation record: %v\n", err)
+	}
+}
+
+// writeRotations writes galEls sorted, one per line, in the format read by
+// readOrder.
+func writeRotations(path string, galEls []uint64) error {
+	sort.Slice(galEls, func(i, j int) bool { return galEls[i] < galEls[j] })
+	var b strings.Builder
+	for _, galEl := range galEls {
+		b.WriteString(strconv.FormatUint(galEl, 10))
+		b.WriteByte('\n')
+	}
+	tmp := path + ".tmp"
+	if err := os.WriteFile(tmp, []byte(b.String()), 0o600); err != nil {
+		return err
+	}
+	return os.Rename(tmp, path)
+}
+
+// pruneGaloisElements splits galEls into the elements that appear in used
+// and the others, keeping their order. unknown counts the used elements the
+// model does not ask for, which point at a record taken with another model or
+// other parameters.
+func pruneGaloisElements(galEls, used []uint64) (kept, pruned []uint64, unknown int) {
+	isUsed := make(map[uint64]bool, len(used))
+	for _, galEl := range used {
+		isUsed[galEl] = true
+	}
+	for _, galEl := range galEls {
+		if isUsed[galEl] {
+			kept = append(kept, galEl)
+			delete(isUsed, galEl)
+		} else {
+			pruned = append(pruned, galEl)
+		}
+	}
+	return kept, pruned, len(isUsed)
+}
@@ -0,0 +1,118 @@
+// Package primitives benchmarks the CKKS primitives at the parameters of a
+// generated model, to give a per-operation cost model for its evaluation.
+//
+// Each operation is timed at every level as a sub-benchmark named
+// op=<op>/level=<level>, where the level is the number of remaining moduli
+// minus one. The OpenFHE primitives benchmarks use the same names, so
+// `benchstat -format csv` output from both backends can be joined with
+// per-operation counts on (op, level).
+package primitives
+
+import (
+	"fmt"
+	"testing"
+
+	"github.com/tuneinsight/lattigo/v6/circuits/ckks/bootstrapping"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
+)
+
+// Run benchmarks the primitives of evaluator as sub-benchmarks of b:
+//
+//   - add: ciphertext-ciphertext addition
+//   - mul_plain: ciphertext-plaintext multiplication
+//   - mul_relin: ciphertext-ciphertext multiplication and relinearization
+//   - rescale: rescaling of a ciphertext-ciphertext product (level >= 1)
+//   - rotate: key switching with one of the model's Galois keys
+//   - bootstrap: a full bootstrap, only if btp is not nil
+//
+// The evaluation keys are those the generated configure function created, so
+// rotate and mul_relin are skipped when the model does not use them.
+func Run(b *testing.B, params ckks.Parameters, evaluator *ckks.Evaluator, ecd *ckks.Encoder, encryptor *rlwe.Encryptor, btp *bootstrapping.Evaluator) {
+	keys := evaluator.GetEvaluationKeySet()
+	_, relinErr := keys.GetRelinearizationKey()
+	var galEl uint64
+	if galEls := keys.GetGaloisKeysList(); len(galEls) > 0 {
+		galEl = galEls[0]
+	}
+
+	for level := params.MaxLevel(); level >= 0; level-- {
+		ct0, ct1, pt, err := operands(params, ecd, encryptor, level)
+		if err != nil {
+			b.Fatal(err)
+		}
+		out := ckks.NewCiphertext(params, 1, level)
+
+		bench(b, "add", level, func() error {
+			return evaluator.Add(ct0, ct1, out)
+		})
+		bench(b, "mul_plain", level, func() error {
+			return evaluator.Mul(ct0, pt, out)
+		})
+		if relinErr == nil {
+			bench(b, "mul_relin", level, func() error {
+				return evaluator.MulRelin(ct0, ct1, out)
+			})
+		}
+		if level > 0 {
+			prod := ckks.NewCiphertext(params, 1, level)
+			if err := evaluator.Mul(ct0, pt, prod); err != nil {
+				b.Fatal(err)
+			}
+			rescaled := ckks.NewCiphertext(params, 1, level-1)
+			bench(b, "rescale", level, func() error {
+				return evaluator.Rescale(prod, rescaled)
+			})
+		}
+		if galEl != 0 {
+			rotated := ckks.NewCiphertext(params, 1, level)
+			bench(b, "rotate", level, func() error {
+				return evaluator.Automorphism(ct0, galEl, rotated)
+			})
+		}
+	}
+
+	if btp != nil {
+		ct := ckks.NewCiphertext(params, 1, 0)
+		if err := encryptor.EncryptZero(ct); err != nil {
+			b.Fatal(err)
+		}
+		bench(b, "bootstrap", 0, func() error {
+			_, err := btp.Bootstrap(ct)
+			return err
+		})
+	}
+}
+
+// operands encrypts two ciphertexts and encodes one plaintext at level, all
+// at the default scale.
+func operands(params ckks.Parameters, ecd *ckks.Encoder, encryptor *rlwe.Encryptor, level int) (ct0, ct1 *rlwe.Ciphertext, pt *rlwe.Plaintext, err error) {
+	values := make([]float64, params.MaxSlots())
+	for i := range values {
+		values[i] = 0.5
+	}
+	pt = ckks.NewPlaintext(params, level)
+	if err := ecd.Encode(values, pt); err != nil {
+		return nil, nil, nil, err
+	}
+	ct0 = ckks.NewCiphertext(params, 1, level)
+	ct1 = ckks.NewCiphertext(params, 1, level)
+	if err := encryptor.Encrypt(pt, ct0); err != nil {
+		return nil, nil, nil, err
+	}
+	if err := encryptor.Encrypt(pt, ct1); err != nil {
+		return nil, nil, nil, err
+	}
+	return ct0, ct1, pt, nil
+}
+
+func bench(b *testing.B, op string, level int, f func() error) {
+	b.Run(fmt.Sprintf("op=%s/level=%d", op, level), func(b *testing.B) {
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			if err := f(); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
@@ -0,0 +1,72 @@
+// Package recycle keeps per-worker ciphertext buffers alive across samples so
+// that suites do not allocate fresh ones for every evaluation.
+package recycle
+
+import (
+	"fmt"
+
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+)
+
+// Zeros holds one worker's zero-accumulator ciphertexts for the lifetime of
+// the worker. The accumulators are encrypted once with the generated
+// encrypt__zero__* functions; for every further sample they are re-encrypted
+// in place, which restores them even if the generated code accumulated into
+// them, without allocating new polynomials.
+//
+// Zeros is not safe for concurrent use; keep one per worker.
+type Zeros struct {
+	cts    []*rlwe.Ciphertext
+	levels []int
+	meta   []rlwe.MetaData
+}
+
+// NewZeros takes ownership of freshly encrypted zero accumulators and records
+// the level and metadata they were encrypted with.
+func NewZeros(cts ...*rlwe.Ciphertext) *Zeros {
+	z := &Zeros{
+		cts:    cts,
+		levels: make([]int, len(cts)),
+		meta:   make([]rlwe.MetaData, len(cts)),
+	}
+	for i, ct := range cts {
+		z.levels[i] = ct.Level()
+		z.meta[i] = *ct.MetaData
+	}
+	return z
+}
+
+// Get returns the i-th accumulator.
+func (z *Zeros) Get(i int) *rlwe.Ciphertext {
+	return z.cts[i]
+}
+
+// Refresh re-encrypts zero into every accumulator at its original level,
+// scale and domain. It must be called before each sample but the first, once
+// the previous evaluation no longer uses the accumulators.
+func (z *Zeros) Refresh(encryptor *rlwe.Encryptor) error {
+	for i, ct := range z.cts {
+		if ct.Degree() != 1 || ct.Level() != z.levels[i] {
+			ct.Resize(1, z.levels[i])
+		}
+		*ct.MetaData = z.meta[i]
+		if err := encryptor.EncryptZero(ct); err != nil {
+			return fmt.Errorf("failed to re-encrypt zero accumulator %d: %w", i, err)
+		}
+	}
+	return nil
+}
+
+// Detach replaces every entry of out that aliases one of the accumulators
+// with a copy, so that the next Refresh does not overwrite a result that has
+// not been decrypted yet.
+func (z *Zeros) Detach(out []*rlwe.Ciphertext) {
+	for i, ct := range out {
+		for _, acc := range z.cts {
+			if ct == acc {
+				out[i] = ct.CopyNew()
+				break
+			}
+		}
+	}
+}
@@ -0,0 +1,124 @@
+#include "demos/common/openfhe/benchmark_helper.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "src/core/include/utils/parallel.h"
+#include "src/pke/include/cryptocontext-ser.h"
+#include "src/pke/include/cryptocontext.h"
+#include "src/pke/include/key/key-ser.h"
+#include "src/pke/include/scheme/ckksrns/ckksrns-ser.h"
+
+void ThreadCounts(benchmark::internal::Benchmark* b) {
+  const int machine_threads =
+      lbcrypto::OpenFHEParallelControls.GetMachineThreads();
+  b->ArgName("threads");
+  for (int threads = 1; threads < machine_threads; threads *= 2) {
+    b->Arg(threads);
+  }
+  b->Arg(machine_threads);
+}
+
+void SetThreads(benchmark::State& state) {
+  const int threads = static_cast<int>(state.range(0));
+  lbcrypto::OpenFHEParallelControls.SetNumThreads(threads);
+  state.counters["omp_threads"] = threads;
+}
+
+void ReportEvalKeyBytes(benchmark::State& state, const KeyPairT& keys) {
+  using CryptoContextImplT = lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>;
+  const std::string& tag = keys.secretKey->GetKeyTag();
+  std::ostringstream mult_keys;
+  std::ostringstream rotation_keys;
+  CryptoContextImplT::SerializeEvalMultKey(mult_keys, lbcrypto::SerType::BINARY,
+                                           tag);
+  CryptoContextImplT::SerializeEvalAutomorphismKey(
+      rotation_keys, lbcrypto::SerType::BINARY, tag);
+  const double mult_bytes = mult_keys.tellp();
+  const double rotation_bytes = rotation_keys.tellp();
+  state.counters["eval_mult_key_bytes"] = mult_bytes;
+  state.counters["eval_rotation_key_bytes"] = rotation_bytes;
+  state.counters["eval_key_bytes"] = mult_bytes + rotation_bytes;
+}
+
+void ClearEvalKeys(const KeyPairT& keys) {
+  using CryptoContextImplT = lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>;
+  if (!keys.secretKey) return;
+  const std::string& tag = keys.secretKey->GetKeyTag();
+  CryptoContextImplT::ClearEvalMultKeys(tag);
+  CryptoContextImplT::ClearEvalAutomorphismKeys(tag);
+}
+
+namespace {
+
+void RegisterPrimitive(const std::string& op, int level,
+                       std::function<void()> f) {
+  benchmark::RegisterBenchmark(
+      "op=" + op + "/level=" + std::to_string(level),
+      [f](benchmark::State& state) {
+        for (auto _ : state) {
+          f();
+        }
+      })
+      ->Unit(benchmark::kMicrosecond)
+      ->UseRealTime();
+}
+
+}  // namespace
+
+void RegisterPrimitiveBenchmarks(CryptoContextT cc, const KeyPairT& keys) {
+  const auto crypto_params =
+      std::dynamic_pointer_cast<lbcrypto::CryptoParametersRNS>(
+          cc->GetCryptoParameters());
+  const auto technique = crypto_params->GetScalingTechnique();
+  // FLEXIBLEAUTOEXT keeps one extra tower on fresh ciphertexts.
+  const size_t towers = crypto_params->GetElementParams()->GetParams().size();
+  const size_t max_consumed =
+      towers - (technique == lbcrypto::FLEXIBLEAUTOEXT ? 2 : 1);
+
+  const std::string& tag = keys.secretKey->GetKeyTag();
+  const auto& mult_keys = lbcrypto::CryptoContextImpl<
+      lbcrypto::DCRTPoly>::GetAllEvalMultKeys();
+  const bool has_relin = mult_keys.find(tag) != mult_keys.end();
+  const auto& rot_keys = lbcrypto::CryptoContextImpl<
+      lbcrypto::DCRTPoly>::GetAllEvalAutomorphismKeys();
+  std::shared_ptr<std::map<uint32_t, lbcrypto::EvalKey<lbcrypto::DCRTPoly>>>
+      rot_key_map;
+  if (auto it = rot_keys.find(tag);
+      it != rot_keys.end() && !it->second->empty()) {
+    rot_key_map = it->second;
+  }
+
+  const std::vector<double> values(cc->GetEncodingParams()->GetBatchSize(),
+                                   0.5);
+  for (size_t consumed = 0; consumed <= max_consumed; ++consumed) {
+    auto pt = cc->MakeCKKSPackedPlaintext(values, 1, consumed);
+    auto ct0 = cc->Encrypt(keys.publicKey, pt);
+    auto ct1 = cc->Encrypt(keys.publicKey, pt);
+    const int level =
+        static_cast<int>(ct0->GetElements()[0].GetNumOfElements()) - 1;
+
+    RegisterPrimitive("add", level, [=] { cc->EvalAdd(ct0, ct1); });
+    RegisterPrimitive("mul_plain", level, [=] { cc->EvalMult(ct0, pt); });
+    if (has_relin) {
+      RegisterPrimitive("mul_relin", level, [=] { cc->EvalMult(ct0, ct1); });
+    }
+    if (technique == lbcrypto::FIXEDMANUAL && consumed < max_consumed) {
+      auto prod = cc->EvalMult(ct0, pt);
+      RegisterPrimitive("rescale", level, [=] { cc->Rescale(prod); });
+    }
+    if (rot_key_map) {
+      const uint32_t index = rot_key_map->begin()->first;
+      RegisterPrimitive("rotate", level, [=] {
+        cc->EvalAutomorphism(ct0, index, *rot_key_map);
+      });
+    }
+  }
+}
@@ -0,0 +1,46 @@
+#ifndef THIRD_PARTY_FULLY_HOMOMORPHIC_ENCRYPTION_DEMOS_COMMON_OPENFHE_BENCHMARK_HELPER_H_
+#define THIRD_PARTY_FULLY_HOMOMORPHIC_ENCRYPTION_DEMOS_COMMON_OPENFHE_BENCHMARK_HELPER_H_
+
+#include "benchmark/benchmark.h"
+#include "src/pke/include/cryptocontext-fwd.h"
+#include "src/pke/include/key/keypair.h"
+
+using CryptoContextT = lbcrypto::CryptoContext<lbcrypto::DCRTPoly>;
+using KeyPairT = lbcrypto::KeyPair<lbcrypto::DCRTPoly>;
+
+// Helpers of the Google Benchmark targets of the OpenFHE models. CKKS runs the
+// same operations whatever the encrypted values, so the benchmarks encrypt
+// constant inputs instead of test data.
+
+// Registers one run per OpenMP thread count: powers of two up to the number
+// of hardware threads, plus the hardware thread count itself. The count is
+// the benchmark's first argument, named "threads".
+void ThreadCounts(benchmark::internal::Benchmark* b);
+
+// Sets the OpenFHE thread count to the "threads" argument of state and
+// reports it as a counter, so JSON results can be grouped by thread count.
+void SetThreads(benchmark::State& state);
+
+// Reports the serialized sizes of the relinearization and rotation keys of
+// keys as the counters eval_mult_key_bytes, eval_rotation_key_bytes and
+// eval_key_bytes (their sum), which compare_backends reads.
+void ReportEvalKeyBytes(benchmark::State& state, const KeyPairT& keys);
+
+// Removes the relinearization and rotation keys of keys from OpenFHE's global
+// key maps. Does nothing if keys has no secret key.
+void ClearEvalKeys(const KeyPairT& keys);
+
+// Registers one benchmark per CKKS primitive and level of a configured
+// context, named op=<op>/level=<level>/real_time, where the level is the
+// number of remaining RNS towers minus one. The names match the Lattigo
+// primitives benchmarks so the results of both backends can be joined with
+// per-operation counts. Call between benchmark::Initialize and
+// benchmark::RunSpecifiedBenchmarks.
+//
+// The operations are add, mul_plain, mul_relin (if cc has a relinearization
+// key for keys), rescale (with FIXEDMANUAL scaling only; the other techniques
+// rescale inside the multiplication) and rotate (with the first of the
+// context's rotation keys, if any).
+void RegisterPrimitiveBenchmarks(CryptoContextT cc, const KeyPairT& keys);
+
+#endif  // THIRD_PARTY_FULLY_HOMOMORPHIC_ENCRYPTION_DEMOS_COMMON_OPENFHE_BENCHMARK_HELPER_H_
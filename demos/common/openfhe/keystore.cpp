@@ -0,0 +1,257 @@
+#include "demos/common/openfhe/keystore.h"
+
+#include <sys/resource.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <iterator>
+#include <streambuf>
+#include <string>
+#include <system_error>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "src/pke/include/cryptocontext-ser.h"
+#include "src/pke/include/cryptocontext.h"
+#include "src/pke/include/key/key-ser.h"
+#include "src/pke/include/scheme/ckksrns/ckksrns-ser.h"
+
+namespace {
+
+using CryptoContextImplT = lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>;
+
+constexpr char kContextFile[] = "context.bin";
+constexpr char kPublicKeyFile[] = "public_key.bin";
+constexpr char kSecretKeyFile[] = "secret_key.bin";
+constexpr char kEvalMultKeyFile[] = "eval_mult_keys.bin";
+constexpr char kRotationKeyFile[] = "rotation_keys.bin";
+constexpr char kFingerprintFile[] = "fingerprint.txt";
+
+// A stream buffer that only counts the bytes written to it.
+class CountingBuffer : public std::streambuf {
+ public:
+  int64_t count() const { return count_; }
+
+ protected:
+  std::streamsize xsputn(const char* /*s*/, std::streamsize n) override {
+    count_ += n;
+    return n;
+  }
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) ++count_;
+    return traits_type::not_eof(c);
+  }
+
+ private:
+  int64_t count_ = 0;
+};
+
+// Writes one file of dir through a temporary file, so that an interrupted
+// run never leaves a truncated file under its final name.
+absl::Status WriteFile(const std::filesystem::path& dir, const char* name,
+                       const std::function<bool(std::ostream&)>& write) {
+  const std::filesystem::path path = dir / name;
+  const std::filesystem::path tmp = dir / (std::string(name) + ".tmp");
+  {
+    std::ofstream out(tmp, std::ios::binary);
+    if (!out || !write(out) || !out.flush()) {
+      return absl::InternalError("cannot write " + tmp.string());
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp, path, ec);
+  if (ec) {
+    return absl::InternalError("cannot rename " + tmp.string() + ": " +
+                               ec.message());
+  }
+  return absl::OkStatus();
+}
+
+// Describes the parameters of a context: its ring dimension, batch size and
+// ciphertext moduli. Unlike the printed crypto parameters, it leaves out the
+// roots of unity, which OpenFHE picks at random.
+std::string ParamsFingerprint(const CryptoContextT& cc) {
+  std::string out =
+      absl::StrCat("ring_dimension ", cc->GetRingDimension(), "\nbatch_size ",
+                   cc->GetEncodingParams()->GetBatchSize(), "\nmoduli");
+  for (const auto& params : cc->GetElementParams()->GetParams()) {
+    absl::StrAppend(&out, " ", params->GetModulus().ConvertToInt());
+  }
+  return out;
+}
+
+// Lists the automorphism indices of the rotation keys of a key tag.
+std::string RotationFingerprint(const std::string& tag) {
+  std::string out = "automorphisms";
+  const auto& all_keys = CryptoContextImplT::GetAllEvalAutomorphismKeys();
+  if (auto it = all_keys.find(tag); it != all_keys.end()) {
+    for (const auto& [index, key] : *it->second) {
+      absl::StrAppend(&out, " ", index);
+    }
+  }
+  return out;
+}
+
+absl::Status Save(const std::filesystem::path& dir,
+                  const ConfiguredContext& ctx) {
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (ec) {
+    return absl::InternalError("cannot create " + dir.string() + ": " +
+                               ec.message());
+  }
+  const std::string& tag = ctx.keys.secretKey->GetKeyTag();
+  const auto binary = lbcrypto::SerType::BINARY;
+  // The context is written last: its presence marks a complete directory.
+  absl::Status status =
+      WriteFile(dir, kFingerprintFile, [&](std::ostream& out) {
+        out << ParamsFingerprint(ctx.cc) << "\n"
+            << RotationFingerprint(tag) << "\n";
+        return true;
+      });
+  if (status.ok()) {
+    status = WriteFile(dir, kPublicKeyFile, [&](std::ostream& out) {
+      lbcrypto::Serial::Serialize(ctx.keys.publicKey, out, binary);
+      return true;
+    });
+  }
+  if (status.ok()) {
+    status = WriteFile(dir, kSecretKeyFile, [&](std::ostream& out) {
+      lbcrypto::Serial::Serialize(ctx.keys.secretKey, out, binary);
+      return true;
+    });
+  }
+  if (status.ok()) {
+    status = WriteFile(dir, kEvalMultKeyFile, [&](std::ostream& out) {
+      return CryptoContextImplT::SerializeEvalMultKey(out, binary, tag);
+    });
+  }
+  if (status.ok()) {
+    status = WriteFile(dir, kRotationKeyFile, [&](std::ostream& out) {
+      return CryptoContextImplT::SerializeEvalAutomorphismKey(out, binary,
+                                                              tag);
+    });
+  }
+  if (status.ok()) {
+    status = WriteFile(dir, kContextFile, [&](std::ostream& out) {
+      lbcrypto::Serial::Serialize(ctx.cc, out, binary);
+      return true;
+    });
+  }
+  return status;
+}
+
+// Loads the context and keys in dir, which must have been created for a model
+// whose generated context has the parameters described by params.
+absl::StatusOr<ConfiguredContext> Load(const std::filesystem::path& dir,
+                                       const std::string& params) {
+  std::ifstream fingerprint_in(dir / kFingerprintFile);
+  if (!fingerprint_in) {
+    return absl::FailedPreconditionError(
+        dir.string() +
+        " has no fingerprint; delete the directory to create new keys");
+  }
+  const std::string fingerprint(
+      (std::istreambuf_iterator<char>(fingerprint_in)),
+      std::istreambuf_iterator<char>());
+  if (!absl::StartsWith(fingerprint, params + "\n")) {
+    return absl::FailedPreconditionError(
+        "the keys in " + dir.string() +
+        " were created for other parameters than the compiled model; use "
+        "another key directory");
+  }
+
+  const auto binary = lbcrypto::SerType::BINARY;
+  // Deserialized keys are matched to the contexts already known to OpenFHE,
+  // so start from a clean slate.
+  CryptoContextImplT::ClearEvalMultKeys();
+  CryptoContextImplT::ClearEvalAutomorphismKeys();
+  lbcrypto::CryptoContextFactory<lbcrypto::DCRTPoly>::ReleaseAllContexts();
+
+  ConfiguredContext ctx;
+  ctx.loaded = true;
+  if (!lbcrypto::Serial::DeserializeFromFile((dir / kContextFile).string(),
+                                             ctx.cc, binary) ||
+      !lbcrypto::Serial::DeserializeFromFile((dir / kPublicKeyFile).string(),
+                                             ctx.keys.publicKey, binary) ||
+      !lbcrypto::Serial::DeserializeFromFile((dir / kSecretKeyFile).string(),
+                                             ctx.keys.secretKey, binary)) {
+    return absl::DataLossError("cannot read the context and key pair in " +
+                               dir.string());
+  }
+  std::ifstream mult_keys(dir / kEvalMultKeyFile, std::ios::binary);
+  if (!mult_keys ||
+      !CryptoContextImplT::DeserializeEvalMultKey(mult_keys, binary)) {
+    return absl::DataLossError("cannot read " +
+                               (dir / kEvalMultKeyFile).string());
+  }
+  std::ifstream rotation_keys(dir / kRotationKeyFile, std::ios::binary);
+  if (!rotation_keys ||
+      !CryptoContextImplT::DeserializeEvalAutomorphismKey(rotation_keys,
+                                                          binary)) {
+    return absl::DataLossError("cannot read " +
+                               (dir / kRotationKeyFile).string());
+  }
+  const std::string rotations =
+      RotationFingerprint(ctx.keys.secretKey->GetKeyTag());
+  if (fingerprint != absl::StrCat(params, "\n", rotations, "\n")) {
+    return absl::DataLossError("the rotation keys in " + dir.string() +
+                               " do not match its fingerprint; delete the "
+                               "directory to create new keys");
+  }
+  return ctx;
+}
+
+}  // namespace
+
+absl::StatusOr<ConfiguredContext> Configure(
+    const std::string& dir, const std::function<CryptoContextT()>& generate,
+    const std::function<CryptoContextT(CryptoContextT, PrivateKeyT)>&
+        configure) {
+  if (!dir.empty() && std::filesystem::exists(
+                          std::filesystem::path(dir) / kContextFile)) {
+    // Generating the context is cheap; only the keys are worth storing.
+    return Load(dir, ParamsFingerprint(generate()));
+  }
+  ConfiguredContext ctx;
+  ctx.cc = generate();
+  ctx.keys = ctx.cc->KeyGen();
+  ctx.cc = configure(ctx.cc, ctx.keys.secretKey);
+  if (!dir.empty()) {
+    if (absl::Status status = Save(dir, ctx); !status.ok()) return status;
+  }
+  return ctx;
+}
+
+EvalKeyFootprint MeasureEvalKeys(const KeyPairT& keys) {
+  const std::string& tag = keys.secretKey->GetKeyTag();
+  const auto binary = lbcrypto::SerType::BINARY;
+  EvalKeyFootprint footprint;
+
+  CountingBuffer mult_buf;
+  std::ostream mult_out(&mult_buf);
+  CryptoContextImplT::SerializeEvalMultKey(mult_out, binary, tag);
+  footprint.eval_mult_key_bytes = mult_buf.count();
+
+  CountingBuffer rotation_buf;
+  std::ostream rotation_out(&rotation_buf);
+  CryptoContextImplT::SerializeEvalAutomorphismKey(rotation_out, binary, tag);
+  footprint.rotation_key_bytes = rotation_buf.count();
+
+  const auto& rotation_keys = CryptoContextImplT::GetAllEvalAutomorphismKeys();
+  if (auto it = rotation_keys.find(tag); it != rotation_keys.end()) {
+    footprint.rotation_keys = static_cast<int64_t>(it->second->size());
+  }
+  return footprint;
+}
+
+int64_t PeakRssBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+  return static_cast<int64_t>(usage.ru_maxrss) * 1024;  // KiB on Linux
+}
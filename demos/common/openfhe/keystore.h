@@ -0,0 +1,60 @@
+#ifndef THIRD_PARTY_FULLY_HOMOMORPHIC_ENCRYPTION_DEMOS_COMMON_OPENFHE_KEYSTORE_H_
+#define THIRD_PARTY_FULLY_HOMOMORPHIC_ENCRYPTION_DEMOS_COMMON_OPENFHE_KEYSTORE_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "src/core/include/lattice/hal/lat-backend.h"
+#include "src/pke/include/cryptocontext-fwd.h"
+#include "src/pke/include/key/keypair.h"
+#include "src/pke/include/key/privatekey-fwd.h"
+
+using CryptoContextT = lbcrypto::CryptoContext<lbcrypto::DCRTPoly>;
+using KeyPairT = lbcrypto::KeyPair<lbcrypto::DCRTPoly>;
+using PrivateKeyT = lbcrypto::PrivateKey<lbcrypto::DCRTPoly>;
+
+// A configured context and the key pair its evaluation keys belong to.
+struct ConfiguredContext {
+  CryptoContextT cc;
+  KeyPairT keys;
+  // Whether the context and keys were read from a key directory rather than
+  // generated.
+  bool loaded = false;
+};
+
+// Configures a context with the generated functions of a model, the OpenFHE
+// counterpart of the Lattigo keystore. With an empty dir it calls generate,
+// KeyGen and configure. Otherwise it loads the context, the key pair and the
+// relinearization and rotation keys stored in dir, creating them on the first
+// run. The directory holds the secret key.
+//
+// The generated configure functions only create the rotation keys for the
+// indices the compiled program rotates by, plus the bootstrapping keys if it
+// bootstraps, so the stored keys are exactly those the model needs.
+//
+// The directory also holds a fingerprint of the context parameters and of the
+// stored rotation indices. Loading fails if generate now returns a context
+// with other parameters, or if the stored keys do not match the fingerprint.
+absl::StatusOr<ConfiguredContext> Configure(
+    const std::string& dir, const std::function<CryptoContextT()>& generate,
+    const std::function<CryptoContextT(CryptoContextT, PrivateKeyT)>&
+        configure);
+
+// Sizes of the evaluation keys generated for a key pair.
+struct EvalKeyFootprint {
+  int64_t eval_mult_key_bytes = 0;
+  int64_t rotation_keys = 0;
+  int64_t rotation_key_bytes = 0;
+};
+
+// Measures the evaluation keys of keys by their serialized size, which is
+// close to the memory they take in RNS form. The keys are serialized into a
+// counting stream, so the measurement does not need a second copy of them.
+EvalKeyFootprint MeasureEvalKeys(const KeyPairT& keys);
+
+// Returns the peak resident set size of the process so far, in bytes.
+int64_t PeakRssBytes();
+
+#endif  // THIRD_PARTY_FULLY_HOMOMORPHIC_ENCRYPTION_DEMOS_COMMON_OPENFHE_KEYSTORE_H_
@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -15,15 +16,31 @@ thread_local static std::chrono::high_resolution_clock::time_point g_last_time;
 thread_local static std::chrono::high_resolution_clock::time_point g_start_time;
 thread_local static bool g_started = false;
 
-void __heir_debug(CryptoContextT cc, PrivateKeyT sk, CiphertextT ct,
-                  const std::map<std::string, std::string>& debugAttrMap) {
-  std::string op_name = "unknown";
+// Prints the level and scale of ct in the format of the Lattigo timing
+// helper, so that the logs of both backends can be aligned. The level is the
+// number of remaining RNS towers minus one, as in Lattigo.
+static void PrintLevel(const std::string& name, const CiphertextT& ct) {
+  const int level =
+      static_cast<int>(ct->GetElements()[0].GetNumOfElements()) - 1;
+  const double scale = ct->GetScalingFactor();
+  std::ostringstream line;
+  line << "[DEBUG]   " << name << " -> level: " << level << ", scale: 2^"
+       << std::fixed << std::setprecision(2) << std::log2(scale) << " ("
+       << std::defaultfloat << scale << ")";
+  std::cout << line.str() << std::endl;
+}
+
+static std::string OpName(
+    const std::map<std::string, std::string>& debugAttrMap) {
   if (debugAttrMap.find("debug.name") != debugAttrMap.end()) {
-    op_name = debugAttrMap.at("debug.name");
+    return debugAttrMap.at("debug.name");
   } else if (debugAttrMap.find("asm.op_name") != debugAttrMap.end()) {
-    op_name = debugAttrMap.at("asm.op_name");
+    return debugAttrMap.at("asm.op_name");
   }
+  return "unknown";
+}
 
+static void RecordTiming(CryptoContextT cc, const std::string& op_name) {
   auto now = std::chrono::high_resolution_clock::now();
 
   if (!g_started || op_name == "input") {
@@ -60,10 +77,22 @@ void __heir_debug(CryptoContextT cc, PrivateKeyT sk, CiphertextT ct,
   }
 }
 
+void __heir_debug(CryptoContextT cc, PrivateKeyT sk, CiphertextT ct,
+                  const std::map<std::string, std::string>& debugAttrMap) {
+  const std::string op_name = OpName(debugAttrMap);
+  RecordTiming(cc, op_name);
+  PrintLevel(op_name, ct);
+}
+
 void __heir_debug(CryptoContextT cc, PrivateKeyT sk,
                   std::vector<CiphertextT> cts,
                   const std::map<std::string, std::string>& debugAttrMap) {
-  if (!cts.empty()) {
-    __heir_debug(cc, sk, cts[0], debugAttrMap);
+  if (cts.empty()) {
+    return;
+  }
+  const std::string op_name = OpName(debugAttrMap);
+  RecordTiming(cc, op_name);
+  for (size_t i = 0; i < cts.size(); ++i) {
+    PrintLevel(op_name + "[" + std::to_string(i) + "]", cts[i]);
   }
 }
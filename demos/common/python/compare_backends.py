@@ -0,0 +1,193 @@
+"""Runs a model on both FHE backends and prints a side-by-side comparison.
+
+For every core count, the Lattigo and OpenFHE suites of the model run on the
+same rows, restricted to the same CPUs, and each writes a suite report (see
+suite_report.py). Lattigo uses one goroutine per core for every phase; OpenFHE
+evaluates the rows one after another with one OpenMP thread per core. Peak
+memory is measured from the outside for both, and the OpenFHE evaluation key
+size is read from the model's Google Benchmark binary, for the models that
+have one.
+"""
+
+import argparse
+import dataclasses
+import json
+import os
+import statistics
+import sys
+import tempfile
+
+from demos.common.python import path_utils
+from demos.common.python import suite_runner
+
+resolve_path = path_utils.resolve_path
+
+
+@dataclasses.dataclass
+class ModelSpec:
+  """How to run the suites of one model on a given number of rows."""
+
+  lattigo_suite: str
+  openfhe_suite: str
+  lattigo_rows_flag: str
+  openfhe_rows_flag: str
+  openfhe_benchmark: str | None = None
+  # Flags passed to both suites, so that they read the same data.
+  suite_args: tuple[str, ...] = ()
+
+
+MODELS = {
+    "cc_fraud": ModelSpec(
+        lattigo_suite="fully_homomorphic_encryption/demos/cc_fraud/lattigo/evaluate_fhe_suite_/evaluate_fhe_suite",
+        openfhe_suite="fully_homomorphic_encryption/demos/cc_fraud/openfhe/evaluate_fhe_suite",
+        openfhe_benchmark="fully_homomorphic_encryption/demos/cc_fraud/openfhe/benchmark",
+        lattigo_rows_flag="-limit",
+        openfhe_rows_flag="--limit",
+    ),
+    "mnist": ModelSpec(
+        lattigo_suite="fully_homomorphic_encryption/demos/mnist/lattigo/evaluate_fhe_suite_/evaluate_fhe_suite",
+        openfhe_suite="fully_homomorphic_encryption/demos/mnist/openfhe/evaluate_fhe_suite",
+        openfhe_benchmark="fully_homomorphic_encryption/demos/mnist/openfhe/benchmark",
+        lattigo_rows_flag="-num_samples",
+        openfhe_rows_flag="--num_samples",
+    ),
+    "network_anomaly": ModelSpec(
+        lattigo_suite="fully_homomorphic_encryption/demos/network_anomaly/lattigo/evaluate_fhe_suite_/evaluate_fhe_suite",
+        openfhe_suite="fully_homomorphic_encryption/demos/network_anomaly/openfhe/evaluate_fhe_suite",
+        lattigo_rows_flag="-num_samples",
+        openfhe_rows_flag="--num_samples",
+    ),
+    "hotword": ModelSpec(
+        lattigo_suite="fully_homomorphic_encryption/demos/hotword/lattigo/evaluate_fhe_suite_/evaluate_fhe_suite",
+        openfhe_suite="fully_homomorphic_encryption/demos/hotword/openfhe/evaluate_fhe_suite",
+        lattigo_rows_flag="-limit",
+        openfhe_rows_flag="--limit",
+        suite_args=("--npz_path=demos/hotword/data/test_data-small.npz",),
+    ),
+}
+
+
+def openfhe_eval_key_bytes(spec, tmp_dir):
+  """Reads the evaluation key size from the OpenFHE benchmark binary.
+
+  Returns zero, which the report treats as unknown, if the model has no
+  benchmark binary.
+  """
+  if spec.openfhe_benchmark is None:
+    return 0
+  cmd = [
+      resolve_path(spec.openfhe_benchmark),
+      "--benchmark_filter=^BM_ConfigureCryptoContext/threads:1/",
+      "--benchmark_min_time=1x",
+      "--benchmark_format=json",
+  ]
+  out_path = os.path.join(tmp_dir, "openfhe_benchmark.json")
+  suite_runner.run(
+      cmd + [f"--benchmark_out={out_path}"], 1, out_path + ".log"
+  )
+  with open(out_path) as f:
+    benchmarks = json.load(f)["benchmarks"]
+  return int(benchmarks[0]["eval_key_bytes"]) if benchmarks else 0
+
+
+def run_backend(spec, backend, rows, cores, tmp_dir):
+  report_path = os.path.join(tmp_dir, f"{backend}_{cores}.json")
+  if backend == "lattigo":
+    binary, rows_flag = spec.lattigo_suite, spec.lattigo_rows_flag
+  else:
+    binary, rows_flag = spec.openfhe_suite, spec.openfhe_rows_flag
+  print(f"Running {backend} on {cores} core(s)...", file=sys.stderr)
+  return suite_runner.run_suite(
+      resolve_path(binary),
+      backend,
+      rows_flag,
+      rows,
+      cores,
+      report_path,
+      extra_args=spec.suite_args,
+  )
+
+
+def print_comparison(model, results):
+  header = (
+      f"{'cores':>5} {'backend':<8} {'setup s':>8} {'prep s':>8}"
+      f" {'enc s':>8} {'eval s':>8} {'dec s':>8} {'lat ms':>9}"
+      f" {'p50 ms':>9} {'rows/s':>8} {'RSS MiB':>8} {'keys MiB':>9}"
+      f" {'accuracy':>8}"
+  )
+  print(f"\n{model}: {results[0].report.rows} rows per run\n")
+  print(header)
+  print("-" * len(header))
+  for r in results:
+    rep = r.report
+    phases_s = rep.encrypt_s + rep.evaluate_s + rep.decrypt_s
+    lat = rep.eval_latency_s or [0.0]
+    keys_mib = (
+        f"{rep.eval_key_bytes / 2**20:>9.1f}"
+        if rep.eval_key_bytes
+        else f"{'n/a':>9}"
+    )
+    print(
+        f"{r.cores:>5} {rep.backend:<8} {rep.setup_s:>8.2f}"
+        f" {rep.preprocessing_s:>8.2f} {rep.encrypt_s:>8.2f}"
+        f" {rep.evaluate_s:>8.2f} {rep.decrypt_s:>8.2f}"
+        f" {statistics.mean(lat) * 1000:>9.1f}"
+        f" {statistics.median(lat) * 1000:>9.1f}"
+        f" {rep.rows / phases_s if phases_s else 0:>8.2f}"
+        f" {r.peak_rss_bytes / 2**20:>8.0f}"
+        f" {keys_mib}"
+        f" {rep.correct / rep.rows if rep.rows else 0:>8.2%}"
+    )
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument("--model", choices=sorted(MODELS), required=True)
+  parser.add_argument(
+      "--rows", type=int, default=10, help="Number of rows per run"
+  )
+  parser.add_argument(
+      "--cores",
+      type=str,
+      default=None,
+      help="Comma-separated core counts to run at (default: 1 and all)",
+  )
+  parser.add_argument(
+      "--output",
+      type=str,
+      default=None,
+      help="Also write all reports and peak memory to this JSON file",
+  )
+  args = parser.parse_args()
+
+  spec = MODELS[args.model]
+  num_cpus = len(suite_runner.available_cpus())
+  if args.cores:
+    core_counts = [int(c) for c in args.cores.split(",")]
+  else:
+    core_counts = sorted({1, num_cpus})
+
+  # Kept after the run, for the suite logs.
+  tmp_dir = tempfile.mkdtemp(prefix=f"compare_backends_{args.model}_")
+  print(f"Writing reports and logs to {tmp_dir}", file=sys.stderr)
+  key_bytes = openfhe_eval_key_bytes(spec, tmp_dir)
+  results = []
+  for cores in core_counts:
+    for backend in ("lattigo", "openfhe"):
+      result = run_backend(spec, backend, args.rows, cores, tmp_dir)
+      if backend == "openfhe":
+        result.report.eval_key_bytes = key_bytes
+      results.append(result)
+
+  print_comparison(args.model, results)
+
+  if args.output:
+    path = args.output
+    if not os.path.isabs(path) and "BUILD_WORKING_DIRECTORY" in os.environ:
+      path = os.path.join(os.environ["BUILD_WORKING_DIRECTORY"], path)
+    with open(path, "w") as f:
+      json.dump([dataclasses.asdict(r) for r in results], f, indent=2)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,218 @@
+"""Benchmarks the CKKS parameter variants of a model and their Pareto frontier.
+
+This is the runner of the param_sweep macros (demos/common/bazel/
+param_sweep.bzl). Each variant is one point of a grid of compilation options,
+built into its own suite binary, and is passed here as
+
+  --variant=NAME:OPTIONS:RLOCATION_PATH[:PYTHON_MODULE]
+
+where OPTIONS are the comma-separated --torch-linalg-to-ckks options the
+variant overrides. Every variant runs the model's suite on the same rows and
+CPUs. The runner reports the mean and median evaluation latency, the peak RSS,
+the evaluation key size and the accuracy of each, and marks the variants on
+the Pareto frontier: those that no other variant beats on latency, memory and
+accuracy at once.
+"""
+
+import argparse
+import dataclasses
+import json
+import os
+import statistics
+import sys
+import tempfile
+
+from demos.common.python import path_utils
+from demos.common.python import suite_runner
+
+
+@dataclasses.dataclass
+class Variant:
+  name: str
+  options: str
+  binary: str
+  module: str | None = None
+
+
+@dataclasses.dataclass
+class Outcome:
+  """Measurements of one variant, or the reason it failed."""
+
+  variant: Variant
+  latency_s: float = 0.0
+  p50_latency_s: float = 0.0
+  peak_rss_bytes: int = 0
+  eval_key_bytes: int = 0
+  accuracy: float = 0.0
+  error: str | None = None
+
+
+def parse_variant(value):
+  parts = value.split(":")
+  if len(parts) not in (3, 4):
+    raise argparse.ArgumentTypeError(f"malformed variant {value!r}")
+  return Variant(*parts)
+
+
+def measure(variant, backend, rows_flag, rows, cores, tmp_dir):
+  """Runs the suite of variant and returns its outcome."""
+  report_path = os.path.join(tmp_dir, f"{variant.name}.json")
+  extra_args = []
+  if variant.module:
+    extra_args.append(f"--model_module={variant.module}")
+  try:
+    result = suite_runner.run_suite(
+        path_utils.resolve_path(variant.binary),
+        backend,
+        rows_flag,
+        rows,
+        cores,
+        report_path,
+        extra_args,
+    )
+  except RuntimeError as e:
+    return Outcome(variant, error=str(e))
+  report = result.report
+  latencies = report.eval_latency_s or [0.0]
+  return Outcome(
+      variant,
+      latency_s=statistics.mean(latencies),
+      p50_latency_s=statistics.median(latencies),
+      peak_rss_bytes=result.peak_rss_bytes,
+      eval_key_bytes=report.eval_key_bytes,
+      accuracy=report.correct / report.rows if report.rows else 0.0,
+  )
+
+
+def dominates(a, b):
+  """Whether a is at least as good as b on every objective and better on one."""
+  at_least = (
+      a.latency_s <= b.latency_s
+      and a.peak_rss_bytes <= b.peak_rss_bytes
+      and a.accuracy >= b.accuracy
+  )
+  better = (
+      a.latency_s < b.latency_s
+      or a.peak_rss_bytes < b.peak_rss_bytes
+      or a.accuracy > b.accuracy
+  )
+  return at_least and better
+
+
+def pareto_frontier(outcomes):
+  """Returns the successful outcomes that no other outcome dominates."""
+  ok = [o for o in outcomes if o.error is None]
+  return [o for o in ok if not any(dominates(other, o) for other in ok)]
+
+
+def print_outcomes(model, backend, rows, outcomes, frontier):
+  header = (
+      f"  {'variant':<28} {'lat ms':>9} {'p50 ms':>9} {'RSS MiB':>8}"
+      f" {'keys MiB':>9} {'accuracy':>8}"
+  )
+  print(
+      f"\n{model} ({backend}): {rows} rows per variant,"
+      " * marks the Pareto frontier\n"
+  )
+  print(header)
+  print("-" * len(header))
+  ok = sorted(
+      (o for o in outcomes if o.error is None), key=lambda o: o.latency_s
+  )
+  for o in ok:
+    mark = "*" if o in frontier else " "
+    print(
+        f"{mark} {o.variant.name:<28} {o.latency_s * 1000:>9.1f}"
+        f" {o.p50_latency_s * 1000:>9.1f} {o.peak_rss_bytes / 2**20:>8.0f}"
+        f" {o.eval_key_bytes / 2**20:>9.1f} {o.accuracy:>8.2%}"
+    )
+  for o in outcomes:
+    if o.error is not None:
+      print(f"  {o.variant.name:<28} failed: {o.error}")
+  print("\nOptions of the frontier variants:")
+  for o in frontier:
+    print(f"  {o.variant.name}: {o.variant.options}")
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument("--model", required=True)
+  parser.add_argument(
+      "--backend", choices=("lattigo", "openfhe"), required=True
+  )
+  parser.add_argument(
+      "--rows_flag",
+      required=True,
+      help="Flag of the suite binaries that limits the number of rows",
+  )
+  parser.add_argument(
+      "--variant",
+      type=parse_variant,
+      action="append",
+      default=[],
+      help="NAME:OPTIONS:RLOCATION_PATH[:PYTHON_MODULE], set by the macro",
+  )
+  parser.add_argument(
+      "--rows", type=int, default=10, help="Number of rows per variant"
+  )
+  parser.add_argument(
+      "--cores",
+      type=int,
+      default=None,
+      help="Number of cores to run the suites on (default: all)",
+  )
+  parser.add_argument(
+      "--min_accuracy",
+      type=float,
+      default=None,
+      help="Also print the fastest variant with at least this accuracy",
+  )
+  parser.add_argument(
+      "--output",
+      type=str,
+      default=None,
+      help="Also write all outcomes to this JSON file",
+  )
+  args = parser.parse_args()
+
+  cores = args.cores or len(suite_runner.available_cpus())
+  # Kept after the run, for the suite logs.
+  tmp_dir = tempfile.mkdtemp(prefix=f"param_sweep_{args.model}_")
+  print(f"Writing reports and logs to {tmp_dir}", file=sys.stderr)
+  outcomes = []
+  for i, variant in enumerate(args.variant):
+    print(
+        f"[{i + 1}/{len(args.variant)}] Running {variant.name}"
+        f" ({variant.options})...",
+        file=sys.stderr,
+    )
+    outcome = measure(
+        variant, args.backend, args.rows_flag, args.rows, cores, tmp_dir
+    )
+    outcomes.append(outcome)
+
+  frontier = pareto_frontier(outcomes)
+  print_outcomes(args.model, args.backend, args.rows, outcomes, frontier)
+
+  if args.min_accuracy is not None:
+    eligible = [o for o in frontier if o.accuracy >= args.min_accuracy]
+    if eligible:
+      best = min(eligible, key=lambda o: o.latency_s)
+      print(
+          f"\nFastest variant with accuracy >= {args.min_accuracy:.2%}:"
+          f" {best.variant.name} ({best.latency_s * 1000:.1f} ms,"
+          f" {best.variant.options})"
+      )
+    else:
+      print(f"\nNo variant reaches accuracy {args.min_accuracy:.2%}")
+
+  if args.output:
+    path = args.output
+    if not os.path.isabs(path) and "BUILD_WORKING_DIRECTORY" in os.environ:
+      path = os.path.join(os.environ["BUILD_WORKING_DIRECTORY"], path)
+    with open(path, "w") as f:
+      json.dump([dataclasses.asdict(o) for o in outcomes], f, indent=2)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,48 @@
+"""Tests for the Pareto frontier of the parameter sweep."""
+
+from absl.testing import absltest
+from demos.common.python import param_sweep
+
+
+def _outcome(name, latency_s, peak_rss_bytes, accuracy, error=None):
+  return param_sweep.Outcome(
+      param_sweep.Variant(name, "", ""),
+      latency_s=latency_s,
+      peak_rss_bytes=peak_rss_bytes,
+      accuracy=accuracy,
+      error=error,
+  )
+
+
+class ParamSweepTest(absltest.TestCase):
+
+  def test_parse_variant(self):
+    variant = param_sweep.parse_variant(
+        "glb12:greedy-level-budget=12:_main/demos/x/sweep_glb12:demos.x.m"
+    )
+    self.assertEqual(variant.name, "glb12")
+    self.assertEqual(variant.options, "greedy-level-budget=12")
+    self.assertEqual(variant.binary, "_main/demos/x/sweep_glb12")
+    self.assertEqual(variant.module, "demos.x.m")
+
+  def test_pareto_frontier(self):
+    fast = _outcome("fast", 1.0, 200, 0.8)
+    small = _outcome("small", 2.0, 100, 0.8)
+    accurate = _outcome("accurate", 3.0, 300, 1.0)
+    dominated = _outcome("dominated", 2.5, 250, 0.8)
+    failed = _outcome("failed", 0.0, 0, 0.0, error="crashed")
+    frontier = param_sweep.pareto_frontier(
+        [fast, small, accurate, dominated, failed]
+    )
+    self.assertEqual(
+        [o.variant.name for o in frontier], ["fast", "small", "accurate"]
+    )
+
+  def test_ties_stay_on_frontier(self):
+    a = _outcome("a", 1.0, 100, 1.0)
+    b = _outcome("b", 1.0, 100, 1.0)
+    self.assertLen(param_sweep.pareto_frontier([a, b]), 2)
+
+
+if __name__ == "__main__":
+  absltest.main()
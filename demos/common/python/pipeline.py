@@ -0,0 +1,143 @@
+"""Runs encrypt, evaluate and decrypt as concurrent stages with bounded queues.
+
+Instead of encrypting every sample, then evaluating every sample, then
+decrypting every sample, the pipeline keeps at most a bounded number of samples
+in flight, so peak memory depends on the queue depth rather than on the dataset
+size, and the first result is available after a single sample went through all
+three stages.
+
+Each stage runs on its own pool of threads. Stages only overlap in time while
+the extension module releases the GIL; OpenFHE parallelizes inside each
+operation with OpenMP either way.
+"""
+
+import dataclasses
+import queue
+import threading
+import time
+
+_DONE = object()
+
+
+@dataclasses.dataclass
+class PipelineStats:
+  first_result_s: float = 0.0
+  total_s: float = 0.0
+  max_in_flight: int = 0
+
+
+class _Failure:
+
+  def __init__(self, error):
+    self.error = error
+
+
+def _start_stage(fn, num_workers, in_queue, out_queue):
+  """Starts num_workers threads applying fn(idx, value) to in_queue items."""
+  lock = threading.Lock()
+  remaining = [num_workers]
+
+  def worker():
+    while True:
+      item = in_queue.get()
+      if item is _DONE:
+        # Leave the marker for the sibling workers of this stage.
+        in_queue.put(_DONE)
+        break
+      idx, value = item
+      if not isinstance(value, _Failure):
+        try:
+          value = fn(idx, value)
+        except Exception as e:  # pylint: disable=broad-except
+          value = _Failure(e)
+      out_queue.put((idx, value))
+    with lock:
+      remaining[0] -= 1
+      last = remaining[0] == 0
+    if last:
+      out_queue.put(_DONE)
+
+  for _ in range(num_workers):
+    threading.Thread(target=worker, daemon=True).start()
+
+
+def run_pipeline(
+    num_items,
+    encrypt,
+    evaluate,
+    decrypt,
+    on_result,
+    encrypt_workers=1,
+    evaluate_workers=1,
+    decrypt_workers=1,
+    queue_depth=2,
+):
+  """Feeds items 0..num_items-1 through the encrypt/evaluate/decrypt stages.
+
+  Args:
+    num_items: Number of samples to process.
+    encrypt: Callable taking a sample index and returning its ciphertexts.
+    evaluate: Callable taking (index, ciphertexts) and returning the encrypted
+      output.
+    decrypt: Callable taking (index, encrypted output) and returning the
+      decrypted result.
+    on_result: Callable taking (index, result), called on the calling thread
+      for every result in completion order.
+    encrypt_workers: Number of encryption threads.
+    evaluate_workers: Number of evaluation threads.
+    decrypt_workers: Number of decryption threads.
+    queue_depth: Maximum number of samples waiting between two stages.
+
+  Returns:
+    A PipelineStats with the time to the first result, the total wall time and
+    the maximum number of samples in flight.
+
+  Raises:
+    ValueError: if a stage has fewer than one worker.
+  """
+  for stage, workers in (
+      ("encrypt", encrypt_workers),
+      ("evaluate", evaluate_workers),
+      ("decrypt", decrypt_workers),
+  ):
+    if workers < 1:
+      raise ValueError(f"{stage}_workers must be at least 1, got {workers}")
+  depth = max(1, queue_depth)
+  indices = queue.Queue(maxsize=1)
+  encrypted = queue.Queue(maxsize=depth)
+  evaluated = queue.Queue(maxsize=depth)
+  results = queue.Queue(maxsize=depth)
+
+  stats = PipelineStats()
+  lock = threading.Lock()
+  in_flight = [0]
+
+  def feed():
+    for idx in range(num_items):
+      with lock:
+        in_flight[0] += 1
+        stats.max_in_flight = max(stats.max_in_flight, in_flight[0])
+      indices.put((idx, None))
+    indices.put(_DONE)
+
+  start = time.perf_counter()
+  threading.Thread(target=feed, daemon=True).start()
+  _start_stage(lambda idx, _: encrypt(idx), encrypt_workers, indices, encrypted)
+  _start_stage(evaluate, evaluate_workers, encrypted, evaluated)
+  _start_stage(decrypt, decrypt_workers, evaluated, results)
+
+  while True:
+    item = results.get()
+    if item is _DONE:
+      break
+    idx, value = item
+    if isinstance(value, _Failure):
+      raise RuntimeError(f"Pipeline failed on sample {idx}") from value.error
+    if not stats.first_result_s:
+      stats.first_result_s = time.perf_counter() - start
+    on_result(idx, value)
+    with lock:
+      in_flight[0] -= 1
+
+  stats.total_s = time.perf_counter() - start
+  return stats
@@ -0,0 +1,75 @@
+"""Tests for the encrypt/evaluate/decrypt pipeline."""
+
+import time
+
+from absl.testing import absltest
+from demos.common.python import pipeline
+
+
+def _run(num_items, workers=1, queue_depth=2, evaluate=None):
+  results = []
+  stats = pipeline.run_pipeline(
+      num_items,
+      encrypt=lambda idx: idx * 10,
+      evaluate=evaluate or (lambda idx, ct: ct + 1),
+      decrypt=lambda idx, ct: ct * 2,
+      on_result=lambda idx, value: results.append((idx, value)),
+      encrypt_workers=workers,
+      evaluate_workers=workers,
+      decrypt_workers=workers,
+      queue_depth=queue_depth,
+  )
+  return results, stats
+
+
+class PipelineTest(absltest.TestCase):
+
+  def test_single_workers_keep_order(self):
+    results, stats = _run(20)
+    self.assertEqual(results, [(i, (i * 10 + 1) * 2) for i in range(20)])
+    self.assertGreater(stats.total_s, 0)
+    self.assertGreaterEqual(stats.total_s, stats.first_result_s)
+
+  def test_many_workers_deliver_every_item_once(self):
+    results, _ = _run(50, workers=4)
+    self.assertEqual(
+        sorted(results), [(i, (i * 10 + 1) * 2) for i in range(50)]
+    )
+
+  def test_max_in_flight_is_bounded(self):
+    queue_depth = 2
+
+    # A slow evaluation lets the feeder fill the queues in front of it.
+    def evaluate(idx, ct):
+      time.sleep(0.01)
+      return ct
+
+    results, stats = _run(50, queue_depth=queue_depth, evaluate=evaluate)
+    self.assertLen(results, 50)
+    # One sample per worker and per queue slot, plus the slot of the index
+    # queue, the one being fed and the one being reported.
+    bound = 3 * 1 + 3 * queue_depth + 3
+    self.assertBetween(stats.max_in_flight, 2, bound)
+
+  def test_no_items(self):
+    results, stats = _run(0)
+    self.assertEqual(results, [])
+    self.assertEqual(stats.max_in_flight, 0)
+
+  def test_stage_failure_stops_the_pipeline(self):
+    def evaluate(idx, ct):
+      if idx == 3:
+        raise ValueError("boom")
+      return ct
+
+    with self.assertRaisesRegex(RuntimeError, "sample 3"):
+      _run(10, evaluate=evaluate)
+
+  def test_rejects_stages_without_workers(self):
+    for workers in (0, -1):
+      with self.assertRaisesRegex(ValueError, "at least 1"):
+        _run(5, workers=workers)
+
+
+if __name__ == "__main__":
+  absltest.main()
@@ -0,0 +1,74 @@
+"""Backend-independent summary of an evaluation suite run.
+
+The OpenFHE suites write it with --report and compare_backends reads it. The
+format matches demos/common/go/suitereport, which the Lattigo suites use.
+"""
+
+import dataclasses
+import json
+import threading
+
+
+@dataclasses.dataclass
+class SuiteReport:
+  """Phase times in seconds and the suite outcome.
+
+  Each phase time is the wall time during which at least one row was in that
+  phase, whether the rows run one after another or as a pipeline. Suites
+  record it with record_phase. setup_s covers context creation, key
+  generation and configuration.
+  eval_latency_s holds the evaluation time of every row, in row order.
+  eval_key_bytes is the serialized size of the relinearization and rotation
+  keys, or zero if unknown.
+  """
+
+  model: str
+  backend: str
+  rows: int
+  correct: int = 0
+  setup_s: float = 0.0
+  preprocessing_s: float = 0.0
+  encrypt_s: float = 0.0
+  evaluate_s: float = 0.0
+  decrypt_s: float = 0.0
+  eval_latency_s: list[float] = dataclasses.field(default_factory=list)
+  eval_key_bytes: int = 0
+
+  def __post_init__(self):
+    if not self.eval_latency_s:
+      self.eval_latency_s = [0.0] * self.rows
+    self._lock = threading.Lock()
+    self._intervals = {"encrypt": [], "evaluate": [], "decrypt": []}
+
+  def record_phase(self, phase, start, end):
+    """Records that one row was in phase ("encrypt", "evaluate" or "decrypt")
+    from start to end, perf_counter seconds. Safe to call from any thread."""
+    with self._lock:
+      intervals = self._intervals[phase]
+      intervals.append((start, end))
+      setattr(self, phase + "_s", union_length(intervals))
+
+  def write(self, path):
+    """Writes the report to path as JSON; a no-op for an empty path."""
+    if not path:
+      return
+    with open(path, "w") as f:
+      json.dump(dataclasses.asdict(self), f, indent=2)
+      f.write("\n")
+
+
+def union_length(intervals):
+  """Returns the total length covered by (start, end) intervals."""
+  total = 0.0
+  covered_until = float("-inf")
+  for start, end in sorted(intervals):
+    if end > covered_until:
+      total += end - max(start, covered_until)
+      covered_until = end
+  return total
+
+
+def read(path):
+  """Reads a report written by either backend."""
+  with open(path) as f:
+    return SuiteReport(**json.load(f))
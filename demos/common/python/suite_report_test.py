@@ -0,0 +1,41 @@
+"""Tests for the phase times of the suite report."""
+
+import threading
+
+from absl.testing import absltest
+from demos.common.python import suite_report
+
+
+class SuiteReportTest(absltest.TestCase):
+
+  def test_union_length(self):
+    self.assertEqual(suite_report.union_length([]), 0.0)
+    self.assertEqual(suite_report.union_length([(0, 1), (2, 4)]), 3.0)
+    self.assertEqual(suite_report.union_length([(2, 5), (0, 3), (1, 2)]), 5.0)
+
+  def test_sequential_rows_add_up(self):
+    report = suite_report.SuiteReport("m", "openfhe", 2)
+    report.record_phase("encrypt", 0.0, 1.0)
+    report.record_phase("evaluate", 1.0, 3.0)
+    report.record_phase("encrypt", 3.0, 4.0)
+    self.assertEqual(report.encrypt_s, 2.0)
+    self.assertEqual(report.evaluate_s, 2.0)
+    self.assertEqual(report.decrypt_s, 0.0)
+
+  def test_concurrent_rows_count_wall_time(self):
+    report = suite_report.SuiteReport("m", "openfhe", 64)
+    threads = [
+        threading.Thread(
+            target=report.record_phase, args=("evaluate", i / 64, 1.0 + i / 64)
+        )
+        for i in range(64)
+    ]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+    self.assertAlmostEqual(report.evaluate_s, 1.0 + 63 / 64)
+
+
+if __name__ == "__main__":
+  absltest.main()
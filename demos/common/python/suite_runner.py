@@ -0,0 +1,78 @@
+"""Runs the evaluation suite of a model and collects its report.
+
+The suites of both backends take a row-limit flag and write a suite report
+(see suite_report.py). Peak memory is measured from the outside, so it covers
+the whole process on either backend.
+"""
+
+import dataclasses
+import os
+import subprocess
+
+from demos.common.python import suite_report
+
+
+@dataclasses.dataclass
+class Result:
+  cores: int
+  report: suite_report.SuiteReport
+  peak_rss_bytes: int
+
+
+def available_cpus():
+  if hasattr(os, "sched_getaffinity"):
+    return sorted(os.sched_getaffinity(0))
+  return list(range(os.cpu_count() or 1))
+
+
+def run(cmd, cores, log_path):
+  """Runs cmd on the first cores CPUs and returns its peak RSS in bytes."""
+  cpus = available_cpus()[:cores]
+  env = dict(os.environ)
+  env["GOMAXPROCS"] = str(cores)
+  env["OMP_NUM_THREADS"] = str(cores)
+
+  def pin():
+    if hasattr(os, "sched_setaffinity"):
+      os.sched_setaffinity(0, cpus)
+
+  with open(log_path, "w") as log:
+    proc = subprocess.Popen(
+        cmd, env=env, stdout=log, stderr=subprocess.STDOUT, preexec_fn=pin
+    )
+    # wait4 rather than Popen.wait, for the resource usage of this child only.
+    _, status, usage = os.wait4(proc.pid, 0)
+    proc.returncode = os.waitstatus_to_exitcode(status)
+  if proc.returncode != 0:
+    raise RuntimeError(
+        f"{cmd[0]} exited with status {proc.returncode}, see {log_path}"
+    )
+  return usage.ru_maxrss * 1024  # KiB on Linux
+
+
+def run_suite(
+    binary, backend, rows_flag, rows, cores, report_path, extra_args=()
+):
+  """Runs a suite binary on rows rows and cores CPUs.
+
+  Lattigo uses one goroutine per core for every phase; OpenFHE evaluates the
+  rows one after another with one OpenMP thread per core. The suite log is
+  written next to report_path.
+  """
+  if backend == "lattigo":
+    cmd = [
+        binary,
+        f"{rows_flag}={rows}",
+        f"-workers={cores}",
+        f"-encrypt_workers={cores}",
+        f"-decrypt_workers={cores}",
+        f"-report={report_path}",
+    ]
+  else:
+    cmd = [
+        binary,
+        f"{rows_flag}={rows}",
+        f"--report={report_path}",
+    ]
+  peak_rss = run(cmd + list(extra_args), cores, report_path + ".log")
+  return Result(cores, suite_report.read(report_path), peak_rss)
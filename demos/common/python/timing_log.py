@@ -0,0 +1,87 @@
+"""Parses and aligns the logs of the HEIR timing builds of both backends.
+
+The Lattigo and OpenFHE timing helpers print one line per debug point,
+
+  [TIMING] After operator: <name> | Section duration: <s> s | ...
+
+followed by the level of the section's result,
+
+  [DEBUG]   <name> -> level: <level>, scale: ...
+
+with one level line per ciphertext (suffixed [i]) for tensors of ciphertexts.
+"""
+
+import dataclasses
+import re
+import statistics
+
+_TIMING_RE = re.compile(
+    r"\[TIMING\] After operator: (\S+)\s*\| Section duration:\s*([0-9.]+)\s*s"
+)
+_LEVEL_RE = re.compile(r"\[DEBUG\]\s+(\S+?)(?:\[\d+\])? -> level: (\d+)")
+
+
+@dataclasses.dataclass
+class Section:
+  """The work between two debug points, named after the op that ends it."""
+
+  name: str
+  seconds: float
+  # The lowest level of the section's result, or None if not printed.
+  level: int | None = None
+
+
+def parse(log):
+  """Returns the sections of a timing log, in execution order."""
+  sections = []
+  for line in log.splitlines():
+    if m := _TIMING_RE.search(line):
+      sections.append(Section(m.group(1), float(m.group(2))))
+    elif (m := _LEVEL_RE.search(line)) and sections:
+      section = sections[-1]
+      if section.name == m.group(1):
+        level = int(m.group(2))
+        section.level = level if section.level is None else min(
+            section.level, level
+        )
+  return sections
+
+
+def median_sections(runs):
+  """Combines the sections of repeated runs into their median durations."""
+  first = runs[0]
+  for run in runs[1:]:
+    if [s.name for s in run] != [s.name for s in first]:
+      raise ValueError("runs have different sections")
+  return [
+      Section(s.name, statistics.median(r[i].seconds for r in runs), s.level)
+      for i, s in enumerate(first)
+  ]
+
+
+@dataclasses.dataclass
+class AlignedSection:
+  name: str
+  a: Section | None
+  b: Section | None
+
+
+def align(a, b):
+  """Pairs the sections of two logs by name and occurrence.
+
+  Sections that only one log has are kept with None for the other, in the
+  order of a, followed by the remaining sections of b.
+  """
+
+  def keyed(sections):
+    seen = {}
+    out = {}
+    for s in sections:
+      n = seen.get(s.name, 0)
+      seen[s.name] = n + 1
+      out[(s.name, n)] = s
+    return out
+
+  keyed_a, keyed_b = keyed(a), keyed(b)
+  keys = list(keyed_a) + [k for k in keyed_b if k not in keyed_a]
+  return [AlignedSection(k[0], keyed_a.get(k), keyed_b.get(k)) for k in keys]
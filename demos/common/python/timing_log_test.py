@@ -0,0 +1,73 @@
+"""Tests for the timing log parser."""
+
+from absl.testing import absltest
+from demos.common.python import timing_log
+
+_LATTIGO_LOG = """\
+[TIMING] Evaluation started at operator: input
+[DEBUG] Moduli Q: [1 2 3] (count: 3)
+[DEBUG]   input -> level: 5, scale: 2^24.00 (1.6777216e+07)
+[TIMING] After operator: layer1_matmul    | Section duration:   0.5000 s | Total elapsed:   0.5000 s
+[DEBUG]   layer1_matmul[0] -> level: 4, scale: 2^24.00 (1.6777216e+07)
+[DEBUG]   layer1_matmul[1] -> level: 3, scale: 2^24.00 (1.6777216e+07)
+[TIMING] After operator: layer1_sigmoid   | Section duration:   1.2500 s | Total elapsed:   1.7500 s
+[DEBUG]   layer1_sigmoid -> level: 1, scale: 2^24.00 (1.6777216e+07)
+"""
+
+_OPENFHE_LOG = """\
+[TIMING] Evaluation started at operator: input
+[DEBUG]   input -> level: 5, scale: 2^24.00 (16777216)
+[TIMING] After operator: layer1_matmul    | Section duration: 0.2500   s | Total elapsed: 0.2500   s
+[DEBUG]   layer1_matmul -> level: 4, scale: 2^24.00 (16777216)
+[TIMING] After operator: layer1_bias      | Section duration: 0.0100   s | Total elapsed: 0.2600   s
+"""
+
+
+class TimingLogTest(absltest.TestCase):
+
+  def test_parse(self):
+    sections = timing_log.parse(_LATTIGO_LOG)
+    self.assertEqual(
+        sections,
+        [
+            timing_log.Section("layer1_matmul", 0.5, 3),
+            timing_log.Section("layer1_sigmoid", 1.25, 1),
+        ],
+    )
+
+  def test_parse_openfhe(self):
+    sections = timing_log.parse(_OPENFHE_LOG)
+    self.assertEqual(
+        sections,
+        [
+            timing_log.Section("layer1_matmul", 0.25, 4),
+            timing_log.Section("layer1_bias", 0.01, None),
+        ],
+    )
+
+  def test_align(self):
+    aligned = timing_log.align(
+        timing_log.parse(_LATTIGO_LOG), timing_log.parse(_OPENFHE_LOG)
+    )
+    self.assertEqual(
+        [(s.name, s.a is not None, s.b is not None) for s in aligned],
+        [
+            ("layer1_matmul", True, True),
+            ("layer1_sigmoid", True, False),
+            ("layer1_bias", False, True),
+        ],
+    )
+
+  def test_median_sections(self):
+    runs = [
+        [timing_log.Section("a", 1.0, 2)],
+        [timing_log.Section("a", 3.0, 2)],
+        [timing_log.Section("a", 2.0, 2)],
+    ]
+    self.assertEqual(
+        timing_log.median_sections(runs), [timing_log.Section("a", 2.0, 2)]
+    )
+
+
+if __name__ == "__main__":
+  absltest.main()
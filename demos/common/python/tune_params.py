@@ -0,0 +1,535 @@
+"""Finds the fastest CKKS parameters that keep a model as accurate as cleartext.
+
+The --torch-linalg-to-ckks options of a model (level budget, modulus bit
+sizes, slot count) are tuned by hand today. This tool searches them instead:
+
+  bazel run //demos/common/python:tune_params -- \
+      --model=cc_fraud --backend=lattigo --rows=200
+
+Starting from the options of the model's BUILD file, it changes one option at
+a time to the next value of the search space and keeps the change if the
+variant is faster and still meets the accuracy target, until no single change
+helps. The target is the cleartext suite of the model, run on the same rows:
+a variant may misclassify at most --max_extra_errors more rows than it.
+
+Each candidate is a point of a heir_*_param_sweep call in a generated package,
+--work_dir, built with `bazel build -c opt` and run like compare_backends runs
+the suites. A candidate first runs on --screen_rows rows only, and is rejected
+there if it already misclassifies more of them than cleartext does; a
+candidate that fails to compile or to run is rejected too. Bazel caches the
+built variants, and the outcomes are cached in the work directory, so an
+interrupted or repeated search only evaluates new candidates.
+"""
+
+import argparse
+import ast
+import dataclasses
+import json
+import os
+import statistics
+import subprocess
+import sys
+
+from demos.common.python import suite_runner
+
+_CKKS_FLAG = "--torch-linalg-to-ckks="
+
+# The suites the tuner can build. suite_bzl defines the HEIR_OPT_FLAGS of the
+# model and the SWEEP_ATTRS its BUILD file passes to the param_sweep macro.
+TARGETS = {
+    ("cc_fraud", "lattigo"): {
+        "macro": "heir_lattigo_param_sweep",
+        "suite_bzl": "//demos/cc_fraud/lattigo:suite.bzl",
+        "binary_dir": "{name}_",
+        "cleartext": "//demos/cc_fraud/cleartext:evaluate_cleartext_suite",
+        "cleartext_rows_flag": "--limit",
+        "space": {
+            "greedy-level-budget": [10, 11, 12, 13, 14, 15, 16],
+            "first-mod-bits": [28, 30, 33, 36, 40],
+            "scaling-mod-bits": [20, 22, 24, 26, 28, 30],
+            "min-slot-count": [4096, 8192, 16384],
+        },
+    },
+    ("cc_fraud", "openfhe"): {
+        "macro": "heir_openfhe_param_sweep",
+        "suite_bzl": "//demos/cc_fraud/openfhe:suite.bzl",
+        "binary_dir": "",
+        "cleartext": "//demos/cc_fraud/cleartext:evaluate_cleartext_suite",
+        "cleartext_rows_flag": "--limit",
+        "space": {
+            "greedy-level-budget": [10, 11, 12, 13, 14, 15, 16],
+            "first-mod-bits": [28, 30, 33, 36, 40],
+            "scaling-mod-bits": [20, 22, 24, 26, 28, 30],
+            "min-slot-count": [4096, 8192, 16384],
+        },
+    },
+    ("mnist", "lattigo"): {
+        "macro": "heir_lattigo_param_sweep",
+        "suite_bzl": "//demos/mnist/lattigo:suite.bzl",
+        "binary_dir": "{name}_",
+        "cleartext": "//demos/mnist/cleartext:evaluate_cleartext_suite",
+        "cleartext_rows_flag": "--num_samples",
+        "space": {
+            "greedy-level-budget": [8, 9, 10, 11, 12, 13],
+            "first-mod-bits": [28, 30, 33, 36, 40],
+            "scaling-mod-bits": [20, 22, 24, 26, 28, 30],
+            "min-slot-count": [512, 1024, 2048, 4096],
+        },
+    },
+}
+
+
+@dataclasses.dataclass
+class Trial:
+  """The outcome of one candidate.
+
+  status is "ok" if the candidate meets the accuracy target, "rejected" if it
+  does not, or "failed" if it does not build or run. errors and rows are
+  those of the last stage the candidate ran.
+  """
+
+  options: dict[str, int]
+  status: str
+  rows: int = 0
+  errors: int = 0
+  latency_s: float = 0.0
+  p50_latency_s: float = 0.0
+  detail: str = ""
+
+
+def ckks_options(heir_opt_flags):
+  """Returns the options of the --torch-linalg-to-ckks flag, in order."""
+  for flag in heir_opt_flags:
+    if flag.startswith(_CKKS_FLAG):
+      return dict(
+          option.partition("=")[::2]
+          for option in flag[len(_CKKS_FLAG) :].split()
+      )
+  return {}
+
+
+def ckks_flag(heir_opt_flags, options):
+  """Returns the --torch-linalg-to-ckks flag with options overridden."""
+  merged = ckks_options(heir_opt_flags)
+  merged.update({key: str(value) for key, value in options.items()})
+  return _CKKS_FLAG + " ".join(f"{k}={v}" for k, v in merged.items())
+
+
+def variant_suffix(options):
+  """Names a candidate like ckks_param_grid in param_sweep.bzl does."""
+  return "_".join(
+      "".join(word[0] for word in option.split("-") if word) + str(value)
+      for option, value in options.items()
+  )
+
+
+def neighbors(value, values):
+  """Returns the values next to value in the sorted values."""
+  ordered = sorted(set(values) | {value})
+  i = ordered.index(value)
+  return ordered[max(i - 1, 0) : i] + ordered[i + 1 : i + 2]
+
+
+def bzl_constant(source, name, key=None):
+  """Returns the value of a literal constant, or of one of its entries.
+
+  Args:
+    source: the content of a .bzl file.
+    name: the name of a top-level constant.
+    key: if set, the key of the entry of the dict constant to return. Only
+      that entry needs to be a literal.
+  """
+  for node in ast.parse(source).body:
+    if (
+        isinstance(node, ast.Assign)
+        and len(node.targets) == 1
+        and isinstance(node.targets[0], ast.Name)
+        and node.targets[0].id == name
+    ):
+      value = node.value
+      if key is None:
+        return ast.literal_eval(value)
+      for k, v in zip(value.keys, value.values):
+        if ast.literal_eval(k) == key:
+          return ast.literal_eval(v)
+      raise KeyError(f"{name} has no entry {key!r}")
+  raise KeyError(f"no constant {name}")
+
+
+def starlark(value, indent=""):
+  """Formats value as a Starlark literal, in the layout of buildifier."""
+  inner = indent + "    "
+  if isinstance(value, bool):
+    return "True" if value else "False"
+  if isinstance(value, (int, str)):
+    return json.dumps(value)
+  if isinstance(value, list):
+    if not value:
+      return "[]"
+    items = "".join(f"{inner}{starlark(v, inner)},\n" for v in value)
+    return f"[\n{items}{indent}]"
+  if isinstance(value, dict):
+    if not value:
+      return "{}"
+    items = "".join(
+        f"{inner}{json.dumps(k)}: {starlark(v, inner)},\n"
+        for k, v in value.items()
+    )
+    return f"{{\n{items}{indent}}}"
+  raise TypeError(f"cannot format {value!r}")
+
+
+def sweep_build(name, model, target, points):
+  """Returns the BUILD file that builds the candidates in points.
+
+  The model's flags and suite attributes are loaded from its suite_bzl, so the
+  candidates always match its BUILD file.
+  """
+  points_str = starlark({variant_suffix(p): p for p in points}, "    ")
+  return (
+      "# Generated by demos/common/python/tune_params.py.\n\n"
+      f'load("//demos/common/bazel:param_sweep.bzl", "{target["macro"]}")\n'
+      f'load("{target["suite_bzl"]}", "HEIR_OPT_FLAGS", "SWEEP_ATTRS")\n\n'
+      'package(default_visibility = ["//visibility:private"])\n\n'
+      f"{target['macro']}(\n"
+      f'    name = "{name}",\n'
+      "    heir_opt_flags = HEIR_OPT_FLAGS,\n"
+      f'    model = "{model}",\n'
+      f"    points = {points_str},\n"
+      "    **SWEEP_ATTRS\n"
+      ")\n"
+  )
+
+
+def _options_key(options):
+  return json.dumps(sorted(options.items()))
+
+
+class Tuner:
+  """Builds, runs and caches the candidates of one model and backend."""
+
+  def __init__(self, args, target):
+    self.args = args
+    self.target = target
+    self.workspace = os.environ.get("BUILD_WORKSPACE_DIRECTORY", os.getcwd())
+    self.package = os.path.normpath(args.work_dir)
+    self.work_dir = os.path.join(self.workspace, self.package)
+    self.name = f"{args.model}_{args.backend}"
+    bzl_path = os.path.join(
+        self.workspace, target["suite_bzl"][2:].replace(":", "/")
+    )
+    with open(bzl_path) as f:
+      source = f.read()
+    self.heir_opt_flags = bzl_constant(source, "HEIR_OPT_FLAGS")
+    self.rows_flag = bzl_constant(source, "SWEEP_ATTRS", "rows_flag")
+    os.makedirs(self.work_dir, exist_ok=True)
+    self.cache_path = os.path.join(self.work_dir, f"{self.name}.json")
+    self.cache = {}
+    if os.path.exists(self.cache_path):
+      with open(self.cache_path) as f:
+        self.cache = json.load(f)
+    self.bazel_bin = self._bazel("info", "bazel-bin").strip()
+    self.cores = args.cores or len(suite_runner.available_cpus())
+    self.evaluated = 0
+
+  def _bazel(self, command, *targets, log_path=None):
+    cmd = [self.args.bazel, command, "-c", "opt", *targets]
+    if log_path is None:
+      return subprocess.run(
+          cmd, cwd=self.workspace, check=True, capture_output=True, text=True
+      ).stdout
+    with open(log_path, "w") as log:
+      subprocess.run(
+          cmd,
+          cwd=self.workspace,
+          check=True,
+          stdout=log,
+          stderr=subprocess.STDOUT,
+      )
+
+  def _run(self, binary, backend, rows_flag, rows, report_name, extra=()):
+    return suite_runner.run_suite(
+        binary,
+        backend,
+        rows_flag,
+        rows,
+        self.cores,
+        os.path.join(self.work_dir, report_name),
+        extra,
+    )
+
+  def cleartext_errors(self, rows):
+    """Runs the cleartext suite on rows rows and returns its errors."""
+    label = self.target["cleartext"]
+    self._bazel("build", label)
+    package, _, name = label[2:].partition(":")
+    report = self._run(
+        os.path.join(self.bazel_bin, package, name),
+        "cleartext",
+        self.target["cleartext_rows_flag"],
+        rows,
+        f"{self.name}_cleartext_{rows}.json",
+    ).report
+    return report.rows - report.correct
+
+  def _write_build(self, options):
+    points = [entry["options"] for entry in self.cache.values()]
+    if options not in points:
+      points.append(options)
+    with open(os.path.join(self.work_dir, "BUILD"), "w") as f:
+      f.write(sweep_build(self.name, self.args.model, self.target, points))
+
+  def evaluate(self, options, budgets):
+    """Returns the trial of options, from the cache if it ran before.
+
+    budgets are (rows, allowed errors) stages; the candidate stops at the first
+    stage it misclassifies too many rows of.
+    """
+    key = _options_key(options)
+    cached = self.cache.get(key)
+    if cached and cached["budgets"] == budgets:
+      return Trial(**cached["trial"])
+
+    self.evaluated += 1
+    variant = f"{self.name}_{variant_suffix(options)}"
+    print(f"[{self.evaluated}] Trying {variant}...", file=sys.stderr)
+    self._write_build(options)
+    log_path = os.path.join(self.work_dir, f"{variant}.build.log")
+    try:
+      self._bazel("build", f"//{self.package}:{variant}", log_path=log_path)
+    except subprocess.CalledProcessError:
+      trial = Trial(options, "failed", detail=f"build failed, see {log_path}")
+      return self._store(key, budgets, trial)
+
+    binary = os.path.join(
+        self.bazel_bin,
+        self.package,
+        self.target["binary_dir"].format(name=variant),
+        variant,
+    )
+    extra = []
+    if self.args.backend == "openfhe":
+      extra.append(
+          f"--model_module={self.package.replace('/', '.')}.{variant}_pybind"
+      )
+    for rows, allowed in budgets:
+      try:
+        report = self._run(
+            binary,
+            self.args.backend,
+            self.rows_flag,
+            rows,
+            f"{variant}_{rows}.json",
+            extra,
+        ).report
+      except RuntimeError as e:
+        trial = Trial(options, "failed", rows=rows, detail=str(e))
+        break
+      errors = report.rows - report.correct
+      latencies = report.eval_latency_s or [0.0]
+      trial = Trial(
+          options,
+          "ok" if errors <= allowed else "rejected",
+          rows=report.rows,
+          errors=errors,
+          latency_s=statistics.mean(latencies),
+          p50_latency_s=statistics.median(latencies),
+          detail=f"{errors} errors, {allowed} allowed on {report.rows} rows",
+      )
+      if trial.status != "ok":
+        break
+    return self._store(key, budgets, trial)
+
+  def _store(self, key, budgets, trial):
+    print(f"  {trial.status}: {trial.detail}", file=sys.stderr)
+    self.cache[key] = {
+        "budgets": budgets,
+        "options": trial.options,
+        "trial": dataclasses.asdict(trial),
+    }
+    tmp = self.cache_path + ".tmp"
+    with open(tmp, "w") as f:
+      json.dump(self.cache, f, indent=2)
+    os.replace(tmp, self.cache_path)
+    return trial
+
+
+def search(evaluate, baseline, space, max_candidates):
+  """Greedy coordinate descent over space, starting at baseline.
+
+  Moves to the first neighbor of the current options, one option changed by
+  one step, that meets the target and is faster, until none is or
+  max_candidates candidates have been tried. Returns the best trial and all
+  trials.
+  """
+  trials = {}
+
+  def trial_of(options):
+    key = _options_key(options)
+    if key not in trials:
+      trials[key] = evaluate(options)
+    return trials[key]
+
+  best = trial_of(baseline)
+  if best.status != "ok":
+    return best, list(trials.values())
+  improved = True
+  while improved and len(trials) < max_candidates:
+    improved = False
+    for option, values in space.items():
+      for value in neighbors(best.options[option], values):
+        if len(trials) >= max_candidates:
+          break
+        candidate = dict(best.options)
+        candidate[option] = value
+        trial = trial_of(candidate)
+        if trial.status == "ok" and trial.latency_s < best.latency_s:
+          best = trial
+          improved = True
+          break
+      if improved:
+        break
+  return best, list(trials.values())
+
+
+def parse_space(values):
+  """Parses --space OPTION=V1,V2,... overrides."""
+  space = {}
+  for value in values:
+    option, _, listed = value.partition("=")
+    if not listed:
+      raise argparse.ArgumentTypeError(f"malformed search space {value!r}")
+    space[option] = [int(v) for v in listed.split(",")]
+  return space
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument(
+      "--model", choices=sorted({m for m, _ in TARGETS}), required=True
+  )
+  parser.add_argument(
+      "--backend", choices=("lattigo", "openfhe"), required=True
+  )
+  parser.add_argument(
+      "--rows",
+      type=int,
+      default=100,
+      help="Number of rows a candidate must classify as well as cleartext",
+  )
+  parser.add_argument(
+      "--screen_rows",
+      type=int,
+      default=None,
+      help="Rows of the early-stopping stage (default: a tenth of --rows)",
+  )
+  parser.add_argument(
+      "--max_extra_errors",
+      type=int,
+      default=0,
+      help="Misclassifications allowed on top of those of cleartext",
+  )
+  parser.add_argument(
+      "--space",
+      action="append",
+      default=[],
+      help=(
+          "OPTION=V1,V2,... values of a --torch-linalg-to-ckks option to"
+          " search, replacing the default ones of the model"
+      ),
+  )
+  parser.add_argument(
+      "--max_candidates",
+      type=int,
+      default=30,
+      help="Stop after trying this many candidates",
+  )
+  parser.add_argument(
+      "--cores",
+      type=int,
+      default=None,
+      help="Number of cores to run the suites on (default: all)",
+  )
+  parser.add_argument(
+      "--work_dir",
+      type=str,
+      default="_tuning",
+      help="Workspace-relative package for the candidates and the cache",
+  )
+  parser.add_argument("--bazel", type=str, default="bazel")
+  parser.add_argument(
+      "--output",
+      type=str,
+      default=None,
+      help="Also write the chosen options and all trials to this JSON file",
+  )
+  args = parser.parse_args()
+
+  target = TARGETS.get((args.model, args.backend))
+  if target is None:
+    parser.error(f"no tuning target for {args.model} on {args.backend}")
+  space = dict(target["space"])
+  space.update(parse_space(args.space))
+  tuner = Tuner(args, target)
+  baseline_options = ckks_options(tuner.heir_opt_flags)
+  baseline = {
+      option: int(baseline_options.get(option, values[0]))
+      for option, values in space.items()
+  }
+  screen_rows = args.screen_rows or max(args.rows // 10, 1)
+  stages = [screen_rows, args.rows] if screen_rows < args.rows else [args.rows]
+  budgets = [
+      [rows, tuner.cleartext_errors(rows) + args.max_extra_errors]
+      for rows in stages
+  ]
+  for rows, allowed in budgets:
+    print(
+        f"Target: at most {allowed} misclassified of the first {rows} rows",
+        file=sys.stderr,
+    )
+
+  best, trials = search(
+      lambda options: tuner.evaluate(options, budgets),
+      baseline,
+      space,
+      args.max_candidates,
+  )
+
+  print(f"\n{args.model} ({args.backend}): {len(trials)} candidates\n")
+  for trial in sorted(trials, key=lambda t: (t.status != "ok", t.latency_s)):
+    print(
+        f"  {variant_suffix(trial.options):<32} {trial.status:<9}"
+        f" {trial.latency_s * 1000:>9.1f} ms  {trial.detail}"
+    )
+  if best.status != "ok":
+    print(
+        "\nThe options of the BUILD file miss the accuracy target; raise"
+        " --max_extra_errors or fix them first."
+    )
+    sys.exit(1)
+
+  flag = ckks_flag(tuner.heir_opt_flags, best.options)
+  print(
+      f"\nFastest candidate: {best.latency_s * 1000:.1f} ms per row (median"
+      f" {best.p50_latency_s * 1000:.1f} ms), {best.errors} misclassified of"
+      f" {best.rows} rows\n  {flag}"
+  )
+
+  if args.output:
+    path = args.output
+    if not os.path.isabs(path) and "BUILD_WORKING_DIRECTORY" in os.environ:
+      path = os.path.join(os.environ["BUILD_WORKING_DIRECTORY"], path)
+    with open(path, "w") as f:
+      json.dump(
+          {
+              "flag": flag,
+              "best": dataclasses.asdict(best),
+              "trials": [dataclasses.asdict(t) for t in trials],
+          },
+          f,
+          indent=2,
+      )
+
+
+if __name__ == "__main__":
+  main()
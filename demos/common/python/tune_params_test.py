@@ -0,0 +1,116 @@
+"""Tests for the search and the generated BUILD file of the parameter tuner."""
+
+from absl.testing import absltest
+from demos.common.python import tune_params
+
+_FLAGS = [
+    "--annotate-module=backend=lattigo scheme=ckks",
+    "--torch-linalg-to-ckks=min-slot-count=8192 greedy-level-budget=15",
+]
+
+
+class TuneParamsTest(absltest.TestCase):
+
+  def test_ckks_flag(self):
+    self.assertEqual(
+        tune_params.ckks_options(_FLAGS),
+        {"min-slot-count": "8192", "greedy-level-budget": "15"},
+    )
+    self.assertEqual(
+        tune_params.ckks_flag(
+            _FLAGS, {"greedy-level-budget": 12, "first-mod-bits": 36}
+        ),
+        "--torch-linalg-to-ckks=min-slot-count=8192 greedy-level-budget=12"
+        " first-mod-bits=36",
+    )
+
+  def test_variant_suffix(self):
+    self.assertEqual(
+        tune_params.variant_suffix(
+            {"greedy-level-budget": 12, "first-mod-bits": 30}
+        ),
+        "glb12_fmb30",
+    )
+
+  def test_neighbors(self):
+    self.assertEqual(tune_params.neighbors(12, [10, 12, 15]), [10, 15])
+    self.assertEqual(tune_params.neighbors(10, [10, 12, 15]), [12])
+    self.assertEqual(tune_params.neighbors(13, [10, 12, 15]), [12, 15])
+
+  def test_bzl_constant(self):
+    source = (
+        'load("@demo_pip_deps//:requirements.bzl", "requirement")\n'
+        'HEIR_OPT_FLAGS = ["--a", "--b"]\n'
+        'SWEEP_ATTRS = {"rows_flag": "-limit", "deps": [requirement("x")]}\n'
+    )
+    self.assertEqual(
+        tune_params.bzl_constant(source, "HEIR_OPT_FLAGS"), ["--a", "--b"]
+    )
+    self.assertEqual(
+        tune_params.bzl_constant(source, "SWEEP_ATTRS", "rows_flag"), "-limit"
+    )
+    with self.assertRaises(KeyError):
+      tune_params.bzl_constant(source, "MISSING")
+
+  def test_sweep_build_loads_the_model_attributes(self):
+    build = tune_params.sweep_build(
+        "cc_fraud_lattigo",
+        "cc_fraud",
+        tune_params.TARGETS[("cc_fraud", "lattigo")],
+        [{"greedy-level-budget": 12}],
+    )
+    self.assertIn(
+        'load("//demos/cc_fraud/lattigo:suite.bzl", "HEIR_OPT_FLAGS",'
+        ' "SWEEP_ATTRS")',
+        build,
+    )
+    self.assertIn(
+        '    points = {\n        "glb12": {\n'
+        '            "greedy-level-budget": 12,\n        },\n    },\n',
+        build,
+    )
+    self.assertIn("    **SWEEP_ATTRS\n", build)
+
+  def test_search_stops_at_fastest_accurate_candidate(self):
+    # Fewer levels are faster; below 11 the candidate misclassifies.
+    def evaluate(options):
+      level = options["greedy-level-budget"]
+      return tune_params.Trial(
+          options,
+          "ok" if level >= 11 else "rejected",
+          latency_s=float(level),
+      )
+
+    best, trials = tune_params.search(
+        evaluate,
+        {"greedy-level-budget": 15},
+        {"greedy-level-budget": [9, 10, 11, 12, 13, 14, 15]},
+        max_candidates=30,
+    )
+    self.assertEqual(best.options, {"greedy-level-budget": 11})
+    self.assertLen(trials, 6)
+
+  def test_search_keeps_failing_baseline(self):
+    best, trials = tune_params.search(
+        lambda options: tune_params.Trial(options, "failed"),
+        {"greedy-level-budget": 15},
+        {"greedy-level-budget": [12, 15]},
+        max_candidates=30,
+    )
+    self.assertEqual(best.status, "failed")
+    self.assertLen(trials, 1)
+
+  def test_search_respects_max_candidates(self):
+    _, trials = tune_params.search(
+        lambda options: tune_params.Trial(
+            options, "ok", latency_s=options["first-mod-bits"]
+        ),
+        {"first-mod-bits": 40},
+        {"first-mod-bits": list(range(20, 41))},
+        max_candidates=4,
+    )
+    self.assertLen(trials, 4)
+
+
+if __name__ == "__main__":
+  absltest.main()
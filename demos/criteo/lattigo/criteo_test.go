@@ -0,0 +1,88 @@
+package criteo_test
+
+import (
+	"flag"
+	"testing"
+
+	"fully_homomorphic_encryption/demos/common/go/bench"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
+	"fully_homomorphic_encryption/demos/common/lattigo/primitives"
+	"fully_homomorphic_encryption/demos/common/lattigo/recycle"
+	"fully_homomorphic_encryption/demos/criteo/lattigo/criteo"
+	"fully_homomorphic_encryption/demos/criteo/lattigo/criteo_utils"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+)
+
+var keyDir = flag.String("key_dir", "", "Directory to load keys from, or to save freshly generated keys to")
+
+// Widths of the dense input and of each sparse block, as in sparse.go.
+const (
+	denseWidth  = 13
+	sparseWidth = 23873
+)
+
+func BenchmarkRunInference(b *testing.B) {
+	btpEvaluator, evaluator, params, encoder, encryptor, decryptor, err := keystore.ConfigureBootstrapping(*keyDir, criteo.Run_inference__configure)
+	if err != nil {
+		b.Fatal(err)
+	}
+	weights := criteo_utils.Run_inference__preprocessing(params, encoder)
+	dense := make([]float32, denseWidth)
+	sparse := make([]float32, sparseWidth)
+
+	bench.Run(b, bench.Model[[3][]*rlwe.Ciphertext, []*rlwe.Ciphertext]{
+		Encrypt: func() func() [3][]*rlwe.Ciphertext {
+			evaluator, encoder, encryptor := evaluator.ShallowCopy(), encoder.ShallowCopy(), encryptor.ShallowCopy()
+			return func() [3][]*rlwe.Ciphertext {
+				return [3][]*rlwe.Ciphertext{
+					criteo.Run_inference__encrypt__arg0(evaluator, params, encoder, encryptor, dense),
+					criteo.Run_inference__encrypt__arg1(evaluator, params, encoder, encryptor, sparse),
+					criteo.Run_inference__encrypt__arg2(evaluator, params, encoder, encryptor, sparse),
+				}
+			}
+		},
+		Evaluate: func() func([3][]*rlwe.Ciphertext) []*rlwe.Ciphertext {
+			btpEvaluator, evaluator, encoder, encryptor := btpEvaluator.ShallowCopy(), evaluator.ShallowCopy(), encoder.ShallowCopy(), encryptor.ShallowCopy()
+			var zeros *recycle.Zeros
+			return func(in [3][]*rlwe.Ciphertext) []*rlwe.Ciphertext {
+				if zeros == nil {
+					zeros = recycle.NewZeros(
+						criteo.Run_inference__encrypt__zero__0(evaluator, params, encoder, encryptor),
+						criteo.Run_inference__encrypt__zero__1(evaluator, params, encoder, encryptor),
+						criteo.Run_inference__encrypt__zero__2(evaluator, params, encoder, encryptor),
+						criteo.Run_inference__encrypt__zero__3(evaluator, params, encoder, encryptor),
+						criteo.Run_inference__encrypt__zero__4(evaluator, params, encoder, encryptor),
+						criteo.Run_inference__encrypt__zero__5(evaluator, params, encoder, encryptor),
+						criteo.Run_inference__encrypt__zero__6(evaluator, params, encoder, encryptor),
+					)
+				} else if err := zeros.Refresh(encryptor); err != nil {
+					panic(err)
+				}
+				out := criteo.Run_inference__preprocessed(
+					btpEvaluator, evaluator, params, encoder,
+					in[0], in[1], in[2],
+					zeros.Get(0), zeros.Get(1), zeros.Get(2), zeros.Get(3), zeros.Get(4), zeros.Get(5), zeros.Get(6),
+					weights,
+				)
+				zeros.Detach(out)
+				return out
+			}
+		},
+		Decrypt: func() func([]*rlwe.Ciphertext) {
+			evaluator, encoder, decryptor := evaluator.ShallowCopy(), encoder.ShallowCopy(), decryptor.ShallowCopy()
+			return func(out []*rlwe.Ciphertext) {
+				criteo.Run_inference__decrypt__result0(evaluator, params, encoder, decryptor, out)
+			}
+		},
+	})
+}
+
+// BenchmarkPrimitives times each CKKS primitive at every level of the model's
+// parameters.
+func BenchmarkPrimitives(b *testing.B) {
+	btpEvaluator, evaluator, params, encoder, encryptor, _, err := keystore.ConfigureBootstrapping(*keyDir, criteo.Run_inference__configure)
+	if err != nil {
+		b.Fatal(err)
+	}
+	primitives.Run(b, params, evaluator, encoder, encryptor, btpEvaluator)
+}
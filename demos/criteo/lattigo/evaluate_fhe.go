@@ -2,69 +2,182 @@
 package main
 
 import (
+	"flag"
 	"fmt"
+	"os"
+	"runtime"
 	"time"
 
+	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
+	"fully_homomorphic_encryption/demos/common/go/workerpool"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
 	"fully_homomorphic_encryption/demos/criteo/lattigo/criteo"
 	"fully_homomorphic_encryption/demos/criteo/lattigo/criteo_utils"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
 )
 
+// cryptoWorker holds one encryption worker's copies of the Lattigo objects.
+type cryptoWorker struct {
+	evaluator *ckks.Evaluator
+	encoder   *ckks.Encoder
+	encryptor *rlwe.Encryptor
+}
+
 func main() {
-	fmt.Println("Generating synthetic inputs...")
-	// Input sizes determined from generated code analysis:
-	// arg0: dense features (size 13)
-	// arg1: sparse features 1 (size 23873)
-	// arg2: sparse features 2 (size 23873)
-	input0 := make([]float32, 13)
-	for i := range input0 {
-		input0[i] = 1.0
-	}
-	input1 := make([]float32, 23873)
-	for i := range input1 {
-		input1[i] = 0.5
+	sampleIdxFlag := flag.Int("sample_idx", -1, "Sample index in the sparse NPZ to evaluate (negative means synthetic inputs)")
+	samplePathFlag := flag.String("sample_path", "sample_sparse.npz", "Path to a sparse sample NPZ written by utils/sparsify_sample.py")
+	parallelFlag := flag.Bool("parallel", true, "Encrypt the inputs and zero accumulators on all CPUs, overlapped with weight preprocessing")
+	keyFlags := keystore.RegisterFlags()
+	flag.Parse()
+
+	var input0, input1, input2 []float32
+	if *sampleIdxFlag < 0 {
+		fmt.Println("Generating synthetic inputs...")
+		// Input sizes determined from generated code analysis:
+		// arg0: dense features (size 13)
+		// arg1: sparse features 1 (size 23873)
+		// arg2: sparse features 2 (size 23873)
+		input0 = make([]float32, denseWidth)
+		for i := range input0 {
+			input0[i] = 1.0
+		}
+		input1 = make([]float32, sparseWidth)
+		for i := range input1 {
+			input1[i] = 0.5
+		}
+		input2 = make([]float32, sparseWidth)
+		for i := range input2 {
+			input2[i] = 0.2
+		}
+	} else {
+		samplePath := *samplePathFlag
+		if samplePath == "sample_sparse.npz" {
+			samplePath = pathutils.ResolvePath("fully_homomorphic_encryption/demos/criteo/data/sample_sparse.npz")
+		}
+		fmt.Printf("Loading sparse sample %d from %s...\n", *sampleIdxFlag, samplePath)
+		t0 := time.Now()
+		samples, err := loadSparseSamples(samplePath)
+		if err != nil {
+			fmt.Printf("Error loading samples: %v\n", err)
+			os.Exit(1)
+		}
+		if *sampleIdxFlag >= len(samples) {
+			fmt.Printf("Error: -sample_idx=%d, but %s has %d samples\n", *sampleIdxFlag, samplePath, len(samples))
+			os.Exit(1)
+		}
+		sample := samples[*sampleIdxFlag]
+		if input0, input1, input2, err = sample.inputs(); err != nil {
+			fmt.Printf("Error expanding sparse features: %v\n", err)
+			os.Exit(1)
+		}
+		fmt.Printf("  Took %v\n", time.Since(t0))
+		fmt.Printf("  Active sparse features: %d + %d\n", len(sample.sparse[0].indices), len(sample.sparse[1].indices))
+		fmt.Printf("  Expected label: %v\n", sample.label)
+		if sample.hasCleartext {
+			fmt.Printf("  Cleartext model output: %v\n", sample.cleartext)
+		}
 	}
-	input2 := make([]float32, 23873)
-	for i := range input2 {
-		input2[i] = 0.2
+
+	keyOpts, err := keyFlags.Options()
+	if err != nil {
+		fmt.Printf("Error: %v\n", err)
+		os.Exit(1)
 	}
 
 	fmt.Println("Configuring Lattigo context...")
 	t0 := time.Now()
-	bootstrappingEvaluator, evaluator, params, encoder, encryptor, decryptor := criteo.Run_inference__configure()
-	fmt.Printf("  Took %v\n", time.Since(t0))
-
-	fmt.Println("Encrypting inputs...")
-	t0 = time.Now()
-	cts0 := criteo.Run_inference__encrypt__arg0(evaluator, params, encoder, encryptor, input0)
-	cts1 := criteo.Run_inference__encrypt__arg1(evaluator, params, encoder, encryptor, input1)
-	cts2 := criteo.Run_inference__encrypt__arg2(evaluator, params, encoder, encryptor, input2)
+	bootstrappingEvaluator, evaluator, params, encoder, encryptor, decryptor, err := keystore.ConfigureBootstrapping(keyFlags.Dir(), criteo.Run_inference__configure, keyOpts...)
+	if err != nil {
+		fmt.Printf("Error configuring Lattigo context: %v\n", err)
+		os.Exit(1)
+	}
 	fmt.Printf("  Took %v\n", time.Since(t0))
 
-	fmt.Println("Encrypting zeros...")
-	t0 = time.Now()
-	zero0 := criteo.Run_inference__encrypt__zero__0(evaluator, params, encoder, encryptor)
-	zero1 := criteo.Run_inference__encrypt__zero__1(evaluator, params, encoder, encryptor)
-	zero2 := criteo.Run_inference__encrypt__zero__2(evaluator, params, encoder, encryptor)
-	zero3 := criteo.Run_inference__encrypt__zero__3(evaluator, params, encoder, encryptor)
-	zero4 := criteo.Run_inference__encrypt__zero__4(evaluator, params, encoder, encryptor)
-	zero5 := criteo.Run_inference__encrypt__zero__5(evaluator, params, encoder, encryptor)
-	zero6 := criteo.Run_inference__encrypt__zero__6(evaluator, params, encoder, encryptor)
-	fmt.Printf("  Took %v\n", time.Since(t0))
+	// The three inputs and the seven zero accumulators are encrypted
+	// independently, each task on a worker with its own ShallowCopies.
+	var cts [3][]*rlwe.Ciphertext
+	var zeros [7]*rlwe.Ciphertext
+	encryptTasks := []func(w cryptoWorker){
+		func(w cryptoWorker) {
+			cts[0] = criteo.Run_inference__encrypt__arg0(w.evaluator, params, w.encoder, w.encryptor, input0)
+		},
+		func(w cryptoWorker) {
+			cts[1] = criteo.Run_inference__encrypt__arg1(w.evaluator, params, w.encoder, w.encryptor, input1)
+		},
+		func(w cryptoWorker) {
+			cts[2] = criteo.Run_inference__encrypt__arg2(w.evaluator, params, w.encoder, w.encryptor, input2)
+		},
+		func(w cryptoWorker) {
+			zeros[0] = criteo.Run_inference__encrypt__zero__0(w.evaluator, params, w.encoder, w.encryptor)
+		},
+		func(w cryptoWorker) {
+			zeros[1] = criteo.Run_inference__encrypt__zero__1(w.evaluator, params, w.encoder, w.encryptor)
+		},
+		func(w cryptoWorker) {
+			zeros[2] = criteo.Run_inference__encrypt__zero__2(w.evaluator, params, w.encoder, w.encryptor)
+		},
+		func(w cryptoWorker) {
+			zeros[3] = criteo.Run_inference__encrypt__zero__3(w.evaluator, params, w.encoder, w.encryptor)
+		},
+		func(w cryptoWorker) {
+			zeros[4] = criteo.Run_inference__encrypt__zero__4(w.evaluator, params, w.encoder, w.encryptor)
+		},
+		func(w cryptoWorker) {
+			zeros[5] = criteo.Run_inference__encrypt__zero__5(w.evaluator, params, w.encoder, w.encryptor)
+		},
+		func(w cryptoWorker) {
+			zeros[6] = criteo.Run_inference__encrypt__zero__6(w.evaluator, params, w.encoder, w.encryptor)
+		},
+	}
+	encryptWorkers := 1
+	if *parallelFlag {
+		encryptWorkers = runtime.NumCPU()
+	}
+	fmt.Printf("Encrypting inputs and zeros on %d workers...\n", encryptWorkers)
+	encDone := make(chan workerpool.Stats, 1)
+	go func() {
+		encDone <- workerpool.Run(len(encryptTasks), workerpool.Config{Workers: encryptWorkers},
+			func() cryptoWorker {
+				return cryptoWorker{evaluator: evaluator.ShallowCopy(), encoder: encoder.ShallowCopy(), encryptor: encryptor.ShallowCopy()}
+			},
+			func(w cryptoWorker, i int) { encryptTasks[i](w) })
+	}()
+	// In parallel mode the preprocessing of the weights, which does not depend
+	// on the inputs, overlaps with the encryption.
+	if !*parallelFlag {
+		fmt.Printf("  Took %v\n", (<-encDone).Total)
+	}
 
 	fmt.Println("Running preprocessing...")
 	t0 = time.Now()
 	preprocessedWeights := criteo_utils.Run_inference__preprocessing(params, encoder)
 	fmt.Printf("  Took %v\n", time.Since(t0))
+	if *parallelFlag {
+		encStats := <-encDone
+		fmt.Printf("  Encryption took %v, overlapped with preprocessing\n", encStats.Total)
+	}
+
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Printf("Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
 
 	fmt.Println("Running FHE evaluation (preprocessed)...")
 	t0 = time.Now()
 	encryptedOutput := criteo.Run_inference__preprocessed(
 		bootstrappingEvaluator, evaluator, params, encoder,
-		cts0, cts1, cts2,
-		zero0, zero1, zero2, zero3, zero4, zero5, zero6,
+		cts[0], cts[1], cts[2],
+		zeros[0], zeros[1], zeros[2], zeros[3], zeros[4], zeros[5], zeros[6],
 		preprocessedWeights,
 	)
 	fmt.Printf("  Took %v\n", time.Since(t0))
+	if err := stopProfiles(); err != nil {
+		fmt.Printf("Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
 
 	fmt.Println("Decrypting output...")
 	t0 = time.Now()
@@ -0,0 +1,301 @@
+// Evaluate HE-LRM inference on a file of real Criteo samples
+package main
+
+import (
+	"flag"
+	"fmt"
+	"math"
+	"os"
+	"runtime"
+	"runtime/debug"
+	"sort"
+	"time"
+
+	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/pipeline"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
+	"fully_homomorphic_encryption/demos/common/go/workerpool"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
+	"fully_homomorphic_encryption/demos/common/lattigo/recycle"
+	"fully_homomorphic_encryption/demos/criteo/lattigo/criteo"
+	"fully_homomorphic_encryption/demos/criteo/lattigo/criteo_utils"
+	"github.com/tuneinsight/lattigo/v6/circuits/ckks/bootstrapping"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
+)
+
+// clickThreshold turns a model output into a click prediction, as in
+// torch/criteo_inference_test.py.
+const clickThreshold = 0.5
+
+// encryptedSample holds the three encrypted inputs of one sample and the time
+// its encryption started, from which its end-to-end latency is measured.
+type encryptedSample struct {
+	start           time.Time
+	dense, sp1, sp2 []*rlwe.Ciphertext
+}
+
+type evaluatedSample struct {
+	start    time.Time
+	output   []*rlwe.Ciphertext
+	evalTime time.Duration
+}
+
+type result struct {
+	output   float32
+	latency  time.Duration
+	evalTime time.Duration
+}
+
+// evalWorker holds one evaluation worker's Lattigo objects and its zero
+// accumulators for its lifetime; the accumulators are re-encrypted in place
+// before every sample.
+type evalWorker struct {
+	evaluator    *ckks.Evaluator
+	btpEvaluator *bootstrapping.Evaluator
+	ecd          *ckks.Encoder
+	encryptor    *rlwe.Encryptor
+	zeros        *recycle.Zeros
+}
+
+func main() {
+	samplePathFlag := flag.String("sample_path", "sample_sparse.npz", "Path to a sparse sample NPZ written by utils/sparsify_sample.py")
+	limitFlag := flag.Int("limit", 0, "Limit number of samples to test (0 means all)")
+	workersFlag := flag.Int("workers", runtime.NumCPU(), "Maximum number of concurrent evaluation workers")
+	maxMemoryFlag := flag.String("max_memory", "", "Total memory budget, e.g. 96GiB; reduces -workers so that concurrent evaluations fit (empty means unlimited)")
+	encryptWorkersFlag := flag.Int("encrypt_workers", 1, "Number of concurrent encryption workers")
+	decryptWorkersFlag := flag.Int("decrypt_workers", 1, "Number of concurrent decryption workers")
+	queueDepthFlag := flag.Int("queue_depth", 2, "Maximum number of samples waiting between two pipeline stages")
+	keyFlags := keystore.RegisterFlags()
+	flag.Parse()
+
+	maxMemory, err := workerpool.ParseBytes(*maxMemoryFlag)
+	if err != nil {
+		fmt.Printf("Error parsing -max_memory: %v\n", err)
+		os.Exit(1)
+	}
+
+	samplePath := *samplePathFlag
+	if samplePath == "sample_sparse.npz" {
+		samplePath = pathutils.ResolvePath("fully_homomorphic_encryption/demos/criteo/data/sample_sparse.npz")
+	}
+	fmt.Printf("Loading sparse samples from %s...\n", samplePath)
+	t0 := time.Now()
+	samples, err := loadSparseSamples(samplePath)
+	if err != nil {
+		fmt.Printf("Error loading samples: %v\n", err)
+		os.Exit(1)
+	}
+	if *limitFlag > 0 && *limitFlag < len(samples) {
+		samples = samples[:*limitFlag]
+	}
+	numSamples := len(samples)
+	fmt.Printf("  Loaded %d samples in %v\n", numSamples, time.Since(t0))
+	if numSamples == 0 {
+		return
+	}
+
+	keyOpts, err := keyFlags.Options()
+	if err != nil {
+		fmt.Printf("Error: %v\n", err)
+		os.Exit(1)
+	}
+
+	// Configure context (ONCE)
+	fmt.Println("Configuring Lattigo context...")
+	t0 = time.Now()
+	btpEvaluator, evaluator, params, ecd, encryptor, decryptor, err := keystore.ConfigureBootstrapping(keyFlags.Dir(), criteo.Run_inference__configure, keyOpts...)
+	if err != nil {
+		fmt.Printf("Error configuring Lattigo context: %v\n", err)
+		os.Exit(1)
+	}
+	fmt.Printf("  Took %v\n", time.Since(t0))
+
+	// Preprocessing (ONCE), shared read-only by all evaluation workers
+	fmt.Println("Running preprocessing for model weights...")
+	t0 = time.Now()
+	preprocessedWeights := criteo_utils.Run_inference__preprocessing(params, ecd)
+	fmt.Printf("  Took %v\n", time.Since(t0))
+
+	encryptSample := func(evaluator *ckks.Evaluator, ecd *ckks.Encoder, encryptor *rlwe.Encryptor, idx int) encryptedSample {
+		in := encryptedSample{start: time.Now()}
+		input0, input1, input2, err := samples[idx].inputs()
+		if err != nil {
+			fmt.Printf("Error expanding sample %d: %v\n", idx, err)
+			os.Exit(1)
+		}
+		in.dense = criteo.Run_inference__encrypt__arg0(evaluator, params, ecd, encryptor, input0)
+		in.sp1 = criteo.Run_inference__encrypt__arg1(evaluator, params, ecd, encryptor, input1)
+		in.sp2 = criteo.Run_inference__encrypt__arg2(evaluator, params, ecd, encryptor, input2)
+		return in
+	}
+	newEvalWorker := func() *evalWorker {
+		return &evalWorker{
+			evaluator:    evaluator.ShallowCopy(),
+			btpEvaluator: btpEvaluator.ShallowCopy(),
+			ecd:          ecd.ShallowCopy(),
+			encryptor:    encryptor.ShallowCopy(),
+		}
+	}
+	evaluateSample := func(w *evalWorker, in encryptedSample) evaluatedSample {
+		t0 := time.Now()
+		if w.zeros == nil {
+			w.zeros = recycle.NewZeros(
+				criteo.Run_inference__encrypt__zero__0(w.evaluator, params, w.ecd, w.encryptor),
+				criteo.Run_inference__encrypt__zero__1(w.evaluator, params, w.ecd, w.encryptor),
+				criteo.Run_inference__encrypt__zero__2(w.evaluator, params, w.ecd, w.encryptor),
+				criteo.Run_inference__encrypt__zero__3(w.evaluator, params, w.ecd, w.encryptor),
+				criteo.Run_inference__encrypt__zero__4(w.evaluator, params, w.ecd, w.encryptor),
+				criteo.Run_inference__encrypt__zero__5(w.evaluator, params, w.ecd, w.encryptor),
+				criteo.Run_inference__encrypt__zero__6(w.evaluator, params, w.ecd, w.encryptor),
+			)
+		} else if err := w.zeros.Refresh(w.encryptor); err != nil {
+			fmt.Printf("Error: %v\n", err)
+			os.Exit(1)
+		}
+		z := w.zeros
+		out := criteo.Run_inference__preprocessed(
+			w.btpEvaluator, w.evaluator, params, w.ecd,
+			in.dense, in.sp1, in.sp2,
+			z.Get(0), z.Get(1), z.Get(2), z.Get(3), z.Get(4), z.Get(5), z.Get(6),
+			preprocessedWeights,
+		)
+		z.Detach(out)
+		return evaluatedSample{start: in.start, output: out, evalTime: time.Since(t0)}
+	}
+
+	// With a memory budget, run the first sample alone to measure how much
+	// memory one evaluation keeps alive, and size the worker pool from it.
+	results := make([]result, numSamples)
+	poolCfg := workerpool.Config{Workers: *workersFlag}
+	firstSample := 0
+	if maxMemory > 0 {
+		debug.SetMemoryLimit(maxMemory)
+		fmt.Println("Measuring per-sample memory footprint on sample 0...")
+		t0 = time.Now()
+		var out evaluatedSample
+		poolCfg.TaskFootprint = workerpool.MeasureFootprint(func() {
+			out = evaluateSample(newEvalWorker(), encryptSample(evaluator, ecd, encryptor, 0))
+		})
+		fmt.Printf("  Took %v, footprint %s per sample\n", time.Since(t0), workerpool.FormatBytes(poolCfg.TaskFootprint))
+		results[0] = result{
+			output:   criteo.Run_inference__decrypt__result0(evaluator, params, ecd, decryptor, out.output)[0],
+			latency:  time.Since(out.start),
+			evalTime: out.evalTime,
+		}
+		firstSample = 1
+
+		inUse := workerpool.HeapInUse()
+		poolCfg.MemoryBudget = maxMemory - inUse
+		if poolCfg.MemoryBudget < poolCfg.TaskFootprint {
+			fmt.Printf("  Warning: %s already in use, budget leaves no room for concurrent samples\n", workerpool.FormatBytes(inUse))
+			poolCfg.MemoryBudget = poolCfg.TaskFootprint
+		}
+		fmt.Printf("  Memory: %s in use, %s budget for evaluations -> %d workers\n",
+			workerpool.FormatBytes(inUse), workerpool.FormatBytes(poolCfg.MemoryBudget), poolCfg.EffectiveWorkers())
+	}
+	remaining := numSamples - firstSample
+
+	// Samples stream through encrypt -> evaluate -> decrypt, so only a bounded
+	// number of encrypted samples is alive at once however long the file is.
+	fmt.Println("\nStarting FHE evaluation suite...")
+	cfg := pipeline.Config{
+		EncryptWorkers:  *encryptWorkersFlag,
+		EvaluateWorkers: poolCfg.EffectiveWorkers(),
+		DecryptWorkers:  *decryptWorkersFlag,
+		QueueDepth:      *queueDepthFlag,
+	}
+	fmt.Printf("  Workers: %d encrypt / %d evaluate / %d decrypt, queue depth %d\n",
+		cfg.EncryptWorkers, cfg.EvaluateWorkers, cfg.DecryptWorkers, cfg.QueueDepth)
+	stages := pipeline.Stages[encryptedSample, evaluatedSample, result]{
+		Encrypt: func() func(int) encryptedSample {
+			localEvaluator := evaluator.ShallowCopy()
+			localEcd := ecd.ShallowCopy()
+			localEncryptor := encryptor.ShallowCopy()
+			return func(idx int) encryptedSample {
+				return encryptSample(localEvaluator, localEcd, localEncryptor, firstSample+idx)
+			}
+		},
+		Evaluate: func() func(int, encryptedSample) evaluatedSample {
+			w := newEvalWorker()
+			return func(_ int, in encryptedSample) evaluatedSample {
+				return evaluateSample(w, in)
+			}
+		},
+		Decrypt: func() func(int, evaluatedSample) result {
+			localEvaluator := evaluator.ShallowCopy()
+			localEcd := ecd.ShallowCopy()
+			localDecryptor := decryptor.ShallowCopy()
+			return func(_ int, out evaluatedSample) result {
+				output := criteo.Run_inference__decrypt__result0(localEvaluator, params, localEcd, localDecryptor, out.output)
+				return result{output: output[0], latency: time.Since(out.start), evalTime: out.evalTime}
+			}
+		},
+	}
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Printf("Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
+	mem := workerpool.TakeMemSnapshot()
+	stats := pipeline.Run(remaining, cfg, stages, func(i int, res result) {
+		idx := firstSample + i
+		results[idx] = res
+		s := samples[idx]
+		if s.hasCleartext {
+			fmt.Printf("Sample %3d: label %v, FHE %+.6f, cleartext %+.6f (error %.2e), latency %v\n",
+				idx, s.label, res.output, s.cleartext, math.Abs(float64(res.output-s.cleartext)), res.latency)
+		} else {
+			fmt.Printf("Sample %3d: label %v, FHE %+.6f, latency %v\n", idx, s.label, res.output, res.latency)
+		}
+	})
+	memDelta := mem.Since()
+	if err := stopProfiles(); err != nil {
+		fmt.Printf("Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
+
+	correct, agree, withCleartext := 0, 0, 0
+	var maxError float64
+	latencies := make([]time.Duration, 0, numSamples)
+	evalTimes := make([]time.Duration, 0, numSamples)
+	for idx, res := range results {
+		s := samples[idx]
+		predicted := res.output >= clickThreshold
+		if predicted == (s.label >= clickThreshold) {
+			correct++
+		}
+		if s.hasCleartext {
+			withCleartext++
+			if predicted == (s.cleartext >= clickThreshold) {
+				agree++
+			}
+			maxError = math.Max(maxError, math.Abs(float64(res.output-s.cleartext)))
+		}
+		latencies = append(latencies, res.latency)
+		evalTimes = append(evalTimes, res.evalTime)
+	}
+	sort.Slice(latencies, func(i, j int) bool { return latencies[i] < latencies[j] })
+	sort.Slice(evalTimes, func(i, j int) bool { return evalTimes[i] < evalTimes[j] })
+
+	fmt.Println("\n================================================================================")
+	fmt.Println("  Criteo HE-LRM FHE Suite Summary")
+	fmt.Println("================================================================================")
+	fmt.Printf("Samples Evaluated:         %d\n", numSamples)
+	fmt.Printf("Accuracy vs Labels:        %d/%d (%.2f%%)\n", correct, numSamples, float64(correct)/float64(numSamples)*100.0)
+	if withCleartext > 0 {
+		fmt.Printf("Agreement vs Cleartext:    %d/%d (%.2f%%)\n", agree, withCleartext, float64(agree)/float64(withCleartext)*100.0)
+		fmt.Printf("Max |FHE - Cleartext|:     %.3e\n", maxError)
+	}
+	if remaining > 0 {
+		fmt.Printf("Throughput:                %.4f samples/s (%v wall time for %d samples)\n",
+			float64(remaining)/stats.Total.Seconds(), stats.Total, remaining)
+		fmt.Printf("Time to First Result:      %v, max samples in flight: %d\n", stats.FirstResult, stats.MaxInFlight)
+	}
+	fmt.Printf("E2E Latency p50/p99:       %v / %v\n", pipeline.Percentile(latencies, 50), pipeline.Percentile(latencies, 99))
+	fmt.Printf("Eval Latency p50/p99:      %v / %v\n", pipeline.Percentile(evalTimes, 50), pipeline.Percentile(evalTimes, 99))
+	fmt.Printf("Peak RSS:                  %s\n", workerpool.FormatBytes(workerpool.PeakRSS()))
+	fmt.Printf("Memory:                    %v\n", memDelta)
+	fmt.Println("================================================================================")
+}
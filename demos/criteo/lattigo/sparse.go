@@ -0,0 +1,153 @@
+package main
+
+import (
+	"fmt"
+
+	"fully_homomorphic_encryption/demos/common/go/npy"
+)
+
+// Widths of the model inputs: 13 dense features and two blocks of 13 one-hot
+// fields each (see SPLIT_1_SIZES and SPLIT_2_SIZES in utils/sample_data.py).
+const (
+	denseWidth  = 13
+	sparseWidth = 23873
+)
+
+// sparseFeatures holds the active entries of one sparse input block.
+type sparseFeatures struct {
+	indices []int32
+	values  []float32
+}
+
+// expand materializes the block as the dense slot vector expected by the
+// generated encryption functions. It is only called on the client, right
+// before encoding, so samples are stored and loaded with their active
+// entries only.
+func (f sparseFeatures) expand(width int) ([]float32, error) {
+	out := make([]float32, width)
+	for i, idx := range f.indices {
+		if idx < 0 || int(idx) >= width {
+			return nil, fmt.Errorf("sparse index %d out of range [0, %d)", idx, width)
+		}
+		out[idx] = f.values[i]
+	}
+	return out, nil
+}
+
+type sparseSample struct {
+	dense  []float32
+	sparse [2]sparseFeatures
+	label  float32
+	// cleartext is the output of the cleartext model, if the NPZ has it.
+	cleartext    float32
+	hasCleartext bool
+}
+
+// inputs returns the dense features and the two expanded sparse blocks, in
+// the order of the generated encryption functions.
+func (s sparseSample) inputs() (input0, input1, input2 []float32, err error) {
+	if len(s.dense) != denseWidth {
+		return nil, nil, nil, fmt.Errorf("%d dense features, want %d", len(s.dense), denseWidth)
+	}
+	if input1, err = s.sparse[0].expand(sparseWidth); err != nil {
+		return nil, nil, nil, err
+	}
+	if input2, err = s.sparse[1].expand(sparseWidth); err != nil {
+		return nil, nil, nil, err
+	}
+	return s.dense, input1, input2, nil
+}
+
+// loadSparseSamples reads an NPZ written by utils/sparsify_sample.py.
+func loadSparseSamples(npzPath string) ([]sparseSample, error) {
+	arrays, err := npy.ReadNPZ(npzPath)
+	if err != nil {
+		return nil, err
+	}
+	get := func(name string) (*npy.Array, error) {
+		arr, ok := arrays[name]
+		if !ok {
+			return nil, fmt.Errorf("%s: missing array %q", npzPath, name)
+		}
+		return arr, nil
+	}
+
+	denseArr, err := get("dense")
+	if err != nil {
+		return nil, err
+	}
+	if len(denseArr.Shape) != 2 || denseArr.Shape[1] != denseWidth {
+		return nil, fmt.Errorf("%s: dense has shape %v, want [N %d]", npzPath, denseArr.Shape, denseWidth)
+	}
+	dense, err := denseArr.Float32s()
+	if err != nil {
+		return nil, fmt.Errorf("%s: dense: %w", npzPath, err)
+	}
+	labelsArr, err := get("labels")
+	if err != nil {
+		return nil, err
+	}
+	labels, err := labelsArr.Float32s()
+	if err != nil {
+		return nil, fmt.Errorf("%s: labels: %w", npzPath, err)
+	}
+	numSamples := denseArr.Shape[0]
+	if len(labels) != numSamples {
+		return nil, fmt.Errorf("%s: %d labels for %d samples", npzPath, len(labels), numSamples)
+	}
+
+	var cleartext []float32
+	if arr, ok := arrays["cleartext"]; ok {
+		if cleartext, err = arr.Float32s(); err != nil {
+			return nil, fmt.Errorf("%s: cleartext: %w", npzPath, err)
+		}
+		if len(cleartext) != numSamples {
+			return nil, fmt.Errorf("%s: %d cleartext outputs for %d samples", npzPath, len(cleartext), numSamples)
+		}
+	}
+
+	samples := make([]sparseSample, numSamples)
+	for i := range samples {
+		samples[i].dense = dense[i*denseWidth : (i+1)*denseWidth]
+		samples[i].label = labels[i]
+		if cleartext != nil {
+			samples[i].cleartext = cleartext[i]
+			samples[i].hasCleartext = true
+		}
+	}
+	for b := 0; b < 2; b++ {
+		name := fmt.Sprintf("sparse%d", b+1)
+		var ptr, idx []int32
+		var val []float32
+		arr, err := get(name + "_ptr")
+		if err == nil {
+			ptr, err = arr.Int32s()
+		}
+		if err == nil {
+			arr, err = get(name + "_idx")
+		}
+		if err == nil {
+			idx, err = arr.Int32s()
+		}
+		if err == nil {
+			arr, err = get(name + "_val")
+		}
+		if err == nil {
+			val, err = arr.Float32s()
+		}
+		if err != nil {
+			return nil, fmt.Errorf("%s: %s: %w", npzPath, name, err)
+		}
+		if len(ptr) != numSamples+1 || len(idx) != len(val) || int(ptr[numSamples]) != len(idx) {
+			return nil, fmt.Errorf("%s: %s is not a valid CSR matrix", npzPath, name)
+		}
+		for i := range samples {
+			lo, hi := ptr[i], ptr[i+1]
+			if lo < 0 || lo > hi {
+				return nil, fmt.Errorf("%s: %s is not a valid CSR matrix", npzPath, name)
+			}
+			samples[i].sparse[b] = sparseFeatures{indices: idx[lo:hi], values: val[lo:hi]}
+		}
+	}
+	return samples, nil
+}
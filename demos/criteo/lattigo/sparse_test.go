@@ -0,0 +1,56 @@
+package main
+
+import (
+	"reflect"
+	"testing"
+)
+
+func TestExpand(t *testing.T) {
+	f := sparseFeatures{indices: []int32{0, 5}, values: []float32{1, 2}}
+	got, err := f.expand(6)
+	if err != nil || !reflect.DeepEqual(got, []float32{1, 0, 0, 0, 0, 2}) {
+		t.Errorf("expand(6) = %v, %v, want [1 0 0 0 0 2]", got, err)
+	}
+	if got, err := (sparseFeatures{}).expand(3); err != nil || !reflect.DeepEqual(got, []float32{0, 0, 0}) {
+		t.Errorf("expand(3) of an empty block = %v, %v, want [0 0 0]", got, err)
+	}
+	for _, idx := range []int32{-1, 6} {
+		f := sparseFeatures{indices: []int32{idx}, values: []float32{1}}
+		if _, err := f.expand(6); err == nil {
+			t.Errorf("expand(6) with index %d succeeded", idx)
+		}
+	}
+}
+
+func TestInputs(t *testing.T) {
+	s := sparseSample{
+		dense: make([]float32, denseWidth),
+		sparse: [2]sparseFeatures{
+			{indices: []int32{3}, values: []float32{1}},
+			{indices: []int32{sparseWidth - 1}, values: []float32{2}},
+		},
+	}
+	input0, input1, input2, err := s.inputs()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(input0) != denseWidth || len(input1) != sparseWidth || len(input2) != sparseWidth {
+		t.Fatalf("inputs() widths = %d, %d, %d, want %d, %d, %d",
+			len(input0), len(input1), len(input2), denseWidth, sparseWidth, sparseWidth)
+	}
+	if input1[3] != 1 || input2[sparseWidth-1] != 2 {
+		t.Errorf("inputs() lost the active entries: input1[3] = %v, input2[%d] = %v", input1[3], sparseWidth-1, input2[sparseWidth-1])
+	}
+
+	outOfRange := s
+	outOfRange.sparse[1] = sparseFeatures{indices: []int32{sparseWidth}, values: []float32{1}}
+	if _, _, _, err := outOfRange.inputs(); err == nil {
+		t.Errorf("inputs() with sparse index %d succeeded", sparseWidth)
+	}
+
+	narrow := s
+	narrow.dense = make([]float32, denseWidth-1)
+	if _, _, _, err := narrow.inputs(); err == nil {
+		t.Errorf("inputs() with %d dense features succeeded", denseWidth-1)
+	}
+}
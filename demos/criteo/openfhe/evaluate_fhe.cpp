@@ -0,0 +1,116 @@
+// Runs a single inference of the HE-LRM model with OpenFHE on synthetic
+// inputs and reports the size of the evaluation keys and the peak RSS after
+// each phase, to size the machines the model fits on.
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "demos/common/openfhe/keystore.h"
+#include "demos/criteo/openfhe/criteo.inc.h"
+#include "src/pke/include/openfhe.h"
+
+ABSL_FLAG(std::string, key_dir, "",
+          "Directory to load the context and keys from, or to save them to on "
+          "the first run (empty means generate fresh keys)");
+
+namespace {
+
+// Widths of the model inputs: 13 dense features and two blocks of 13 one-hot
+// fields each, as in the Lattigo driver.
+constexpr int kDenseWidth = 13;
+constexpr int kSparseWidth = 23873;
+
+using Clock = std::chrono::steady_clock;
+
+double SecondsSince(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+std::string GiB(int64_t bytes) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2)
+      << static_cast<double>(bytes) / (int64_t{1} << 30) << " GiB";
+  return out.str();
+}
+
+void PrintPhase(const std::string& phase, Clock::time_point t0) {
+  std::cout << "  Took " << SecondsSince(t0) << " s, peak RSS "
+            << GiB(PeakRssBytes()) << " after " << phase << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  const std::string key_dir = absl::GetFlag(FLAGS_key_dir);
+
+  std::cout << "Configuring OpenFHE context..." << std::endl;
+  auto t0 = Clock::now();
+  auto configured = Configure(key_dir, run_inference__generate_crypto_context,
+                              run_inference__configure_crypto_context);
+  if (!configured.ok()) {
+    std::cerr << "Error configuring OpenFHE context: " << configured.status()
+              << std::endl;
+    return 1;
+  }
+  auto [cc, keys, loaded] = *std::move(configured);
+  PrintPhase(loaded ? "loading the keys" : "key generation", t0);
+
+  const EvalKeyFootprint footprint = MeasureEvalKeys(keys);
+  std::cout << "  Ring dimension " << cc->GetRingDimension() << ", "
+            << footprint.rotation_keys << " rotation keys ("
+            << GiB(footprint.rotation_key_bytes) << "), relinearization key "
+            << GiB(footprint.eval_mult_key_bytes) << std::endl;
+
+  std::cout << "Running preprocessing..." << std::endl;
+  t0 = Clock::now();
+  auto prep = run_inference__preprocessing(cc);
+  PrintPhase("preprocessing", t0);
+
+  std::cout << "Encrypting synthetic inputs and zeros..." << std::endl;
+  t0 = Clock::now();
+  auto ct0 = run_inference__encrypt__arg0(
+      cc, std::vector<float>(kDenseWidth, 1.0), keys.publicKey);
+  auto ct1 = run_inference__encrypt__arg1(
+      cc, std::vector<float>(kSparseWidth, 0.5), keys.publicKey);
+  auto ct2 = run_inference__encrypt__arg2(
+      cc, std::vector<float>(kSparseWidth, 0.2), keys.publicKey);
+  auto zero0 = run_inference__encrypt__zero__0(cc, keys.publicKey);
+  auto zero1 = run_inference__encrypt__zero__1(cc, keys.publicKey);
+  auto zero2 = run_inference__encrypt__zero__2(cc, keys.publicKey);
+  auto zero3 = run_inference__encrypt__zero__3(cc, keys.publicKey);
+  auto zero4 = run_inference__encrypt__zero__4(cc, keys.publicKey);
+  auto zero5 = run_inference__encrypt__zero__5(cc, keys.publicKey);
+  auto zero6 = run_inference__encrypt__zero__6(cc, keys.publicKey);
+  PrintPhase("encryption", t0);
+
+  std::cout << "Running FHE evaluation (preprocessed)..." << std::endl;
+  t0 = Clock::now();
+  auto output = run_inference__preprocessed(cc, ct0, ct1, ct2, zero0, zero1,
+                                            zero2, zero3, zero4, zero5, zero6,
+                                            prep);
+  PrintPhase("evaluation", t0);
+
+  std::cout << "Decrypting output..." << std::endl;
+  t0 = Clock::now();
+  auto logit = run_inference__decrypt__result0(cc, output, keys.secretKey);
+  PrintPhase("decryption", t0);
+
+  std::cout << "Output logit: " << logit[0] << std::endl;
+  std::cout << "\n--- Memory ---" << std::endl;
+  std::cout << "Rotation keys:        " << footprint.rotation_keys << " ("
+            << GiB(footprint.rotation_key_bytes) << ")" << std::endl;
+  std::cout << "Relinearization key:  " << GiB(footprint.eval_mult_key_bytes)
+            << std::endl;
+  std::cout << "Peak RSS:             " << GiB(PeakRssBytes()) << std::endl;
+  return 0;
+}
@@ -0,0 +1,95 @@
+"""Converts a sample.pt written by sample_data.py to a sparse NPZ.
+
+The sparse features of a Criteo sample are one-hot per field, so almost all of
+the 2 x 23873 values are zero. The NPZ keeps only the active entries of each
+sparse block in CSR form:
+
+  dense          float32 [N, 13]
+  sparse{b}_ptr  int32   [N + 1]  row i owns entries ptr[i]:ptr[i + 1]
+  sparse{b}_idx  int32   [nnz]    active index within block b
+  sparse{b}_val  float32 [nnz]    value at that index (1.0 for one-hot)
+  labels         float32 [N]
+  cleartext      float32 [N]      output of the cleartext model (with --model)
+
+for b in {1, 2}, matching sparse_x1 and sparse_x2 of sample.pt.
+"""
+
+import argparse
+
+import numpy as np
+import torch
+
+from demos.criteo.torch.model import CriteoHELRM
+
+SPLIT_1_SIZES = [1836] * 12 + [1841]
+SPLIT_2_SIZES = [1836] * 12 + [1841]
+
+
+def to_csr(block):
+  block = block.numpy()
+  ptr = [0]
+  idx = []
+  val = []
+  for row in block:
+    (active,) = np.nonzero(row)
+    idx.extend(active.tolist())
+    val.extend(row[active].tolist())
+    ptr.append(len(idx))
+  return (
+      np.asarray(ptr, dtype=np.int32),
+      np.asarray(idx, dtype=np.int32),
+      np.asarray(val, dtype=np.float32),
+  )
+
+
+def main():
+  parser = argparse.ArgumentParser()
+  parser.add_argument(
+      '--input', type=str, required=True, help='Path to sample.pt'
+  )
+  parser.add_argument(
+      '--output', type=str, required=True, help='Path to save the sparse NPZ'
+  )
+  parser.add_argument(
+      '--model',
+      type=str,
+      default=None,
+      help='Path to criteohelrm.pth, to store the cleartext model outputs',
+  )
+  args = parser.parse_args()
+
+  sample = torch.load(args.input, map_location='cpu')
+  arrays = {
+      'dense': sample['dense'].numpy().astype(np.float32),
+      'labels': sample['labels'].reshape(-1).numpy().astype(np.float32),
+  }
+  for b, key in ((1, 'sparse_x1'), (2, 'sparse_x2')):
+    ptr, idx, val = to_csr(sample[key])
+    arrays[f'sparse{b}_ptr'] = ptr
+    arrays[f'sparse{b}_idx'] = idx
+    arrays[f'sparse{b}_val'] = val
+
+  if args.model:
+    model = CriteoHELRM(SPLIT_1_SIZES + SPLIT_2_SIZES)
+    checkpoint = torch.load(args.model, map_location='cpu')
+    state_dict = (
+        checkpoint['weights']
+        if isinstance(checkpoint, dict) and 'weights' in checkpoint
+        else checkpoint
+    )
+    model.load_state_dict(model.remap_orion_state_dict(state_dict))
+    model.eval()
+    with torch.no_grad():
+      outputs = model(
+          sample['dense'], sample['sparse_x1'], sample['sparse_x2']
+      )
+    arrays['cleartext'] = outputs.reshape(-1).numpy().astype(np.float32)
+
+  # np.savez appends .npz to names without it, which would break genrule outs.
+  with open(args.output, 'wb') as f:
+    np.savez(f, **arrays)
+  print(f'Saved {len(arrays["labels"])} sparse samples to {args.output}')
+
+
+if __name__ == '__main__':
+  main()
@@ -7,52 +7,47 @@ import (
 	"os"
 	"time"
 
-	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
+	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_data"
 	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_lattigo"
 	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_lattigo_utils"
 )
 
-var labels = [12]string{
-	"_silence_",
-	"_unknown_",
-	"yes",
-	"no",
-	"up",
-	"down",
-	"left",
-	"right",
-	"on",
-	"off",
-	"stop",
-	"go",
-}
-
 func main() {
 	sampleIdxFlag := flag.Int("sample_idx", 0, "Sample index in the NPZ to test")
-	npzPathFlag := flag.String("npz_path", "test_data.npz", "Path to the test NPZ file")
+	npzPathFlag := flag.String("npz_path", hotword_data.DefaultNPZPath, "Path to the test NPZ file")
+	keyFlags := keystore.RegisterFlags()
 	flag.Parse()
 
-	npzPath := *npzPathFlag
-	if npzPath == "test_data.npz" {
-		npzPath = pathutils.ResolvePath("fully_homomorphic_encryption/demos/hotword/data/test_data.npz")
-	}
+	npzPath := hotword_data.ResolvePath(*npzPathFlag)
 	sampleIdx := *sampleIdxFlag
 
 	fmt.Printf("Loading test sample %d from %s...\n", sampleIdx, npzPath)
 	t0 := time.Now()
-	features, expectedLabel, err := loadTestRow(npzPath, sampleIdx)
+	features, expectedLabel, shape, err := hotword_data.LoadSample(npzPath, sampleIdx)
 	if err != nil {
 		fmt.Printf("Error loading test row: %v\n", err)
 		os.Exit(1)
 	}
 	fmt.Printf("  Took %v\n", time.Since(t0))
-	fmt.Printf("  Expected label: %s (%d)\n", labels[expectedLabel], expectedLabel)
-	fmt.Printf("  Feature vector size: %d\n", len(features))
+	fmt.Printf("  Expected label: %s (%d)\n", hotword_data.Labels[expectedLabel], expectedLabel)
+	fmt.Printf("  Feature shape: %v\n", shape)
+
+	keyOpts, err := keyFlags.Options()
+	if err != nil {
+		fmt.Printf("Error: %v\n", err)
+		os.Exit(1)
+	}
 
 	// Configure context
 	fmt.Println("Configuring Lattigo context...")
 	t0 = time.Now()
-	btpEvaluator, evaluator, params, ecd, encryptor, decryptor := hotword_lattigo.Tcresnet8small__configure()
+	btpEvaluator, evaluator, params, ecd, encryptor, decryptor, err := keystore.ConfigureBootstrapping(keyFlags.Dir(), hotword_lattigo.Tcresnet8small__configure, keyOpts...)
+	if err != nil {
+		fmt.Printf("Error configuring Lattigo context: %v\n", err)
+		os.Exit(1)
+	}
 	fmt.Printf("  Took %v\n", time.Since(t0))
 
 	// Encrypt input
@@ -67,6 +62,12 @@ func main() {
 	preprocessedWeights := hotword_lattigo_utils.Tcresnet8small__preprocessing(params, ecd)
 	fmt.Printf("  Took %v\n", time.Since(t0))
 
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Printf("Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
 	// FHE evaluation
 	fmt.Println("Running FHE evaluation (preprocessed)...")
 	t0 = time.Now()
@@ -86,6 +87,10 @@ func main() {
 		preprocessedWeights,
 	)
 	fmt.Printf("  Took %v\n", time.Since(t0))
+	if err := stopProfiles(); err != nil {
+		fmt.Printf("Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
 
 	// Decrypt
 	fmt.Println("Decrypting output...")
@@ -95,16 +100,8 @@ func main() {
 
 	fmt.Printf("Decrypted logits: %v\n", decryptedLogits)
 
-	// Argmax
-	predictedClass := 0
-	maxVal := decryptedLogits[0]
-	for i := 1; i < 12; i++ {
-		if decryptedLogits[i] > maxVal {
-			maxVal = decryptedLogits[i]
-			predictedClass = i
-		}
-	}
-	fmt.Printf("Predicted class: %s (%d)\n", labels[predictedClass], predictedClass)
+	predictedClass := hotword_data.Argmax(decryptedLogits)
+	fmt.Printf("Predicted class: %s (%d)\n", hotword_data.Labels[predictedClass], predictedClass)
 
 	if predictedClass == expectedLabel {
 		fmt.Println("SUCCESS: Predicted class matches expected label!")
@@ -0,0 +1,272 @@
+// Evaluate keyword spotting on a continuous stream of overlapping windows
+package main
+
+import (
+	"flag"
+	"fmt"
+	"os"
+	"runtime"
+	"sort"
+	"time"
+
+	"fully_homomorphic_encryption/demos/common/go/pipeline"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
+	"fully_homomorphic_encryption/demos/common/lattigo/recycle"
+	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_data"
+	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_lattigo"
+	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_lattigo_utils"
+	"github.com/tuneinsight/lattigo/v6/circuits/ckks/bootstrapping"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
+)
+
+// defaultFrameMs is the frame hop of the small model's features: 320 samples
+// at 16 kHz, see demos/hotword/train/train_tc_resnet.py.
+const defaultFrameMs = 20.0
+
+// featureStream holds the concatenated frames of consecutive clips, one row
+// per MFCC coefficient, as a client would accumulate them from a microphone.
+// A model input is a window of windowFrames consecutive frames of every row.
+type featureStream struct {
+	rows         [][]float32
+	windowFrames int
+	clipLabels   []int
+}
+
+// newFeatureStream concatenates clips of the given shape, [coefficients
+// frames], along their frames.
+func newFeatureStream(clips [][]float32, clipLabels []int, shape []int) (*featureStream, error) {
+	if len(shape) != 2 {
+		return nil, fmt.Errorf("clip shape %v, want [coefficients frames]", shape)
+	}
+	numRows, windowFrames := shape[0], shape[1]
+	s := &featureStream{
+		rows:         make([][]float32, numRows),
+		windowFrames: windowFrames,
+		clipLabels:   clipLabels,
+	}
+	for _, clip := range clips {
+		for row := range s.rows {
+			s.rows[row] = append(s.rows[row], clip[row*windowFrames:(row+1)*windowFrames]...)
+		}
+	}
+	return s, nil
+}
+
+func (s *featureStream) frames() int {
+	return len(s.rows[0])
+}
+
+// window returns the model input for the frames [start, start+windowFrames).
+func (s *featureStream) window(start int) []float32 {
+	features := make([]float32, 0, len(s.rows)*s.windowFrames)
+	for _, row := range s.rows {
+		features = append(features, row[start:start+s.windowFrames]...)
+	}
+	return features
+}
+
+// centerLabel returns the label of the clip under the center of the window.
+func (s *featureStream) centerLabel(start int) int {
+	return s.clipLabels[(start+s.windowFrames/2)/s.windowFrames]
+}
+
+// streamWorker holds one evaluation worker's Lattigo objects and zero
+// accumulators for its lifetime.
+type streamWorker struct {
+	evaluator    *ckks.Evaluator
+	btpEvaluator *bootstrapping.Evaluator
+	ecd          *ckks.Encoder
+	encryptor    *rlwe.Encryptor
+	zeros        *recycle.Zeros
+}
+
+type encryptedWindow struct {
+	start    time.Time
+	features []*rlwe.Ciphertext
+}
+
+type evaluatedWindow struct {
+	start  time.Time
+	output []*rlwe.Ciphertext
+}
+
+type detection struct {
+	class   int
+	latency time.Duration
+}
+
+func main() {
+	npzPathFlag := flag.String("npz_path", hotword_data.DefaultNPZPath, "Path to the test NPZ file")
+	clipsFlag := flag.Int("clips", 10, "Number of consecutive test clips concatenated into the stream")
+	hopFlag := flag.Int("hop", 0, "Frames between the starts of consecutive windows (0 means half a window)")
+	frameMsFlag := flag.Float64("frame_ms", defaultFrameMs, "Duration of one feature frame in milliseconds, to compare throughput with real time")
+	workersFlag := flag.Int("workers", runtime.NumCPU(), "Maximum number of windows evaluated concurrently")
+	queueDepthFlag := flag.Int("queue_depth", 2, "Maximum number of windows waiting between two pipeline stages")
+	keyFlags := keystore.RegisterFlags()
+	flag.Parse()
+
+	npzPath := hotword_data.ResolvePath(*npzPathFlag)
+	fmt.Printf("Loading test data from %s...\n", npzPath)
+	t0 := time.Now()
+	samples, err := hotword_data.Load(npzPath, *clipsFlag)
+	if err != nil {
+		fmt.Printf("Error loading test data: %v\n", err)
+		os.Exit(1)
+	}
+	numClips := len(samples.Features)
+	if numClips == 0 {
+		fmt.Println("Error: no clips loaded")
+		os.Exit(1)
+	}
+	stream, err := newFeatureStream(samples.Features, samples.Labels, samples.Shape)
+	if err != nil {
+		fmt.Printf("Error: %v\n", err)
+		os.Exit(1)
+	}
+	windowFrames := stream.windowFrames
+	hop := *hopFlag
+	if hop == 0 {
+		hop = windowFrames / 2
+	}
+	if hop < 1 || hop > windowFrames {
+		fmt.Printf("Error: -hop must be in [1, %d]\n", windowFrames)
+		os.Exit(1)
+	}
+	numWindows := (stream.frames()-windowFrames)/hop + 1
+	hopDuration := time.Duration(float64(hop) * *frameMsFlag * float64(time.Millisecond))
+	fmt.Printf("  Loaded %d clips of shape %v (%d frames) in %v\n", numClips, samples.Shape, stream.frames(), time.Since(t0))
+	fmt.Printf("  %d windows of %d frames, hop %d frames (%v), overlap %.0f%%\n",
+		numWindows, windowFrames, hop, hopDuration, 100*float64(windowFrames-hop)/float64(windowFrames))
+
+	keyOpts, err := keyFlags.Options()
+	if err != nil {
+		fmt.Printf("Error: %v\n", err)
+		os.Exit(1)
+	}
+
+	// Configure context (ONCE)
+	fmt.Println("Configuring Lattigo context...")
+	t0 = time.Now()
+	btpEvaluator, evaluator, params, ecd, encryptor, decryptor, err := keystore.ConfigureBootstrapping(keyFlags.Dir(), hotword_lattigo.Tcresnet8small__configure, keyOpts...)
+	if err != nil {
+		fmt.Printf("Error configuring Lattigo context: %v\n", err)
+		os.Exit(1)
+	}
+	fmt.Printf("  Took %v\n", time.Since(t0))
+
+	// Preprocessing (ONCE)
+	fmt.Println("Running preprocessing for model weights...")
+	t0 = time.Now()
+	preprocessedWeights := hotword_lattigo_utils.Tcresnet8small__preprocessing(params, ecd)
+	fmt.Printf("  Took %v\n", time.Since(t0))
+
+	// Windows flow through encrypt -> evaluate -> decrypt, so a new hop can be
+	// encrypted while earlier ones are still being evaluated.
+	cfg := pipeline.Config{
+		EncryptWorkers:  1,
+		EvaluateWorkers: *workersFlag,
+		DecryptWorkers:  1,
+		QueueDepth:      *queueDepthFlag,
+	}
+	fmt.Printf("\nStarting streaming FHE evaluation on %d evaluation workers...\n", cfg.EvaluateWorkers)
+	stages := pipeline.Stages[encryptedWindow, evaluatedWindow, detection]{
+		Encrypt: func() func(int) encryptedWindow {
+			localEvaluator := evaluator.ShallowCopy()
+			localEcd := ecd.ShallowCopy()
+			localEncryptor := encryptor.ShallowCopy()
+			return func(idx int) encryptedWindow {
+				start := time.Now()
+				features := stream.window(idx * hop)
+				return encryptedWindow{
+					start:    start,
+					features: hotword_lattigo.Tcresnet8small__encrypt__arg0(localEvaluator, params, localEcd, localEncryptor, features),
+				}
+			}
+		},
+		Evaluate: func() func(int, encryptedWindow) evaluatedWindow {
+			w := &streamWorker{
+				evaluator:    evaluator.ShallowCopy(),
+				btpEvaluator: btpEvaluator.ShallowCopy(),
+				ecd:          ecd.ShallowCopy(),
+				encryptor:    encryptor.ShallowCopy(),
+			}
+			return func(_ int, in encryptedWindow) evaluatedWindow {
+				if w.zeros == nil {
+					w.zeros = recycle.NewZeros(
+						hotword_lattigo.Tcresnet8small__encrypt__zero__0(w.evaluator, params, w.ecd, w.encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__1(w.evaluator, params, w.ecd, w.encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__2(w.evaluator, params, w.ecd, w.encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__3(w.evaluator, params, w.ecd, w.encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__4(w.evaluator, params, w.ecd, w.encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__5(w.evaluator, params, w.ecd, w.encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__6(w.evaluator, params, w.ecd, w.encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__7(w.evaluator, params, w.ecd, w.encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__8(w.evaluator, params, w.ecd, w.encryptor),
+					)
+				} else if err := w.zeros.Refresh(w.encryptor); err != nil {
+					fmt.Printf("Error: %v\n", err)
+					os.Exit(1)
+				}
+				z := w.zeros
+				out := hotword_lattigo.Tcresnet8small__preprocessed(
+					w.btpEvaluator, w.evaluator, params, w.ecd, in.features,
+					z.Get(0), z.Get(1), z.Get(2), z.Get(3), z.Get(4), z.Get(5), z.Get(6), z.Get(7), z.Get(8),
+					preprocessedWeights,
+				)
+				z.Detach(out)
+				return evaluatedWindow{start: in.start, output: out}
+			}
+		},
+		Decrypt: func() func(int, evaluatedWindow) detection {
+			localEvaluator := evaluator.ShallowCopy()
+			localEcd := ecd.ShallowCopy()
+			localDecryptor := decryptor.ShallowCopy()
+			return func(_ int, out evaluatedWindow) detection {
+				logits := hotword_lattigo.Tcresnet8small__decrypt__result0(localEvaluator, params, localEcd, localDecryptor, out.output)
+				return detection{class: hotword_data.Argmax(logits), latency: time.Since(out.start)}
+			}
+		},
+	}
+
+	frameSeconds := *frameMsFlag / 1000
+	latencies := make([]time.Duration, 0, numWindows)
+	correct := 0
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Printf("Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
+	stats := pipeline.Run(numWindows, cfg, stages, func(idx int, det detection) {
+		start := idx * hop
+		expected := stream.centerLabel(start)
+		if det.class == expected {
+			correct++
+		}
+		latencies = append(latencies, det.latency)
+		fmt.Printf("Window %3d [%6.2fs - %6.2fs]: %-9s (center clip %-9s), latency %v\n",
+			idx, float64(start)*frameSeconds, float64(start+windowFrames)*frameSeconds,
+			hotword_data.Labels[det.class], hotword_data.Labels[expected], det.latency)
+	})
+	if err := stopProfiles(); err != nil {
+		fmt.Printf("Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
+	sort.Slice(latencies, func(i, j int) bool { return latencies[i] < latencies[j] })
+
+	perHop := stats.Total / time.Duration(numWindows)
+	fmt.Println("\n================================================================================")
+	fmt.Println("  Streaming Hotword FHE Evaluation Summary")
+	fmt.Println("================================================================================")
+	fmt.Printf("Windows Evaluated:         %d (hop %v)\n", numWindows, hopDuration)
+	fmt.Printf("Agreement with Center Clip: %d/%d (%.2f%%)\n", correct, numWindows, float64(correct)/float64(numWindows)*100.0)
+	fmt.Printf("Stream Duration:           %v\n", stats.Total)
+	fmt.Printf("Throughput:                %.3f windows/s (one window per %v)\n", float64(numWindows)/stats.Total.Seconds(), perHop)
+	fmt.Printf("Real-time Factor:          %.2f (processing time per hop / hop duration; <= 1 keeps up)\n",
+		float64(perHop)/float64(hopDuration))
+	fmt.Printf("Window Latency p50/p99:    %v / %v\n", pipeline.Percentile(latencies, 50), pipeline.Percentile(latencies, 99))
+	fmt.Printf("Time to First Result:      %v, max windows in flight: %d\n", stats.FirstResult, stats.MaxInFlight)
+	fmt.Println("================================================================================")
+}
@@ -5,157 +5,382 @@ import (
 	"flag"
 	"fmt"
 	"os"
-	"sync"
+	"runtime"
+	"runtime/debug"
 	"time"
 
-	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/pipeline"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
+	"fully_homomorphic_encryption/demos/common/go/suitereport"
+	"fully_homomorphic_encryption/demos/common/go/workerpool"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
+	"fully_homomorphic_encryption/demos/common/lattigo/recycle"
+	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_data"
 	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_lattigo"
 	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_lattigo_utils"
+	"github.com/tuneinsight/lattigo/v6/circuits/ckks/bootstrapping"
 	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
 )
 
-var labels = [12]string{
-	"_silence_",
-	"_unknown_",
-	"yes",
-	"no",
-	"up",
-	"down",
-	"left",
-	"right",
-	"on",
-	"off",
-	"stop",
-	"go",
+// encryptedSample holds the encrypted input features of one sample together
+// with the zero accumulators the generated code expects. When the evaluation
+// workers recycle their own accumulators, zeros is left empty.
+type encryptedSample struct {
+	features []*rlwe.Ciphertext
+	zeros    [9]*rlwe.Ciphertext
+}
+
+func encryptZeros(evaluator *ckks.Evaluator, params ckks.Parameters, ecd *ckks.Encoder, encryptor *rlwe.Encryptor) [9]*rlwe.Ciphertext {
+	return [9]*rlwe.Ciphertext{
+		hotword_lattigo.Tcresnet8small__encrypt__zero__0(evaluator, params, ecd, encryptor),
+		hotword_lattigo.Tcresnet8small__encrypt__zero__1(evaluator, params, ecd, encryptor),
+		hotword_lattigo.Tcresnet8small__encrypt__zero__2(evaluator, params, ecd, encryptor),
+		hotword_lattigo.Tcresnet8small__encrypt__zero__3(evaluator, params, ecd, encryptor),
+		hotword_lattigo.Tcresnet8small__encrypt__zero__4(evaluator, params, ecd, encryptor),
+		hotword_lattigo.Tcresnet8small__encrypt__zero__5(evaluator, params, ecd, encryptor),
+		hotword_lattigo.Tcresnet8small__encrypt__zero__6(evaluator, params, ecd, encryptor),
+		hotword_lattigo.Tcresnet8small__encrypt__zero__7(evaluator, params, ecd, encryptor),
+		hotword_lattigo.Tcresnet8small__encrypt__zero__8(evaluator, params, ecd, encryptor),
+	}
+}
+
+func encryptSample(evaluator *ckks.Evaluator, params ckks.Parameters, ecd *ckks.Encoder, encryptor *rlwe.Encryptor, features []float32, withZeros bool) encryptedSample {
+	sample := encryptedSample{
+		features: hotword_lattigo.Tcresnet8small__encrypt__arg0(evaluator, params, ecd, encryptor, features),
+	}
+	if withZeros {
+		sample.zeros = encryptZeros(evaluator, params, ecd, encryptor)
+	}
+	return sample
+}
+
+// evalWorker holds one evaluation worker's Lattigo objects for its lifetime.
+// With recycling, it also owns the zero accumulators and re-encrypts them in
+// place before every sample instead of receiving fresh ones with the input.
+type evalWorker struct {
+	evaluator    *ckks.Evaluator
+	btpEvaluator *bootstrapping.Evaluator
+	ecd          *ckks.Encoder
+	encryptor    *rlwe.Encryptor
+	zeros        *recycle.Zeros
+}
+
+// cryptoWorker holds one encryption or decryption worker's copies of the
+// Lattigo objects. Only the fields its phase needs are set.
+type cryptoWorker struct {
+	evaluator *ckks.Evaluator
+	ecd       *ckks.Encoder
+	encryptor *rlwe.Encryptor
+	decryptor *rlwe.Decryptor
 }
 
 func main() {
-	npzPathFlag := flag.String("npz_path", "test_data.npz", "Path to the test NPZ file")
+	npzPathFlag := flag.String("npz_path", hotword_data.DefaultNPZPath, "Path to the test NPZ file")
 	limitFlag := flag.Int("limit", 0, "Limit number of samples to test (0 means all)")
+	pipelineFlag := flag.Bool("pipeline", false, "Run encryption, evaluation and decryption as concurrent stages connected by bounded queues")
+	workersFlag := flag.Int("workers", runtime.NumCPU(), "Maximum number of concurrent evaluation workers")
+	maxMemoryFlag := flag.String("max_memory", "", "Total memory budget, e.g. 96GiB; reduces -workers so that concurrent evaluations fit (empty means unlimited)")
+	encryptWorkersFlag := flag.Int("encrypt_workers", 0, "Number of concurrent encryption workers (0 means one per CPU, or 1 in pipeline mode)")
+	decryptWorkersFlag := flag.Int("decrypt_workers", 0, "Number of concurrent decryption workers (0 means one per CPU, or 1 in pipeline mode)")
+	queueDepthFlag := flag.Int("queue_depth", 2, "Maximum number of samples waiting between two pipeline stages")
+	recycleFlag := flag.Bool("recycle", true, "Keep evaluator copies and zero accumulators per worker and re-encrypt the accumulators in place, instead of allocating both per sample")
+	keyFlags := keystore.RegisterFlags()
+	reportFlag := flag.String("report", "", "Write a suite report for compare_backends to this file")
 	flag.Parse()
 
-	npzPath := *npzPathFlag
-	if npzPath == "test_data.npz" {
-		npzPath = pathutils.ResolvePath("fully_homomorphic_encryption/demos/hotword/data/test_data.npz")
+	maxMemory, err := workerpool.ParseBytes(*maxMemoryFlag)
+	if err != nil {
+		fmt.Printf("Error parsing -max_memory: %v\n", err)
+		os.Exit(1)
 	}
 
+	// Encryption and decryption run as their own phases unless pipelined, in
+	// which case they share the CPUs with evaluation.
+	encryptWorkers, decryptWorkers := *encryptWorkersFlag, *decryptWorkersFlag
+	defaultWorkers := runtime.NumCPU()
+	if *pipelineFlag {
+		defaultWorkers = 1
+	}
+	if encryptWorkers <= 0 {
+		encryptWorkers = defaultWorkers
+	}
+	if decryptWorkers <= 0 {
+		decryptWorkers = defaultWorkers
+	}
+
+	npzPath := hotword_data.ResolvePath(*npzPathFlag)
+
 	fmt.Printf("Loading test data from %s...\n", npzPath)
 	t0 := time.Now()
-	allFeatures, expectedLabels, err := loadAllTestRows(npzPath)
+	samples, err := hotword_data.Load(npzPath, *limitFlag)
 	if err != nil {
 		fmt.Printf("Error loading test data: %v\n", err)
 		os.Exit(1)
 	}
+	allFeatures, expectedLabels := samples.Features, samples.Labels
 	numSamples := len(allFeatures)
-	if *limitFlag > 0 && *limitFlag < numSamples {
-		numSamples = *limitFlag
-		allFeatures = allFeatures[:numSamples]
-		expectedLabels = expectedLabels[:numSamples]
+	if numSamples == 0 {
+		fmt.Printf("Error: no samples in %s\n", npzPath)
+		os.Exit(1)
 	}
+	suiteReport := suitereport.New("hotword", "lattigo", numSamples)
 	fmt.Printf("  Loaded %d samples in %v\n", numSamples, time.Since(t0))
 
+	keyOpts, err := keyFlags.Options()
+	if err != nil {
+		fmt.Printf("Error: %v\n", err)
+		os.Exit(1)
+	}
+
 	// Configure context (ONCE)
 	fmt.Println("Configuring Lattigo context...")
 	t0 = time.Now()
-	btpEvaluator, evaluator, params, ecd, encryptor, decryptor := hotword_lattigo.Tcresnet8small__configure()
+	btpEvaluator, evaluator, params, ecd, encryptor, decryptor, err := keystore.ConfigureBootstrapping(keyFlags.Dir(), hotword_lattigo.Tcresnet8small__configure, keyOpts...)
+	if err != nil {
+		fmt.Printf("Error configuring Lattigo context: %v\n", err)
+		os.Exit(1)
+	}
+	suiteReport.Setup = time.Since(t0).Seconds()
 	fmt.Printf("  Took %v\n", time.Since(t0))
+	if keys, ok := evaluator.GetEvaluationKeySet().(interface{ BinarySize() int }); ok {
+		suiteReport.EvalKeyBytes = int64(keys.BinarySize())
+	}
 
 	// Preprocessing (ONCE)
 	fmt.Println("Running preprocessing for model weights...")
 	t0 = time.Now()
 	preprocessedWeights := hotword_lattigo_utils.Tcresnet8small__preprocessing(params, ecd)
+	suiteReport.Preprocessing = time.Since(t0).Seconds()
 	fmt.Printf("  Took %v\n", time.Since(t0))
 
-	// 1. Sequential Encryption
-	fmt.Println("Encrypting all input features and zero accumulators sequentially...")
-	t0 = time.Now()
-	encryptedInputs := make([][]*rlwe.Ciphertext, numSamples)
-	ctZeros0 := make([]*rlwe.Ciphertext, numSamples)
-	ctZeros1 := make([]*rlwe.Ciphertext, numSamples)
-	ctZeros2 := make([]*rlwe.Ciphertext, numSamples)
-	ctZeros3 := make([]*rlwe.Ciphertext, numSamples)
-	ctZeros4 := make([]*rlwe.Ciphertext, numSamples)
-	ctZeros5 := make([]*rlwe.Ciphertext, numSamples)
-	ctZeros6 := make([]*rlwe.Ciphertext, numSamples)
-	ctZeros7 := make([]*rlwe.Ciphertext, numSamples)
-	ctZeros8 := make([]*rlwe.Ciphertext, numSamples)
-	for i := 0; i < numSamples; i++ {
-		encryptedInputs[i] = hotword_lattigo.Tcresnet8small__encrypt__arg0(evaluator, params, ecd, encryptor, allFeatures[i])
-		ctZeros0[i] = hotword_lattigo.Tcresnet8small__encrypt__zero__0(evaluator, params, ecd, encryptor)
-		ctZeros1[i] = hotword_lattigo.Tcresnet8small__encrypt__zero__1(evaluator, params, ecd, encryptor)
-		ctZeros2[i] = hotword_lattigo.Tcresnet8small__encrypt__zero__2(evaluator, params, ecd, encryptor)
-		ctZeros3[i] = hotword_lattigo.Tcresnet8small__encrypt__zero__3(evaluator, params, ecd, encryptor)
-		ctZeros4[i] = hotword_lattigo.Tcresnet8small__encrypt__zero__4(evaluator, params, ecd, encryptor)
-		ctZeros5[i] = hotword_lattigo.Tcresnet8small__encrypt__zero__5(evaluator, params, ecd, encryptor)
-		ctZeros6[i] = hotword_lattigo.Tcresnet8small__encrypt__zero__6(evaluator, params, ecd, encryptor)
-		ctZeros7[i] = hotword_lattigo.Tcresnet8small__encrypt__zero__7(evaluator, params, ecd, encryptor)
-		ctZeros8[i] = hotword_lattigo.Tcresnet8small__encrypt__zero__8(evaluator, params, ecd, encryptor)
+	predictions := make([]int, numSamples)
+	report := func(idx int, predictedClass int) {
+		predictions[idx] = predictedClass
+		expectedLabel := expectedLabels[idx]
+		status := "MISCLASSIFIED"
+		if predictedClass == expectedLabel {
+			status = "SUCCESS"
+		}
+		fmt.Printf("Sample %3d: expected %s (%d), got %s (%d) (%s)\n",
+			idx, hotword_data.Labels[expectedLabel], expectedLabel, hotword_data.Labels[predictedClass], predictedClass, status)
 	}
-	fmt.Printf("  Took %v\n", time.Since(t0))
 
-	// 2. Parallel FHE Evaluation
-	fmt.Println("\nStarting parallel FHE evaluation suite...")
-	encryptedOutputs := make([][]*rlwe.Ciphertext, numSamples)
-
-	var wg sync.WaitGroup
-	wg.Add(numSamples)
-
-	suiteStartTime := time.Now()
-	for i := 0; i < numSamples; i++ {
-		go func(idx int) {
-			defer wg.Done()
-			localEvaluator := evaluator.ShallowCopy()
-			localBtpEvaluator := btpEvaluator.ShallowCopy()
-			encryptedOutputs[idx] = hotword_lattigo.Tcresnet8small__preprocessed(
-				localBtpEvaluator, localEvaluator, params, ecd, encryptedInputs[idx],
-				ctZeros0[idx], ctZeros1[idx], ctZeros2[idx], ctZeros3[idx], ctZeros4[idx], ctZeros5[idx], ctZeros6[idx], ctZeros7[idx], ctZeros8[idx],
-				preprocessedWeights,
-			)
-		}(i)
-	}
-
-	wg.Wait()
-	totalEvalTime := time.Since(suiteStartTime)
-	fmt.Printf("  Parallel evaluation completed in %v (average %v per sample, wall time)\n", totalEvalTime, totalEvalTime/time.Duration(numSamples))
-
-	// 3. Sequential Decryption & Verification
-	fmt.Println("\nDecrypting and verifying results sequentially...")
-	correctCount := 0
-	var misclassifications []struct {
-		idx  int
-		exp  int
-		pred int
+	recycling := *recycleFlag
+	newEvalWorker := func() *evalWorker {
+		w := &evalWorker{evaluator: evaluator.ShallowCopy(), btpEvaluator: btpEvaluator.ShallowCopy(), ecd: ecd.ShallowCopy()}
+		if recycling {
+			w.encryptor = encryptor.ShallowCopy()
+		}
+		return w
+	}
+	evaluateSample := func(w *evalWorker, idx int, in encryptedSample) []*rlwe.Ciphertext {
+		zeros := in.zeros
+		if recycling {
+			if w.zeros == nil {
+				z := encryptZeros(w.evaluator, params, w.ecd, w.encryptor)
+				w.zeros = recycle.NewZeros(z[:]...)
+			} else if err := w.zeros.Refresh(w.encryptor); err != nil {
+				fmt.Printf("Error: %v\n", err)
+				os.Exit(1)
+			}
+			for i := range zeros {
+				zeros[i] = w.zeros.Get(i)
+			}
+		} else {
+			// Fresh evaluator copies per sample, for comparison with recycling.
+			w = &evalWorker{evaluator: evaluator.ShallowCopy(), btpEvaluator: btpEvaluator.ShallowCopy(), ecd: w.ecd}
+		}
+		tEval := time.Now()
+		out := hotword_lattigo.Tcresnet8small__preprocessed(
+			w.btpEvaluator, w.evaluator, params, w.ecd, in.features,
+			zeros[0], zeros[1], zeros[2], zeros[3], zeros[4], zeros[5], zeros[6], zeros[7], zeros[8],
+			preprocessedWeights,
+		)
+		suiteReport.EvalLatency[idx] = time.Since(tEval).Seconds()
+		if recycling {
+			w.zeros.Detach(out)
+		}
+		return out
 	}
 
-	for idx := 0; idx < numSamples; idx++ {
-		decryptedLogits := hotword_lattigo.Tcresnet8small__decrypt__result0(evaluator, params, ecd, decryptor, encryptedOutputs[idx])
-
-		// Argmax
-		predictedClass := 0
-		maxVal := decryptedLogits[0]
-		for i := 1; i < 12; i++ {
-			if decryptedLogits[i] > maxVal {
-				maxVal = decryptedLogits[i]
-				predictedClass = i
+	// With a memory budget, run the first sample alone to measure how much
+	// memory one evaluation keeps alive, and size the worker pool from it.
+	poolCfg := workerpool.Config{Workers: *workersFlag}
+	firstSample := 0
+	if maxMemory > 0 {
+		debug.SetMemoryLimit(maxMemory)
+		fmt.Println("Measuring per-sample memory footprint on sample 0...")
+		t0 = time.Now()
+		var out []*rlwe.Ciphertext
+		poolCfg.TaskFootprint = workerpool.MeasureFootprint(func() {
+			in := encryptSample(evaluator, params, ecd, encryptor, allFeatures[0], !recycling)
+			out = evaluateSample(newEvalWorker(), 0, in)
+		})
+		fmt.Printf("  Took %v, footprint %s per sample\n", time.Since(t0), workerpool.FormatBytes(poolCfg.TaskFootprint))
+		report(0, hotword_data.Argmax(hotword_lattigo.Tcresnet8small__decrypt__result0(evaluator, params, ecd, decryptor, out)))
+		firstSample = 1
+	}
+	// Size the pool before any input is encrypted: what is in use now (keys,
+	// weights) is reserved, and the rest of the budget goes to the samples.
+	var inUse int64
+	if maxMemory > 0 {
+		inUse = workerpool.HeapInUse()
+		poolCfg.MemoryBudget = maxMemory - inUse
+		if poolCfg.MemoryBudget < poolCfg.TaskFootprint {
+			fmt.Printf("  Warning: %s already in use, budget leaves no room for concurrent samples\n", workerpool.FormatBytes(inUse))
+			poolCfg.MemoryBudget = poolCfg.TaskFootprint
+		}
+		fmt.Printf("  Memory: %s in use, %s budget for samples -> up to %d workers\n",
+			workerpool.FormatBytes(inUse), workerpool.FormatBytes(poolCfg.MemoryBudget), poolCfg.EffectiveWorkers())
+	}
+	remaining := numSamples - firstSample
+
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Printf("Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
+	if *pipelineFlag {
+		// Encrypt -> evaluate -> decrypt as concurrent stages. Only a bounded
+		// number of samples is in flight at any time, and results are reported
+		// as soon as each sample leaves the decrypt stage.
+		fmt.Println("\nStarting pipelined FHE evaluation suite...")
+		cfg := pipeline.Config{
+			EncryptWorkers:  encryptWorkers,
+			EvaluateWorkers: poolCfg.EffectiveWorkers(),
+			DecryptWorkers:  decryptWorkers,
+			QueueDepth:      *queueDepthFlag,
+		}
+		fmt.Printf("  Workers: %d encrypt / %d evaluate / %d decrypt, queue depth %d\n",
+			cfg.EncryptWorkers, cfg.EvaluateWorkers, cfg.DecryptWorkers, cfg.QueueDepth)
+		stages := pipeline.Stages[encryptedSample, []*rlwe.Ciphertext, int]{
+			Encrypt: func() func(int) encryptedSample {
+				localEvaluator := evaluator.ShallowCopy()
+				localEcd := ecd.ShallowCopy()
+				localEncryptor := encryptor.ShallowCopy()
+				return func(idx int) encryptedSample {
+					return encryptSample(localEvaluator, params, localEcd, localEncryptor, allFeatures[firstSample+idx], !recycling)
+				}
+			},
+			Evaluate: func() func(int, encryptedSample) []*rlwe.Ciphertext {
+				w := newEvalWorker()
+				return func(idx int, in encryptedSample) []*rlwe.Ciphertext {
+					return evaluateSample(w, firstSample+idx, in)
+				}
+			},
+			Decrypt: func() func(int, []*rlwe.Ciphertext) int {
+				localEvaluator := evaluator.ShallowCopy()
+				localEcd := ecd.ShallowCopy()
+				localDecryptor := decryptor.ShallowCopy()
+				return func(_ int, out []*rlwe.Ciphertext) int {
+					return hotword_data.Argmax(hotword_lattigo.Tcresnet8small__decrypt__result0(localEvaluator, params, localEcd, localDecryptor, out))
+				}
+			},
+		}
+		mem := workerpool.TakeMemSnapshot()
+		stats := pipeline.Run(remaining, cfg, stages, func(idx int, predictedClass int) {
+			report(firstSample+idx, predictedClass)
+		})
+		memDelta := mem.Since()
+		if remaining > 0 {
+			fmt.Printf("\n  Pipelined suite completed in %v (average %v per sample, wall time)\n",
+				stats.Total, stats.Total/time.Duration(remaining))
+			fmt.Printf("  Time to first result: %v, max samples in flight: %d\n", stats.FirstResult, stats.MaxInFlight)
+			fmt.Printf("  Memory (recycle=%v): %v\n", recycling, memDelta)
+		}
+		// The phases overlap, so the whole pipeline counts as evaluation.
+		suiteReport.Evaluate = stats.Total.Seconds()
+	} else {
+		// 1. Parallel Encryption (each worker owns ShallowCopies of the
+		// encoder, encryptor and evaluator, which are not thread-safe)
+		if recycling {
+			fmt.Printf("Encrypting all input features on %d workers...\n", encryptWorkers)
+		} else {
+			fmt.Printf("Encrypting all input features and zero accumulators on %d workers...\n", encryptWorkers)
+		}
+		encryptedInputs := make([]encryptedSample, numSamples)
+		encStats := workerpool.Run(remaining, workerpool.Config{Workers: encryptWorkers},
+			func() cryptoWorker {
+				return cryptoWorker{evaluator: evaluator.ShallowCopy(), ecd: ecd.ShallowCopy(), encryptor: encryptor.ShallowCopy()}
+			},
+			func(w cryptoWorker, i int) {
+				idx := firstSample + i
+				encryptedInputs[idx] = encryptSample(w.evaluator, params, w.ecd, w.encryptor, allFeatures[idx], !recycling)
+			})
+		fmt.Printf("  Took %v\n", encStats.Total)
+		suiteReport.Encrypt = encStats.Total.Seconds()
+		if maxMemory > 0 {
+			// The encrypted inputs take part of the budget until their
+			// evaluation frees them, so fewer samples are admitted at first.
+			if poolCfg.Pending = workerpool.HeapInUse() - inUse; poolCfg.Pending < 0 {
+				poolCfg.Pending = 0
 			}
+			fmt.Printf("  Encrypted inputs: %s of the budget\n", workerpool.FormatBytes(poolCfg.Pending))
 		}
 
-		expectedLabel := expectedLabels[idx]
-		isCorrect := (predictedClass == expectedLabel)
-		status := "MISCLASSIFIED"
-		if isCorrect {
-			status = "SUCCESS"
+		// 2. Parallel FHE Evaluation on a bounded worker pool, so at most
+		// EffectiveWorkers bootstrapping evaluators and intermediate ciphertext
+		// sets are alive.
+		fmt.Println("\nStarting parallel FHE evaluation suite...")
+		encryptedOutputs := make([][]*rlwe.Ciphertext, numSamples)
+		mem := workerpool.TakeMemSnapshot()
+		stats := workerpool.Run(remaining, poolCfg, newEvalWorker,
+			func(w *evalWorker, i int) {
+				idx := firstSample + i
+				encryptedOutputs[idx] = evaluateSample(w, idx, encryptedInputs[idx])
+				// The inputs are not needed anymore; let the GC reclaim them.
+				encryptedInputs[idx] = encryptedSample{}
+			})
+		memDelta := mem.Since()
+		suiteReport.Evaluate = stats.Total.Seconds()
+		if remaining > 0 {
+			fmt.Printf("  Parallel evaluation on %d workers completed in %v (average %v per sample, wall time, %.3f samples/s)\n",
+				stats.Workers, stats.Total, stats.Total/time.Duration(remaining), float64(remaining)/stats.Total.Seconds())
+			if maxMemory > 0 {
+				fmt.Printf("  Peak reserved: %s, admission wait: %v\n", workerpool.FormatBytes(stats.PeakReserved), stats.AdmissionWait)
+			}
+			fmt.Printf("  Memory (recycle=%v): %v\n", recycling, memDelta)
+		}
+
+		// 3. Parallel Decryption, then Verification in sample order
+		fmt.Printf("\nDecrypting results on %d workers...\n", decryptWorkers)
+		predictedClasses := make([]int, numSamples)
+		decStats := workerpool.Run(remaining, workerpool.Config{Workers: decryptWorkers},
+			func() cryptoWorker {
+				return cryptoWorker{evaluator: evaluator.ShallowCopy(), ecd: ecd.ShallowCopy(), decryptor: decryptor.ShallowCopy()}
+			},
+			func(w cryptoWorker, i int) {
+				idx := firstSample + i
+				decryptedLogits := hotword_lattigo.Tcresnet8small__decrypt__result0(w.evaluator, params, w.ecd, w.decryptor, encryptedOutputs[idx])
+				predictedClasses[idx] = hotword_data.Argmax(decryptedLogits)
+			})
+		fmt.Printf("  Took %v\n\n", decStats.Total)
+		suiteReport.Decrypt = decStats.Total.Seconds()
+		for idx := firstSample; idx < numSamples; idx++ {
+			report(idx, predictedClasses[idx])
+		}
+	}
+	if err := stopProfiles(); err != nil {
+		fmt.Printf("Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
+
+	correctCount := 0
+	var misclassifications []int
+	for idx := 0; idx < numSamples; idx++ {
+		if predictions[idx] == expectedLabels[idx] {
 			correctCount++
 		} else {
-			misclassifications = append(misclassifications, struct {
-				idx  int
-				exp  int
-				pred int
-			}{idx, expectedLabel, predictedClass})
+			misclassifications = append(misclassifications, idx)
 		}
+	}
 
-		fmt.Printf("Sample %3d: expected %s (%d), got %s (%d) (%s)\n",
-			idx, labels[expectedLabel], expectedLabel, labels[predictedClass], predictedClass, status)
+	suiteReport.Correct = correctCount
+	if err := suiteReport.Write(*reportFlag); err != nil {
+		fmt.Printf("Error writing report: %v\n", err)
+		os.Exit(1)
 	}
 
 	accuracy := float64(correctCount) / float64(numSamples)
@@ -163,9 +388,9 @@ func main() {
 
 	if len(misclassifications) > 0 {
 		fmt.Println("\nSummary of Misclassifications:")
-		for _, m := range misclassifications {
+		for _, idx := range misclassifications {
 			fmt.Printf("  Sample %3d: expected %s (%d), got %s (%d)\n",
-				m.idx, labels[m.exp], m.exp, labels[m.pred], m.pred)
+				idx, hotword_data.Labels[expectedLabels[idx]], expectedLabels[idx], hotword_data.Labels[predictions[idx]], predictions[idx])
 		}
 	} else {
 		fmt.Println("\nNO MISCLASSIFICATIONS!")
@@ -7,47 +7,32 @@ import (
 	"os"
 	"time"
 
-	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
+	"fully_homomorphic_encryption/demos/common/lattigo/debug"
+	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_data"
 	"fully_homomorphic_encryption/demos/hotword/lattigo/hotwordlattigotiming"
 	"fully_homomorphic_encryption/demos/hotword/lattigo/hotwordlattigotiming_utils"
 )
 
-var labels = [12]string{
-	"_silence_",
-	"_unknown_",
-	"yes",
-	"no",
-	"up",
-	"down",
-	"left",
-	"right",
-	"on",
-	"off",
-	"stop",
-	"go",
-}
-
 func main() {
 	sampleIdxFlag := flag.Int("sample_idx", 0, "Sample index in the NPZ to test")
-	npzPathFlag := flag.String("npz_path", "test_data.npz", "Path to the test NPZ file")
+	npzPathFlag := flag.String("npz_path", hotword_data.DefaultNPZPath, "Path to the test NPZ file")
+	profileBootstrapFlag := flag.Bool("profile_bootstrap", true, "Profile one bootstrap and report the bootstrap share of each section")
 	flag.Parse()
 
-	npzPath := *npzPathFlag
-	if npzPath == "test_data.npz" {
-		npzPath = pathutils.ResolvePath("fully_homomorphic_encryption/demos/hotword/data/test_data.npz")
-	}
+	npzPath := hotword_data.ResolvePath(*npzPathFlag)
 	sampleIdx := *sampleIdxFlag
 
 	fmt.Printf("Loading test sample %d from %s...\n", sampleIdx, npzPath)
 	t0 := time.Now()
-	features, expectedLabel, err := loadTestRow(npzPath, sampleIdx)
+	features, expectedLabel, shape, err := hotword_data.LoadSample(npzPath, sampleIdx)
 	if err != nil {
 		fmt.Printf("Error loading test row: %v\n", err)
 		os.Exit(1)
 	}
 	fmt.Printf("  Took %v\n", time.Since(t0))
-	fmt.Printf("  Expected label: %s (%d)\n", labels[expectedLabel], expectedLabel)
-	fmt.Printf("  Feature vector size: %d\n", len(features))
+	fmt.Printf("  Expected label: %s (%d)\n", hotword_data.Labels[expectedLabel], expectedLabel)
+	fmt.Printf("  Feature shape: %v\n", shape)
 
 	// Configure context
 	fmt.Println("Configuring Lattigo context...")
@@ -55,6 +40,19 @@ func main() {
 	btpEvaluator, evaluator, params, ecd, encryptor, decryptor := hotwordlattigotiming.Tcresnet8small__configure()
 	fmt.Printf("  Took %v\n", time.Since(t0))
 
+	// Bootstrapping profile, used to attribute bootstrap time to each section
+	if *profileBootstrapFlag {
+		fmt.Println("Profiling bootstrapping...")
+		t0 = time.Now()
+		profile, err := debug.ProfileBootstrapping(btpEvaluator, params, encryptor)
+		if err != nil {
+			fmt.Printf("Error profiling bootstrapping: %v\n", err)
+			os.Exit(1)
+		}
+		fmt.Print(profile)
+		fmt.Printf("  Took %v\n", time.Since(t0))
+	}
+
 	// Encrypt input
 	fmt.Println("Encrypting input features...")
 	t0 = time.Now()
@@ -67,6 +65,12 @@ func main() {
 	preprocessedWeights := hotwordlattigotiming_utils.Tcresnet8small__preprocessing(params, ecd)
 	fmt.Printf("  Took %v\n", time.Since(t0))
 
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Printf("Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
 	// FHE evaluation
 	fmt.Println("Running FHE evaluation (preprocessed with timing)...")
 	t0 = time.Now()
@@ -87,6 +91,11 @@ func main() {
 		preprocessedWeights,
 	)
 	fmt.Printf("  Took %v\n", time.Since(t0))
+	if err := stopProfiles(); err != nil {
+		fmt.Printf("Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
+	debug.PrintBootstrapSummary()
 
 	// Decrypt
 	fmt.Println("Decrypting output...")
@@ -96,16 +105,8 @@ func main() {
 
 	fmt.Printf("Decrypted logits: %v\n", decryptedLogits)
 
-	// Argmax
-	predictedClass := 0
-	maxVal := decryptedLogits[0]
-	for i := 1; i < 12; i++ {
-		if decryptedLogits[i] > maxVal {
-			maxVal = decryptedLogits[i]
-			predictedClass = i
-		}
-	}
-	fmt.Printf("Predicted class: %s (%d)\n", labels[predictedClass], predictedClass)
+	predictedClass := hotword_data.Argmax(decryptedLogits)
+	fmt.Printf("Predicted class: %s (%d)\n", hotword_data.Labels[predictedClass], predictedClass)
 
 	if predictedClass == expectedLabel {
 		fmt.Println("SUCCESS: Predicted class matches expected label!")
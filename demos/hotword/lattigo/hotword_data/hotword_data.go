@@ -0,0 +1,121 @@
+// Package hotword_data loads the Speech Commands test clips of the hotword
+// demo, with the shape the NPZ file stores them in.
+package hotword_data
+
+import (
+	"errors"
+	"fmt"
+	"os"
+
+	"fully_homomorphic_encryption/demos/common/go/npy"
+	"fully_homomorphic_encryption/demos/common/go/pathutils"
+)
+
+// DefaultNPZPath is the workspace-relative test file, shared with the OpenFHE
+// drivers (demos/hotword/openfhe/hotword_samples.py).
+const DefaultNPZPath = "demos/hotword/data/test_data-small.npz"
+
+// Labels are the keyword classes, in the order of the model outputs.
+var Labels = [12]string{
+	"_silence_",
+	"_unknown_",
+	"yes",
+	"no",
+	"up",
+	"down",
+	"left",
+	"right",
+	"on",
+	"off",
+	"stop",
+	"go",
+}
+
+// Argmax returns the predicted class among the keyword labels.
+func Argmax(logits []float32) int {
+	best := 0
+	for i := 1; i < len(Labels) && i < len(logits); i++ {
+		if logits[i] > logits[best] {
+			best = i
+		}
+	}
+	return best
+}
+
+// Samples holds test clips and their labels.
+type Samples struct {
+	// Features holds one flattened clip per sample, in row-major order.
+	Features [][]float32
+	Labels   []int
+	// Shape is the shape of one clip, e.g. [10 48]: the model input without
+	// its batch dimension.
+	Shape []int
+}
+
+// ResolvePath returns path if it exists, and otherwise resolves it as a
+// workspace-relative path in the runfiles.
+func ResolvePath(path string) string {
+	if _, err := os.Stat(path); err == nil {
+		return path
+	}
+	return pathutils.ResolvePath("fully_homomorphic_encryption/" + path)
+}
+
+// Load reads the first limit clips of an NPZ file with an X (or x) float32
+// array of clips and a y int64 array of labels. limit <= 0 reads all clips.
+func Load(npzPath string, limit int) (*Samples, error) {
+	arrays, err := npy.ReadNPZ(npzPath)
+	if err != nil {
+		return nil, err
+	}
+	xArr := arrays["X"]
+	if xArr == nil {
+		xArr = arrays["x"]
+	}
+	yArr := arrays["y"]
+	if xArr == nil || yArr == nil {
+		return nil, errors.New("X.npy or y.npy not found in npz")
+	}
+	if len(xArr.Shape) < 2 || len(yArr.Shape) != 1 || yArr.Shape[0] != xArr.Shape[0] {
+		return nil, fmt.Errorf("mismatched shapes %v and %v", xArr.Shape, yArr.Shape)
+	}
+	x, err := xArr.Float32s()
+	if err != nil {
+		return nil, fmt.Errorf("failed to parse X.npy: %w", err)
+	}
+	y, err := yArr.Int64s()
+	if err != nil {
+		return nil, fmt.Errorf("failed to parse y.npy: %w", err)
+	}
+
+	numSamples := xArr.Shape[0]
+	if limit > 0 && limit < numSamples {
+		numSamples = limit
+	}
+	clipSize := 1
+	for _, dim := range xArr.Shape[1:] {
+		clipSize *= dim
+	}
+	samples := &Samples{
+		Features: make([][]float32, numSamples),
+		Labels:   make([]int, numSamples),
+		Shape:    xArr.Shape[1:],
+	}
+	for i := 0; i < numSamples; i++ {
+		samples.Features[i] = x[i*clipSize : (i+1)*clipSize]
+		samples.Labels[i] = int(y[i])
+	}
+	return samples, nil
+}
+
+// LoadSample reads clip idx of an NPZ file.
+func LoadSample(npzPath string, idx int) (features []float32, label int, shape []int, err error) {
+	samples, err := Load(npzPath, idx+1)
+	if err != nil {
+		return nil, 0, nil, err
+	}
+	if idx < 0 || idx >= len(samples.Features) {
+		return nil, 0, nil, fmt.Errorf("sample index %d out of bounds (total %d)", idx, len(samples.Features))
+	}
+	return samples.Features[idx], samples.Labels[idx], samples.Shape, nil
+}
@@ -0,0 +1,53 @@
+package hotword_data
+
+import (
+	"slices"
+	"testing"
+)
+
+func TestLoad(t *testing.T) {
+	samples, err := Load(ResolvePath(DefaultNPZPath), 5)
+	if err != nil {
+		t.Fatalf("Load failed: %v", err)
+	}
+	if len(samples.Features) != 5 || len(samples.Labels) != 5 {
+		t.Fatalf("got %d clips and %d labels, want 5", len(samples.Features), len(samples.Labels))
+	}
+	// The model input is tensor<1x10x48xf32>.
+	if !slices.Equal(samples.Shape, []int{10, 48}) {
+		t.Errorf("got clip shape %v, want [10 48]", samples.Shape)
+	}
+	for i, clip := range samples.Features {
+		if len(clip) != 10*48 {
+			t.Errorf("clip %d has %d values, want %d", i, len(clip), 10*48)
+		}
+		if label := samples.Labels[i]; label < 0 || label >= len(Labels) {
+			t.Errorf("clip %d has label %d out of range", i, label)
+		}
+	}
+}
+
+func TestLoadSample(t *testing.T) {
+	path := ResolvePath(DefaultNPZPath)
+	all, err := Load(path, 3)
+	if err != nil {
+		t.Fatalf("Load failed: %v", err)
+	}
+	features, label, _, err := LoadSample(path, 2)
+	if err != nil {
+		t.Fatalf("LoadSample failed: %v", err)
+	}
+	if !slices.Equal(features, all.Features[2]) || label != all.Labels[2] {
+		t.Errorf("LoadSample(2) differs from the third clip of Load")
+	}
+}
+
+func TestArgmax(t *testing.T) {
+	logits := make([]float32, 16)
+	logits[3] = 1
+	// Outputs past the keyword labels are padding and never win.
+	logits[14] = 5
+	if got := Argmax(logits); got != 3 {
+		t.Errorf("Argmax = %d, want 3", got)
+	}
+}
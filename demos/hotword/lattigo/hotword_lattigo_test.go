@@ -0,0 +1,88 @@
+package hotword_lattigo_test
+
+import (
+	"flag"
+	"testing"
+
+	"fully_homomorphic_encryption/demos/common/go/bench"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
+	"fully_homomorphic_encryption/demos/common/lattigo/primitives"
+	"fully_homomorphic_encryption/demos/common/lattigo/recycle"
+	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_data"
+	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_lattigo"
+	"fully_homomorphic_encryption/demos/hotword/lattigo/hotword_lattigo_utils"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+)
+
+var keyDir = flag.String("key_dir", "", "Directory to load keys from, or to save freshly generated keys to")
+
+// numFeatures returns the size of one test clip, the model input.
+func numFeatures(b *testing.B) int {
+	samples, err := hotword_data.Load(hotword_data.ResolvePath(hotword_data.DefaultNPZPath), 1)
+	if err != nil {
+		b.Fatal(err)
+	}
+	return len(samples.Features[0])
+}
+
+func BenchmarkTcresnet8small(b *testing.B) {
+	btpEvaluator, evaluator, params, ecd, encryptor, decryptor, err := keystore.ConfigureBootstrapping(*keyDir, hotword_lattigo.Tcresnet8small__configure)
+	if err != nil {
+		b.Fatal(err)
+	}
+	weights := hotword_lattigo_utils.Tcresnet8small__preprocessing(params, ecd)
+	features := make([]float32, numFeatures(b))
+
+	bench.Run(b, bench.Model[[]*rlwe.Ciphertext, []*rlwe.Ciphertext]{
+		Encrypt: func() func() []*rlwe.Ciphertext {
+			evaluator, ecd, encryptor := evaluator.ShallowCopy(), ecd.ShallowCopy(), encryptor.ShallowCopy()
+			return func() []*rlwe.Ciphertext {
+				return hotword_lattigo.Tcresnet8small__encrypt__arg0(evaluator, params, ecd, encryptor, features)
+			}
+		},
+		Evaluate: func() func([]*rlwe.Ciphertext) []*rlwe.Ciphertext {
+			btpEvaluator, evaluator, ecd, encryptor := btpEvaluator.ShallowCopy(), evaluator.ShallowCopy(), ecd.ShallowCopy(), encryptor.ShallowCopy()
+			var zeros *recycle.Zeros
+			return func(in []*rlwe.Ciphertext) []*rlwe.Ciphertext {
+				if zeros == nil {
+					zeros = recycle.NewZeros(
+						hotword_lattigo.Tcresnet8small__encrypt__zero__0(evaluator, params, ecd, encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__1(evaluator, params, ecd, encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__2(evaluator, params, ecd, encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__3(evaluator, params, ecd, encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__4(evaluator, params, ecd, encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__5(evaluator, params, ecd, encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__6(evaluator, params, ecd, encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__7(evaluator, params, ecd, encryptor),
+						hotword_lattigo.Tcresnet8small__encrypt__zero__8(evaluator, params, ecd, encryptor),
+					)
+				} else if err := zeros.Refresh(encryptor); err != nil {
+					panic(err)
+				}
+				out := hotword_lattigo.Tcresnet8small__preprocessed(
+					btpEvaluator, evaluator, params, ecd, in,
+					zeros.Get(0), zeros.Get(1), zeros.Get(2), zeros.Get(3), zeros.Get(4), zeros.Get(5), zeros.Get(6), zeros.Get(7), zeros.Get(8),
+					weights,
+				)
+				zeros.Detach(out)
+				return out
+			}
+		},
+		Decrypt: func() func([]*rlwe.Ciphertext) {
+			evaluator, ecd, decryptor := evaluator.ShallowCopy(), ecd.ShallowCopy(), decryptor.ShallowCopy()
+			return func(out []*rlwe.Ciphertext) {
+				hotword_lattigo.Tcresnet8small__decrypt__result0(evaluator, params, ecd, decryptor, out)
+			}
+		},
+	})
+}
+
+// BenchmarkPrimitives times each CKKS primitive at every level of the model's
+// parameters.
+func BenchmarkPrimitives(b *testing.B) {
+	btpEvaluator, evaluator, params, ecd, encryptor, _, err := keystore.ConfigureBootstrapping(*keyDir, hotword_lattigo.Tcresnet8small__configure)
+	if err != nil {
+		b.Fatal(err)
+	}
+	primitives.Run(b, params, evaluator, ecd, encryptor, btpEvaluator)
+}
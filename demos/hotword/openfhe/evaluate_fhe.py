@@ -0,0 +1,94 @@
+"""Evaluate the hotword model on a single clip using OpenFHE."""
+
+import argparse
+import time
+
+from demos.hotword.openfhe import hotword_pybind
+from demos.hotword.openfhe import hotword_samples
+
+LABELS = hotword_samples.LABELS
+
+
+def main():
+  parser = argparse.ArgumentParser()
+  parser.add_argument(
+      "--sample_idx", type=int, default=0, help="Index of the test clip"
+  )
+  parser.add_argument(
+      "--npz_path",
+      type=str,
+      default=hotword_samples.DEFAULT_NPZ_PATH,
+      help="Path to the test NPZ file",
+  )
+  args = parser.parse_args()
+
+  print(f"Loading test sample {args.sample_idx} from {args.npz_path}...")
+  t0 = time.time()
+  features, expected_label = hotword_samples.load_sample(
+      args.npz_path, args.sample_idx
+  )
+  print(f"  Took {time.time() - t0:.4f} seconds")
+  print(f"  Expected label: {LABELS[expected_label]} ({expected_label})")
+  print(f"  Feature vector size: {len(features)}")
+
+  print("Generating crypto context...")
+  t0 = time.time()
+  cc = hotword_pybind.tcresnet8small__generate_crypto_context()
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Generating key pair...")
+  t0 = time.time()
+  key_pair = cc.KeyGen()
+  public_key = key_pair.publicKey
+  secret_key = key_pair.secretKey
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Configuring crypto context...")
+  t0 = time.time()
+  cc = hotword_pybind.tcresnet8small__configure_crypto_context(cc, secret_key)
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Encrypting input features...")
+  t0 = time.time()
+  encrypted_features = hotword_pybind.tcresnet8small__encrypt__arg0(
+      cc, features, public_key
+  )
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Running preprocessing...")
+  t0 = time.time()
+  prep_struct = hotword_pybind.tcresnet8small__preprocessing(cc)
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Running FHE evaluation (preprocessed)...")
+  t0 = time.time()
+  ct_zeros = [
+      getattr(hotword_pybind, f"tcresnet8small__encrypt__zero__{i}")(
+          cc, public_key
+      )
+      for i in range(hotword_samples.NUM_ZEROS)
+  ]
+  encrypted_output = hotword_pybind.tcresnet8small__preprocessed(
+      cc, encrypted_features, *ct_zeros, prep_struct
+  )
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Decrypting output...")
+  t0 = time.time()
+  decrypted_logits = hotword_pybind.tcresnet8small__decrypt__result0(
+      cc, encrypted_output, secret_key
+  )
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print(f"Decrypted logits: {decrypted_logits[:len(LABELS)]}")
+  predicted_class = hotword_samples.argmax(decrypted_logits)
+  print(f"Predicted class: {LABELS[predicted_class]} ({predicted_class})")
+
+  if predicted_class == expected_label:
+    print("SUCCESS: Predicted class matches expected label!")
+  else:
+    print("FAILURE: Predicted class does NOT match expected label!")
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,227 @@
+"""Evaluate a suite of test clips using OpenFHE.
+
+The clips are evaluated one after another and each evaluation uses all
+OpenMP threads (set OMP_NUM_THREADS to change their number), so the per-clip
+latencies printed at the end can be compared with those of the Lattigo suite,
+which evaluates one clip per goroutine instead.
+"""
+
+import argparse
+import statistics
+import time
+
+from demos.common.python import pipeline
+from demos.common.python import suite_report
+from demos.hotword.openfhe import hotword_pybind
+from demos.hotword.openfhe import hotword_samples
+
+LABELS = hotword_samples.LABELS
+
+
+def main():
+  parser = argparse.ArgumentParser()
+  parser.add_argument(
+      "--npz_path",
+      type=str,
+      default=hotword_samples.DEFAULT_NPZ_PATH,
+      help="Path to the test NPZ file",
+  )
+  parser.add_argument(
+      "--limit", type=int, default=None, help="Limit number of clips to test"
+  )
+  parser.add_argument(
+      "--pipeline",
+      action="store_true",
+      help=(
+          "Run encryption, evaluation and decryption as concurrent stages"
+          " connected by bounded queues"
+      ),
+  )
+  parser.add_argument(
+      "--encrypt_workers",
+      type=int,
+      default=1,
+      help="Number of encryption threads in pipeline mode",
+  )
+  parser.add_argument(
+      "--evaluate_workers",
+      type=int,
+      default=1,
+      help="Number of evaluation threads in pipeline mode",
+  )
+  parser.add_argument(
+      "--decrypt_workers",
+      type=int,
+      default=1,
+      help="Number of decryption threads in pipeline mode",
+  )
+  parser.add_argument(
+      "--queue_depth",
+      type=int,
+      default=2,
+      help="Maximum number of clips waiting between two pipeline stages",
+  )
+  parser.add_argument(
+      "--report",
+      type=str,
+      default=None,
+      help="Write a suite report for compare_backends to this file",
+  )
+  args = parser.parse_args()
+
+  print(f"Loading test clips from {args.npz_path}...")
+  t0 = time.time()
+  all_features, expected_labels = hotword_samples.load_samples(
+      args.npz_path, args.limit
+  )
+  num_clips = len(all_features)
+  print(f"  Loaded {num_clips} clips in {time.time() - t0:.4f} seconds")
+  report_data = suite_report.SuiteReport("hotword", "openfhe", num_clips)
+
+  # Initialize crypto context (ONCE)
+  print("Generating crypto context...")
+  t_setup = time.time()
+  t0 = time.time()
+  cc = hotword_pybind.tcresnet8small__generate_crypto_context()
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Generating key pair...")
+  t0 = time.time()
+  key_pair = cc.KeyGen()
+  public_key = key_pair.publicKey
+  secret_key = key_pair.secretKey
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Configuring crypto context...")
+  t0 = time.time()
+  cc = hotword_pybind.tcresnet8small__configure_crypto_context(cc, secret_key)
+  print(f"  Took {time.time() - t0:.4f} seconds")
+  report_data.setup_s = time.time() - t_setup
+
+  # Run preprocessing (ONCE)
+  print("Running preprocessing for model weights...")
+  t0 = time.time()
+  prep_struct = hotword_pybind.tcresnet8small__preprocessing(cc)
+  report_data.preprocessing_s = time.time() - t0
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  encrypt_zeros = [
+      getattr(hotword_pybind, f"tcresnet8small__encrypt__zero__{i}")
+      for i in range(hotword_samples.NUM_ZEROS)
+  ]
+
+  def encrypt(idx):
+    t0 = time.perf_counter()
+    # Encrypt input features and zero accumulators
+    encrypted_features = hotword_pybind.tcresnet8small__encrypt__arg0(
+        cc, all_features[idx], public_key
+    )
+    ct_zeros = [fn(cc, public_key) for fn in encrypt_zeros]
+    report_data.record_phase("encrypt", t0, time.perf_counter())
+    return encrypted_features, ct_zeros
+
+  def evaluate(idx, encrypted_inputs):
+    encrypted_features, ct_zeros = encrypted_inputs
+    t0 = time.perf_counter()
+    # Call the FHE function (using preprocessed weights)
+    encrypted_output = hotword_pybind.tcresnet8small__preprocessed(
+        cc,
+        encrypted_features,
+        *ct_zeros,
+        prep_struct,
+    )
+    t1 = time.perf_counter()
+    report_data.eval_latency_s[idx] = t1 - t0
+    report_data.record_phase("evaluate", t0, t1)
+    return encrypted_output
+
+  def decrypt(idx, encrypted_output):
+    t0 = time.perf_counter()
+    decrypted_logits = hotword_pybind.tcresnet8small__decrypt__result0(
+        cc, encrypted_output, secret_key
+    )
+    report_data.record_phase("decrypt", t0, time.perf_counter())
+    return hotword_samples.argmax(decrypted_logits)
+
+  correct_count = 0
+  misclassifications = []
+
+  def report(idx, predicted_class):
+    nonlocal correct_count
+    expected_label = expected_labels[idx]
+    is_correct = predicted_class == expected_label
+    status = "SUCCESS" if is_correct else "MISCLASSIFIED"
+
+    print(
+        f"Sample {idx:3d}: expected {LABELS[expected_label]}"
+        f" ({expected_label}), got {LABELS[predicted_class]}"
+        f" ({predicted_class}) ({status}) | Eval Time"
+        f" {report_data.eval_latency_s[idx]:.2f} s"
+    )
+
+    if is_correct:
+      correct_count += 1
+    else:
+      misclassifications.append((idx, expected_label, predicted_class))
+
+  if args.pipeline:
+    print("\nStarting pipelined FHE evaluation suite...")
+    print(
+        f"  Workers: {args.encrypt_workers} encrypt /"
+        f" {args.evaluate_workers} evaluate / {args.decrypt_workers} decrypt,"
+        f" queue depth {args.queue_depth}"
+    )
+    stats = pipeline.run_pipeline(
+        num_clips,
+        encrypt,
+        evaluate,
+        decrypt,
+        report,
+        encrypt_workers=args.encrypt_workers,
+        evaluate_workers=args.evaluate_workers,
+        decrypt_workers=args.decrypt_workers,
+        queue_depth=args.queue_depth,
+    )
+    total_time = stats.total_s
+    misclassifications.sort()
+    print(
+        f"\nTime to first result: {stats.first_result_s:.2f} seconds, max"
+        f" clips in flight: {stats.max_in_flight}"
+    )
+  else:
+    print("\nStarting FHE evaluation suite...")
+    suite_start_time = time.time()
+    for idx in range(num_clips):
+      report(idx, decrypt(idx, evaluate(idx, encrypt(idx))))
+    total_time = time.time() - suite_start_time
+
+  report_data.correct = correct_count
+  report_data.write(args.report)
+
+  if num_clips == 0:
+    return
+  latencies = sorted(report_data.eval_latency_s)
+  accuracy = correct_count / num_clips
+  print(
+      f"\nSuite completed in {total_time:.2f} seconds (average"
+      f" {total_time/num_clips:.2f}s per clip)"
+  )
+  print(
+      f"Evaluation latency per clip: mean {statistics.mean(latencies):.2f} s,"
+      f" p50 {statistics.median(latencies):.2f} s, max {latencies[-1]:.2f} s"
+  )
+  print(f"Accuracy: {correct_count}/{num_clips} ({accuracy:.2%})")
+
+  if misclassifications:
+    print("\nSummary of Misclassifications:")
+    for idx, exp, pred in misclassifications:
+      print(
+          f"  Sample {idx:3d}: expected {LABELS[exp]} ({exp}), got"
+          f" {LABELS[pred]} ({pred})"
+      )
+  else:
+    print("\nNO MISCLASSIFICATIONS!")
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,58 @@
+"""Loads Speech Commands test samples for the OpenFHE hotword drivers.
+
+Reads the features straight from the test NPZ file with numpy, so that the
+drivers do not pull in torch and librosa for the dataset class.
+"""
+
+import numpy as np
+
+from demos.common.python import path_utils
+
+DEFAULT_NPZ_PATH = "demos/hotword/data/test_data-small.npz"
+
+# Number of zero accumulators the generated code takes after the input, from
+# tcresnet8small__encrypt__zero__0 on.
+NUM_ZEROS = 9
+
+LABELS = (
+    "_silence_",
+    "_unknown_",
+    "yes",
+    "no",
+    "up",
+    "down",
+    "left",
+    "right",
+    "on",
+    "off",
+    "stop",
+    "go",
+)
+
+
+def load_samples(
+    npz_path: str, limit: int | None = None
+) -> tuple[list[list[float]], list[int]]:
+  """Returns the flattened features and labels of the first limit samples."""
+  with np.load(path_utils.resolve_path(npz_path)) as data:
+    x = data["x"] if "x" in data else data["X"]
+    y = data["y"]
+  if limit is not None:
+    x, y = x[:limit], y[:limit]
+  features = [sample.astype(np.float32).flatten().tolist() for sample in x]
+  return features, [int(label) for label in y]
+
+
+def load_sample(npz_path: str, sample_idx: int) -> tuple[list[float], int]:
+  """Returns the flattened features and label of one sample."""
+  with np.load(path_utils.resolve_path(npz_path)) as data:
+    x = data["x"] if "x" in data else data["X"]
+    return (
+        x[sample_idx].astype(np.float32).flatten().tolist(),
+        int(data["y"][sample_idx]),
+    )
+
+
+def argmax(logits) -> int:
+  """Returns the predicted class among the keyword labels."""
+  return int(np.argmax(np.asarray(logits[: len(LABELS)])))
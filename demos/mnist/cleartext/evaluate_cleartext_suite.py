@@ -9,6 +9,7 @@ import numpy as np
 import torch
 
 from demos.common.python import path_utils
+from demos.common.python import suite_report
 from demos.mnist.torch.model import CanonicalMLP
 from demos.mnist.utils.mnist_data import MnistDataset
 
@@ -25,7 +26,11 @@ def load_mnist_suite(
 
 
 def evaluate_suite(
-    model_path: str, data_dir: str, num_samples: int, batch_size: int
+    model_path: str,
+    data_dir: str,
+    num_samples: int,
+    batch_size: int,
+    report_path: str | None = None,
 ) -> None:
   """Evaluates cleartext model over batched MNIST dataset and reports accuracy/throughput."""
   resolved_model_path = resolve_path(model_path)
@@ -73,6 +78,17 @@ def evaluate_suite(
   print(f"Total Evaluation Time:   {total_time:.4f} s")
   print(f"Throughput:              {throughput:.2f} samples/sec")
 
+  # Batches are timed as a whole; each sample gets its share.
+  report_data = suite_report.SuiteReport(
+      "mnist",
+      "cleartext",
+      actual_samples,
+      correct=correct,
+      evaluate_s=total_time,
+      eval_latency_s=[total_time / actual_samples] * actual_samples,
+  )
+  report_data.write(report_path)
+
 
 def main():
   parser = argparse.ArgumentParser(
@@ -104,11 +120,21 @@ def main():
       ),
       help="Directory containing MNIST dataset binary files",
   )
+  parser.add_argument(
+      "--report",
+      type=str,
+      default=None,
+      help="Write a suite report to this file",
+  )
   args = parser.parse_args()
 
   try:
     evaluate_suite(
-        args.model_path, args.data_dir, args.num_samples, args.batch_size
+        args.model_path,
+        args.data_dir,
+        args.num_samples,
+        args.batch_size,
+        args.report,
     )
   except Exception as e:
     print(f"Error executing evaluation suite: {e}", file=sys.stderr)
@@ -9,6 +9,7 @@ import (
 	"time"
 
 	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
 	"fully_homomorphic_encryption/demos/mnist/lattigo/mnist"
 	"fully_homomorphic_encryption/demos/mnist/lattigo/mnist_data"
 	"fully_homomorphic_encryption/demos/mnist/lattigo/mnist_utils"
@@ -51,10 +52,20 @@ func main() {
 	encryptDuration := time.Since(tEncStart)
 	fmt.Printf("Input & Zero Encryption: %.4f ms\n", float64(encryptDuration.Microseconds())/1000.0)
 
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
 	tEvalStart := time.Now()
 	resCt := mnist.Mnist__preprocessed(evaluator, params, encoder, ctInput, ctZeros0, ctZeros1, ctZeros2, preprocessedWeights)
 	evalDuration := time.Since(tEvalStart)
 	fmt.Printf("Homomorphic Evaluation:  %.4f ms\n", float64(evalDuration.Microseconds())/1000.0)
+	if err := stopProfiles(); err != nil {
+		fmt.Fprintf(os.Stderr, "Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
 
 	tDecStart := time.Now()
 	resValues := mnist.Mnist__decrypt__result0(evaluator, params, encoder, decryptor, resCt)
@@ -9,40 +9,58 @@ import (
 	"time"
 
 	"fully_homomorphic_encryption/demos/common/go/pathutils"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
+	"fully_homomorphic_encryption/demos/common/go/suitereport"
+	"fully_homomorphic_encryption/demos/common/go/workerpool"
+	"fully_homomorphic_encryption/demos/common/lattigo/recycle"
 	"fully_homomorphic_encryption/demos/mnist/lattigo/mnist"
 	"fully_homomorphic_encryption/demos/mnist/lattigo/mnist_data"
 	"fully_homomorphic_encryption/demos/mnist/lattigo/mnist_utils"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
 )
 
 var (
-	numSamples = flag.Int("num_samples", 10, "Number of test samples to evaluate sequentially (default 10)")
-	dataDir    = flag.String("data_dir", "fully_homomorphic_encryption/demos/mnist/data", "Directory containing MNIST dataset binary files")
+	numSamples     = flag.Int("num_samples", 10, "Number of test samples to evaluate (default 10)")
+	dataDir        = flag.String("data_dir", "fully_homomorphic_encryption/demos/mnist/data", "Directory containing MNIST dataset binary files")
+	workers        = flag.Int("workers", 1, "Number of concurrent evaluation workers")
+	encryptWorkers = flag.Int("encrypt_workers", 1, "Number of concurrent encryption workers")
+	decryptWorkers = flag.Int("decrypt_workers", 1, "Number of concurrent decryption workers")
+	reportPath     = flag.String("report", "", "Write a suite report for compare_backends to this file")
 )
 
+// worker holds the per-goroutine copies of the Lattigo objects, which are not
+// safe for concurrent use. Only the fields its phase needs are set.
+// Evaluation workers also own their zero accumulators.
+type worker struct {
+	evaluator *ckks.Evaluator
+	encoder   *ckks.Encoder
+	encryptor *rlwe.Encryptor
+	decryptor *rlwe.Decryptor
+	zeros     *recycle.Zeros
+}
+
 func main() {
 	flag.Parse()
+	report := suitereport.New("mnist", "lattigo", *numSamples)
 
 	fmt.Println("Configuring Lattigo crypto context...")
 	tSetupStart := time.Now()
 	evaluator, params, encoder, encryptor, decryptor := mnist.Mnist__configure()
 	tSetupEnd := time.Now()
+	report.Setup = tSetupEnd.Sub(tSetupStart).Seconds()
 	fmt.Printf("Crypto context setup completed in %.2f ms.\n\n", float64(tSetupEnd.Sub(tSetupStart).Microseconds())/1000.0)
+	if keys, ok := evaluator.GetEvaluationKeySet().(interface{ BinarySize() int }); ok {
+		report.EvalKeyBytes = int64(keys.BinarySize())
+	}
 
 	fmt.Println("Preprocessing weights...")
 	tPreStart := time.Now()
 	preprocessedWeights := mnist_utils.Mnist__preprocessing(params, encoder)
 	tPreEnd := time.Now()
+	report.Preprocessing = tPreEnd.Sub(tPreStart).Seconds()
 	fmt.Printf("Weight preprocessing completed in %.2f ms.\n\n", float64(tPreEnd.Sub(tPreStart).Microseconds())/1000.0)
 
-	fmt.Println("Encrypting zero constant vectors...")
-	ctZeros0 := mnist.Mnist__encrypt__zero__0(evaluator, params, encoder, encryptor)
-	ctZeros1 := mnist.Mnist__encrypt__zero__1(evaluator, params, encoder, encryptor)
-	ctZeros2 := mnist.Mnist__encrypt__zero__2(evaluator, params, encoder, encryptor)
-
-	fmt.Printf("Evaluating %d MNIST samples sequentially...\n", *numSamples)
-	correct := 0
-	var totalEvalDuration time.Duration
-
 	npzPath := pathutils.ResolvePath(filepath.Join(*dataDir, "mnist.npz"))
 	images, labels, err := mnist_data.LoadMNISTNPZ(npzPath)
 	if err != nil {
@@ -54,45 +72,94 @@ func main() {
 		os.Exit(1)
 	}
 
-	for i := 0; i < *numSamples; i++ {
-		image := images[i]
-		label := labels[i]
-
-		ctInput := mnist.Mnist__encrypt__arg0(evaluator, params, encoder, encryptor, image)
-
-		tEvalStart := time.Now()
-		resCt := mnist.Mnist__preprocessed(evaluator, params, encoder, ctInput, ctZeros0, ctZeros1, ctZeros2, preprocessedWeights)
-		evalDuration := time.Since(tEvalStart)
-		totalEvalDuration += evalDuration
-
-		resValues := mnist.Mnist__decrypt__result0(evaluator, params, encoder, decryptor, resCt)
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
 
-		maxVal := float32(-math.MaxFloat32)
-		pred := -1
-		for j := 0; j < 10 && j < len(resValues); j++ {
-			if resValues[j] > maxVal {
-				maxVal = resValues[j]
-				pred = j
+	fmt.Printf("Encrypting %d MNIST samples on %d workers...\n", *numSamples, *encryptWorkers)
+	ctInputs := make([][]*rlwe.Ciphertext, *numSamples)
+	encStats := workerpool.Run(*numSamples, workerpool.Config{Workers: *encryptWorkers},
+		func() worker {
+			return worker{evaluator: evaluator.ShallowCopy(), encoder: encoder.ShallowCopy(), encryptor: encryptor.ShallowCopy()}
+		},
+		func(w worker, i int) {
+			ctInputs[i] = mnist.Mnist__encrypt__arg0(w.evaluator, params, w.encoder, w.encryptor, images[i])
+		})
+	report.Encrypt = encStats.Total.Seconds()
+
+	fmt.Printf("Evaluating %d MNIST samples on %d workers...\n", *numSamples, *workers)
+	ctOutputs := make([][]*rlwe.Ciphertext, *numSamples)
+	evalStats := workerpool.Run(*numSamples, workerpool.Config{Workers: *workers},
+		func() *worker {
+			return &worker{evaluator: evaluator.ShallowCopy(), encoder: encoder.ShallowCopy(), encryptor: encryptor.ShallowCopy()}
+		},
+		func(w *worker, i int) {
+			if w.zeros == nil {
+				w.zeros = recycle.NewZeros(
+					mnist.Mnist__encrypt__zero__0(w.evaluator, params, w.encoder, w.encryptor),
+					mnist.Mnist__encrypt__zero__1(w.evaluator, params, w.encoder, w.encryptor),
+					mnist.Mnist__encrypt__zero__2(w.evaluator, params, w.encoder, w.encryptor),
+				)
+			} else if err := w.zeros.Refresh(w.encryptor); err != nil {
+				fmt.Fprintf(os.Stderr, "Error: %v\n", err)
+				os.Exit(1)
 			}
-		}
+			tEvalStart := time.Now()
+			ctOutputs[i] = mnist.Mnist__preprocessed(w.evaluator, params, w.encoder, ctInputs[i], w.zeros.Get(0), w.zeros.Get(1), w.zeros.Get(2), preprocessedWeights)
+			report.EvalLatency[i] = time.Since(tEvalStart).Seconds()
+			w.zeros.Detach(ctOutputs[i])
+		})
+	report.Evaluate = evalStats.Total.Seconds()
+
+	fmt.Printf("Decrypting %d MNIST samples on %d workers...\n", *numSamples, *decryptWorkers)
+	preds := make([]int, *numSamples)
+	decStats := workerpool.Run(*numSamples, workerpool.Config{Workers: *decryptWorkers},
+		func() worker {
+			return worker{evaluator: evaluator.ShallowCopy(), encoder: encoder.ShallowCopy(), decryptor: decryptor.ShallowCopy()}
+		},
+		func(w worker, i int) {
+			resValues := mnist.Mnist__decrypt__result0(w.evaluator, params, w.encoder, w.decryptor, ctOutputs[i])
+			maxVal := float32(-math.MaxFloat32)
+			preds[i] = -1
+			for j := 0; j < 10 && j < len(resValues); j++ {
+				if resValues[j] > maxVal {
+					maxVal = resValues[j]
+					preds[i] = j
+				}
+			}
+		})
+	report.Decrypt = decStats.Total.Seconds()
+	if err := stopProfiles(); err != nil {
+		fmt.Fprintf(os.Stderr, "Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
 
+	correct := 0
+	var totalEvalDuration float64
+	for i := 0; i < *numSamples; i++ {
+		pred, label := preds[i], labels[i]
 		isCorrect := pred == label
-		if isCorrect {
-			correct++
-		}
-
 		status := "INCORRECT"
 		if isCorrect {
+			correct++
 			status = "CORRECT"
 		}
-		fmt.Printf("Sample %4d: True=%d, Pred=%d | %s | Eval Time= %.2f ms\n", i, label, pred, status, float64(evalDuration.Microseconds())/1000.0)
+		totalEvalDuration += report.EvalLatency[i]
+		fmt.Printf("Sample %4d: True=%d, Pred=%d | %s | Eval Time= %.2f ms\n", i, label, pred, status, report.EvalLatency[i]*1000.0)
+	}
+	report.Correct = correct
+	if err := report.Write(*reportPath); err != nil {
+		fmt.Fprintf(os.Stderr, "Error writing report: %v\n", err)
+		os.Exit(1)
 	}
 
 	accuracy := 0.0
 	avgEvalMs := 0.0
 	if *numSamples > 0 {
 		accuracy = (float64(correct) / float64(*numSamples)) * 100.0
-		avgEvalMs = float64(totalEvalDuration.Microseconds()) / (1000.0 * float64(*numSamples))
+		avgEvalMs = totalEvalDuration * 1000.0 / float64(*numSamples)
 	}
 
 	fmt.Println("\n--- Lattigo Evaluation Suite Results ---")
@@ -100,4 +167,5 @@ func main() {
 	fmt.Printf("Total Correct:           %d / %d\n", correct, *numSamples)
 	fmt.Printf("Overall Accuracy:        %.2f%%\n", accuracy)
 	fmt.Printf("Average Homomorphic Eval Latency: %.2f ms/sample\n", avgEvalMs)
+	fmt.Printf("Phase wall times: encrypt %v, evaluate %v, decrypt %v\n", encStats.Total, evalStats.Total, decStats.Total)
 }
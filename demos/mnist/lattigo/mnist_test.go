@@ -0,0 +1,71 @@
+package mnist_test
+
+import (
+	"flag"
+	"testing"
+
+	"fully_homomorphic_encryption/demos/common/go/bench"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
+	"fully_homomorphic_encryption/demos/common/lattigo/primitives"
+	"fully_homomorphic_encryption/demos/common/lattigo/recycle"
+	"fully_homomorphic_encryption/demos/mnist/lattigo/mnist"
+	"fully_homomorphic_encryption/demos/mnist/lattigo/mnist_utils"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+)
+
+var keyDir = flag.String("key_dir", "", "Directory to load keys from, or to save freshly generated keys to")
+
+// numFeatures is the number of pixels of an MNIST image.
+const numFeatures = 784
+
+func BenchmarkMnist(b *testing.B) {
+	evaluator, params, encoder, encryptor, decryptor, err := keystore.Configure(*keyDir, mnist.Mnist__configure)
+	if err != nil {
+		b.Fatal(err)
+	}
+	weights := mnist_utils.Mnist__preprocessing(params, encoder)
+	features := make([]float32, numFeatures)
+
+	bench.Run(b, bench.Model[[]*rlwe.Ciphertext, []*rlwe.Ciphertext]{
+		Encrypt: func() func() []*rlwe.Ciphertext {
+			evaluator, encoder, encryptor := evaluator.ShallowCopy(), encoder.ShallowCopy(), encryptor.ShallowCopy()
+			return func() []*rlwe.Ciphertext {
+				return mnist.Mnist__encrypt__arg0(evaluator, params, encoder, encryptor, features)
+			}
+		},
+		Evaluate: func() func([]*rlwe.Ciphertext) []*rlwe.Ciphertext {
+			evaluator, encoder, encryptor := evaluator.ShallowCopy(), encoder.ShallowCopy(), encryptor.ShallowCopy()
+			var zeros *recycle.Zeros
+			return func(in []*rlwe.Ciphertext) []*rlwe.Ciphertext {
+				if zeros == nil {
+					zeros = recycle.NewZeros(
+						mnist.Mnist__encrypt__zero__0(evaluator, params, encoder, encryptor),
+						mnist.Mnist__encrypt__zero__1(evaluator, params, encoder, encryptor),
+						mnist.Mnist__encrypt__zero__2(evaluator, params, encoder, encryptor),
+					)
+				} else if err := zeros.Refresh(encryptor); err != nil {
+					panic(err)
+				}
+				out := mnist.Mnist__preprocessed(evaluator, params, encoder, in, zeros.Get(0), zeros.Get(1), zeros.Get(2), weights)
+				zeros.Detach(out)
+				return out
+			}
+		},
+		Decrypt: func() func([]*rlwe.Ciphertext) {
+			evaluator, encoder, decryptor := evaluator.ShallowCopy(), encoder.ShallowCopy(), decryptor.ShallowCopy()
+			return func(out []*rlwe.Ciphertext) {
+				mnist.Mnist__decrypt__result0(evaluator, params, encoder, decryptor, out)
+			}
+		},
+	})
+}
+
+// BenchmarkPrimitives times each CKKS primitive at every level of the model's
+// parameters.
+func BenchmarkPrimitives(b *testing.B) {
+	evaluator, params, encoder, encryptor, _, err := keystore.Configure(*keyDir, mnist.Mnist__configure)
+	if err != nil {
+		b.Fatal(err)
+	}
+	primitives.Run(b, params, evaluator, encoder, encryptor, nil)
+}
@@ -0,0 +1,36 @@
+"""Flags and evaluation suite of the Lattigo MNIST model.
+
+Shared by the BUILD file and demos/common/python/tune_params.py, which builds
+variants of the model in another package, so the labels are absolute.
+"""
+
+HEIR_OPT_FLAGS = [
+    "--annotate-module=backend=lattigo scheme=ckks",
+    "--torch-linalg-to-ckks=min-slot-count=1024 greedy-modulus-switch-after-mul=true experimental-disable-loop-unroll=true greedy-level-budget=11 first-mod-bits=30 scaling-mod-bits=24",
+    "--scheme-to-lattigo",
+]
+
+# The model and suite attributes of heir_lattigo_param_sweep.
+SWEEP_ATTRS = {
+    "importpath": "fully_homomorphic_encryption/demos/mnist/lattigo/mnist",
+    "mlir_src": "//demos/mnist/data:mnist.mlir",
+    "rows_flag": "-num_samples",
+    "suite_data": [
+        "//demos/mnist/data:mnist.npz",
+    ],
+    "suite_deps": [
+        "//demos/common/go/pathutils",
+        "//demos/common/go/profiling",
+        "//demos/common/go/suitereport",
+        "//demos/common/go/workerpool",
+        "//demos/common/lattigo/recycle",
+        "//demos/mnist/lattigo:mnist",
+        "//demos/mnist/lattigo:mnist_utils",
+        "//demos/mnist/lattigo/mnist_data",
+        "@com_github_tuneinsight_lattigo_v6//core/rlwe",
+        "@com_github_tuneinsight_lattigo_v6//schemes/ckks",
+    ],
+    "suite_srcs": [
+        "//demos/mnist/lattigo:evaluate_fhe_suite.go",
+    ],
+}
@@ -0,0 +1,121 @@
+// Google Benchmark targets for the OpenFHE MNIST model, one per phase of
+// evaluate_fhe.py. Each benchmark runs at several OpenMP thread counts; pass
+// --benchmark_out=<file> --benchmark_out_format=json for machine-readable
+// results.
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "demos/common/openfhe/benchmark_helper.h"
+#include "demos/mnist/openfhe/mnist_openfhe_lib.inc.h"
+#include "src/pke/include/openfhe.h"
+
+namespace {
+
+// The input is one flattened 28x28 image.
+constexpr int kNumFeatures = 28 * 28;
+
+// The configured context and keys, shared by all benchmarks and built on
+// first use.
+struct Model {
+  CryptoContextT cc;
+  lbcrypto::KeyPair<lbcrypto::DCRTPoly> keys;
+  std::vector<float> features = std::vector<float>(kNumFeatures);
+
+  Model() {
+    cc = mnist__generate_crypto_context();
+    keys = cc->KeyGen();
+    cc = mnist__configure_crypto_context(cc, keys.secretKey);
+  }
+};
+
+Model& GetModel() {
+  static Model* model = new Model();
+  return *model;
+}
+
+void BM_GenerateCryptoContext(benchmark::State& state) {
+  SetThreads(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mnist__generate_crypto_context());
+  }
+}
+BENCHMARK(BM_GenerateCryptoContext)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Also reports the size of the evaluation keys the configuration generates.
+// Each iteration configures under a new key tag; the keys of the previous one
+// are cleared so that only the last set stays in memory.
+void BM_ConfigureCryptoContext(benchmark::State& state) {
+  SetThreads(state);
+  KeyPairT keys;
+  for (auto _ : state) {
+    state.PauseTiming();
+    ClearEvalKeys(keys);
+    auto cc = mnist__generate_crypto_context();
+    keys = cc->KeyGen();
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(
+        mnist__configure_crypto_context(cc, keys.secretKey));
+  }
+  ReportEvalKeyBytes(state, keys);
+}
+BENCHMARK(BM_ConfigureCryptoContext)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_Encrypt(benchmark::State& state) {
+  Model& m = GetModel();
+  SetThreads(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        mnist__encrypt__arg0(m.cc, m.features, m.keys.publicKey));
+  }
+}
+BENCHMARK(BM_Encrypt)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Times the evaluation only. The input and the zero accumulators
+// are encrypted afresh, untimed, for every iteration.
+void BM_Evaluate(benchmark::State& state) {
+  Model& m = GetModel();
+  SetThreads(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto input = mnist__encrypt__arg0(m.cc, m.features, m.keys.publicKey);
+    auto zero0 = mnist__encrypt__zero__0(m.cc, m.keys.publicKey);
+    auto zero1 = mnist__encrypt__zero__1(m.cc, m.keys.publicKey);
+    auto zero2 = mnist__encrypt__zero__2(m.cc, m.keys.publicKey);
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(mnist(m.cc, input, zero0, zero1, zero2));
+  }
+}
+BENCHMARK(BM_Evaluate)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_Decrypt(benchmark::State& state) {
+  Model& m = GetModel();
+  SetThreads(state);
+  auto output =
+      mnist(m.cc, mnist__encrypt__arg0(m.cc, m.features, m.keys.publicKey),
+            mnist__encrypt__zero__0(m.cc, m.keys.publicKey),
+            mnist__encrypt__zero__1(m.cc, m.keys.publicKey),
+            mnist__encrypt__zero__2(m.cc, m.keys.publicKey));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        mnist__decrypt__result0(m.cc, output, m.keys.secretKey));
+  }
+}
+BENCHMARK(BM_Decrypt)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
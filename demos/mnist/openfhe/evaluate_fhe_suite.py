@@ -9,6 +9,8 @@ from absl import flags
 import numpy as np
 
 from demos.common.python import path_utils
+from demos.common.python import pipeline
+from demos.common.python import suite_report
 
 try:
   from demos.mnist.openfhe import mnist_openfhe_pybind as mnist
@@ -39,6 +41,29 @@ flags.DEFINE_string(
     "demos/mnist/data",
     "Directory containing MNIST dataset binary files",
 )
+flags.DEFINE_bool(
+    "pipeline",
+    False,
+    "Run encryption, evaluation and decryption as concurrent stages connected"
+    " by bounded queues",
+)
+flags.DEFINE_integer(
+    "encrypt_workers", 1, "Number of encryption threads in pipeline mode"
+)
+flags.DEFINE_integer(
+    "evaluate_workers", 1, "Number of evaluation threads in pipeline mode"
+)
+flags.DEFINE_integer(
+    "decrypt_workers", 1, "Number of decryption threads in pipeline mode"
+)
+flags.DEFINE_integer(
+    "queue_depth",
+    2,
+    "Maximum number of samples waiting between two pipeline stages",
+)
+flags.DEFINE_string(
+    "report", None, "Write a suite report for compare_backends to this file"
+)
 
 
 def load_mnist_sample(data_dir: str, sample_idx: int) -> tuple[np.ndarray, int]:
@@ -49,8 +74,15 @@ def load_mnist_sample(data_dir: str, sample_idx: int) -> tuple[np.ndarray, int]:
   return image.flatten(), label
 
 
-def evaluate_suite(data_dir: str, num_samples: int) -> None:
-  """Evaluates OpenFHE model sequentially over multiple MNIST samples."""
+def evaluate_suite(
+    data_dir: str,
+    num_samples: int,
+    use_pipeline: bool = False,
+    pipeline_config: dict[str, int] | None = None,
+    report_path: str | None = None,
+) -> None:
+  """Evaluates OpenFHE model over multiple MNIST samples."""
+  report_data = suite_report.SuiteReport("mnist", "openfhe", num_samples)
 
   print("Configuring OpenFHE crypto context...")
   t_setup_start = time.perf_counter()
@@ -62,6 +94,7 @@ def evaluate_suite(data_dir: str, num_samples: int) -> None:
       crypto_context, secret_key
   )
   t_setup_end = time.perf_counter()
+  report_data.setup_s = t_setup_end - t_setup_start
   print(
       "Crypto context setup completed in"
       f" {(t_setup_end - t_setup_start)*1000:.2f} ms.\n"
@@ -75,40 +108,76 @@ def evaluate_suite(data_dir: str, num_samples: int) -> None:
   ]
   ct_zeros = [func(crypto_context, public_key) for func in zero_encrypt_funcs]
 
-  print(f"Evaluating {num_samples} MNIST samples sequentially...")
-  correct = 0
-  total_eval_time_s = 0.0
+  eval_times_s = report_data.eval_latency_s
+  labels = [0] * num_samples
 
-  for i in range(num_samples):
-    image, label = load_mnist_sample(data_dir, i)
+  def encrypt(idx):
+    image, label = load_mnist_sample(data_dir, idx)
+    labels[idx] = label
     input_vector = image.flatten().tolist()
-
+    t_encrypt_start = time.perf_counter()
     input_encrypted = mnist.mnist__encrypt__arg0(
         crypto_context, input_vector, public_key
     )
+    report_data.record_phase("encrypt", t_encrypt_start, time.perf_counter())
+    return input_encrypted
 
+  def evaluate(idx, input_encrypted):
     t_eval_start = time.perf_counter()
     output_encrypted = mnist.mnist(crypto_context, input_encrypted, *ct_zeros)
     t_eval_end = time.perf_counter()
+    eval_times_s[idx] = t_eval_end - t_eval_start
+    report_data.record_phase("evaluate", t_eval_start, t_eval_end)
+    return output_encrypted
 
-    eval_time_s = t_eval_end - t_eval_start
-    total_eval_time_s += eval_time_s
-
+  def decrypt(idx, output_encrypted):
+    t_decrypt_start = time.perf_counter()
     output = mnist.mnist__decrypt__result0(
         crypto_context, output_encrypted, secret_key
     )
+    report_data.record_phase("decrypt", t_decrypt_start, time.perf_counter())
     logits = output[:10]
-    pred = max(range(10), key=lambda idx: logits[idx])
+    return max(range(10), key=lambda i: logits[i])
+
+  correct = 0
+
+  def report(idx, pred):
+    nonlocal correct
+    label = labels[idx]
     is_correct = pred == label
     if is_correct:
       correct += 1
 
     print(
-        f"Sample {i:4d}: True={label}, Pred={pred} |"
+        f"Sample {idx:4d}: True={label}, Pred={pred} |"
         f" {'CORRECT' if is_correct else 'INCORRECT'} | Eval Time="
-        f" {eval_time_s*1000:.2f} ms"
+        f" {eval_times_s[idx]*1000:.2f} ms"
     )
 
+  if use_pipeline:
+    print(f"Evaluating {num_samples} MNIST samples in a pipeline...")
+    stats = pipeline.run_pipeline(
+        num_samples,
+        encrypt,
+        evaluate,
+        decrypt,
+        report,
+        **(pipeline_config or {}),
+    )
+    print(
+        f"Pipeline wall time: {stats.total_s*1000:.2f} ms, time to first"
+        f" result: {stats.first_result_s*1000:.2f} ms, max samples in flight:"
+        f" {stats.max_in_flight}"
+    )
+  else:
+    print(f"Evaluating {num_samples} MNIST samples sequentially...")
+    for i in range(num_samples):
+      report(i, decrypt(i, evaluate(i, encrypt(i))))
+
+  report_data.correct = correct
+  report_data.write(report_path)
+
+  total_eval_time_s = sum(eval_times_s)
   accuracy = (correct / num_samples) * 100.0 if num_samples > 0 else 0.0
   avg_eval_ms = (
       (total_eval_time_s / num_samples) * 1000.0 if num_samples > 0 else 0.0
@@ -125,7 +194,18 @@ def main(argv):
   if len(argv) > 1:
     raise app.UsageError("Too many command-line arguments.")
   try:
-    evaluate_suite(FLAGS.data_dir, FLAGS.num_samples)
+    evaluate_suite(
+        FLAGS.data_dir,
+        FLAGS.num_samples,
+        use_pipeline=FLAGS.pipeline,
+        pipeline_config={
+            "encrypt_workers": FLAGS.encrypt_workers,
+            "evaluate_workers": FLAGS.evaluate_workers,
+            "decrypt_workers": FLAGS.decrypt_workers,
+            "queue_depth": FLAGS.queue_depth,
+        },
+        report_path=FLAGS.report,
+    )
   except Exception as e:
     print(f"Error executing evaluation suite: {e}", file=sys.stderr)
     sys.exit(1)
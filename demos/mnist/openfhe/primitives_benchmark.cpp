@@ -0,0 +1,21 @@
+// Google Benchmark targets for the CKKS primitives at the parameters of the
+// OpenFHE MNIST model, as built by its generated configure_crypto_context.
+
+#include "benchmark/benchmark.h"
+#include "demos/common/openfhe/benchmark_helper.h"
+#include "demos/mnist/openfhe/mnist_openfhe_lib.inc.h"
+#include "src/pke/include/openfhe.h"
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+  auto cc = mnist__generate_crypto_context();
+  auto keys = cc->KeyGen();
+  cc = mnist__configure_crypto_context(cc, keys.secretKey);
+  RegisterPrimitiveBenchmarks(cc, keys);
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
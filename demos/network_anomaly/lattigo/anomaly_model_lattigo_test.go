@@ -0,0 +1,61 @@
+package anomaly_model_lattigo_test
+
+import (
+	"flag"
+	"testing"
+
+	"fully_homomorphic_encryption/demos/common/go/bench"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
+	"fully_homomorphic_encryption/demos/common/lattigo/primitives"
+	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/anomaly_model_lattigo"
+	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/anomaly_model_lattigo_utils"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+)
+
+var keyDir = flag.String("key_dir", "", "Directory to load keys from, or to save freshly generated keys to")
+
+// numFeatures is the packet feature width of the model.
+const numFeatures = 5
+
+func BenchmarkMain(b *testing.B) {
+	evaluator, params, encoder, encryptor, decryptor, err := keystore.Configure(*keyDir, anomaly_model_lattigo.Main__configure)
+	if err != nil {
+		b.Fatal(err)
+	}
+	weights := anomaly_model_lattigo_utils.Main__preprocessing(params, encoder)
+	features := make([]float32, numFeatures)
+
+	// The model has two outputs, the reconstruction error and the residuals.
+	bench.Run(b, bench.Model[[]*rlwe.Ciphertext, [2][]*rlwe.Ciphertext]{
+		Encrypt: func() func() []*rlwe.Ciphertext {
+			evaluator, encoder, encryptor := evaluator.ShallowCopy(), encoder.ShallowCopy(), encryptor.ShallowCopy()
+			return func() []*rlwe.Ciphertext {
+				return anomaly_model_lattigo.Main__encrypt__arg0(evaluator, params, encoder, encryptor, features)
+			}
+		},
+		Evaluate: func() func([]*rlwe.Ciphertext) [2][]*rlwe.Ciphertext {
+			evaluator, encoder := evaluator.ShallowCopy(), encoder.ShallowCopy()
+			return func(in []*rlwe.Ciphertext) [2][]*rlwe.Ciphertext {
+				sse, residuals := anomaly_model_lattigo.Main__preprocessed(evaluator, params, encoder, in, weights)
+				return [2][]*rlwe.Ciphertext{sse, residuals}
+			}
+		},
+		Decrypt: func() func([2][]*rlwe.Ciphertext) {
+			evaluator, encoder, decryptor := evaluator.ShallowCopy(), encoder.ShallowCopy(), decryptor.ShallowCopy()
+			return func(out [2][]*rlwe.Ciphertext) {
+				anomaly_model_lattigo.Main__decrypt__result0(evaluator, params, encoder, decryptor, out[0])
+				anomaly_model_lattigo.Main__decrypt__result1(evaluator, params, encoder, decryptor, out[1])
+			}
+		},
+	})
+}
+
+// BenchmarkPrimitives times each CKKS primitive at every level of the model's
+// parameters.
+func BenchmarkPrimitives(b *testing.B) {
+	evaluator, params, encoder, encryptor, _, err := keystore.Configure(*keyDir, anomaly_model_lattigo.Main__configure)
+	if err != nil {
+		b.Fatal(err)
+	}
+	primitives.Run(b, params, evaluator, encoder, encryptor, nil)
+}
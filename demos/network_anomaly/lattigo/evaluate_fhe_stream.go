@@ -0,0 +1,223 @@
+// Package main provides a streaming evaluation mode for the Lattigo KitNET
+// FHE network anomaly detection model.
+//
+// Packets are read continuously from a file, a pipe or a Unix socket and
+// handed to the first idle worker of a pool, one packet per evaluation. The
+// reader and the workers are connected by a bounded queue: when evaluation
+// falls behind, the reader stops consuming from the source, which pushes
+// back on the packet producer instead of growing memory without bound.
+package main
+
+import (
+	"context"
+	"flag"
+	"fmt"
+	"io"
+	"os"
+	"os/signal"
+	"runtime"
+	"sort"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"fully_homomorphic_encryption/demos/common/go/pipeline"
+	"fully_homomorphic_encryption/demos/common/go/profiling"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
+	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/anomaly_model_lattigo"
+	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/anomaly_model_lattigo_utils"
+	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/utils"
+	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
+)
+
+type decision struct {
+	seq       int
+	mse       float64
+	isAnomaly bool
+	latency   time.Duration
+}
+
+// worker holds the per-goroutine copies of the Lattigo objects, which are not
+// safe for concurrent use.
+type worker struct {
+	evaluator *ckks.Evaluator
+	encoder   *ckks.Encoder
+	encryptor *rlwe.Encryptor
+	decryptor *rlwe.Decryptor
+}
+
+func main() {
+	sourceFlag := flag.String(
+		"source",
+		"fully_homomorphic_encryption/demos/network_anomaly/data/Mirai_first_batch_32K.bin",
+		"Packet source: a file or named pipe path, \"-\" for stdin, or \"unix:<path>\" for a Unix socket",
+	)
+	followFlag := flag.Bool("follow", false, "Keep waiting for new packets at the end of a regular file")
+	maxPacketsFlag := flag.Int("max_packets", 0, "Stop after this many packets (0 means until the source ends)")
+	workersFlag := flag.Int("workers", runtime.NumCPU(), "Number of concurrent evaluation workers")
+	queueDepthFlag := flag.Int("queue_depth", 64, "Maximum number of packets buffered ahead of evaluation")
+	thresholdFlag := flag.Float64("threshold", 0.005, "Anomaly detection MSE threshold")
+	keyDirFlag := flag.String("key_dir", "", "Directory to load the parameters and keys from, or to save them to on the first run (empty means generate fresh keys)")
+	flag.Parse()
+
+	numFeatures := 5
+	threshold := *thresholdFlag
+	numWorkers := *workersFlag
+	if numWorkers < 1 {
+		numWorkers = 1
+	}
+
+	fmt.Println("================================================================================")
+	fmt.Println("  PyTorch KitNET Lattigo FHE Streaming Evaluation")
+	fmt.Println("================================================================================")
+	fmt.Printf("Packet Source:      %s\n", *sourceFlag)
+	fmt.Printf("Workers:            %d\n", numWorkers)
+	fmt.Printf("Queue Depth:        %d packets\n", *queueDepthFlag)
+	fmt.Printf("Anomaly Threshold:  %e\n\n", threshold)
+
+	// 1. Configure Lattigo CKKS Context
+	fmt.Println("[1/3] Initializing Lattigo CKKS cryptocontext & keys...")
+	t0 := time.Now()
+	evaluator, params, encoder, encryptor, decryptor, err := keystore.Configure(*keyDirFlag, anomaly_model_lattigo.Main__configure)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Error configuring Lattigo context: %v\n", err)
+		os.Exit(1)
+	}
+	fmt.Printf("  Context ready in %v\n", time.Since(t0))
+
+	// 2. Preprocess Weights
+	fmt.Println("\n[2/3] Preprocessing weights into plaintexts...")
+	t0 = time.Now()
+	preprocessedPlaintexts := anomaly_model_lattigo_utils.Main__preprocessing(params, encoder)
+	fmt.Printf("  Preprocessed %d weight plaintexts in %v\n", len(preprocessedPlaintexts), time.Since(t0))
+
+	// 3. Stream packets through reader -> workers -> emitter
+	fmt.Println("\n[3/3] Streaming encrypted evaluation (Ctrl-C to stop)...")
+	stream, err := utils.OpenPacketStream(*sourceFlag, numFeatures, *followFlag)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Error opening packet stream: %v\n", err)
+		os.Exit(1)
+	}
+	defer stream.Close()
+
+	ctx, stop := signal.NotifyContext(context.Background(), os.Interrupt)
+	defer stop()
+	go func() {
+		// Unblocks a reader waiting on the source.
+		<-ctx.Done()
+		stream.Close()
+	}()
+
+	packets := make(chan utils.Packet, *queueDepthFlag)
+	decisions := make(chan decision, *queueDepthFlag)
+	var backpressureEvents atomic.Int64
+
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
+	streamStart := time.Now()
+	go func() {
+		defer close(packets)
+		for seq := 0; *maxPacketsFlag <= 0 || seq < *maxPacketsFlag; seq++ {
+			features, err := stream.Next()
+			if err != nil {
+				if err != io.EOF && ctx.Err() == nil {
+					fmt.Fprintf(os.Stderr, "Error reading packet stream: %v\n", err)
+				}
+				return
+			}
+			p := utils.Packet{Seq: seq, Features: features, Arrival: time.Now()}
+			select {
+			case packets <- p:
+			default:
+				// Evaluation is behind: block the reader until a slot frees up.
+				backpressureEvents.Add(1)
+				select {
+				case packets <- p:
+				case <-ctx.Done():
+					return
+				}
+			}
+		}
+	}()
+
+	var wg sync.WaitGroup
+	wg.Add(numWorkers)
+	for w := 0; w < numWorkers; w++ {
+		wk := worker{
+			evaluator: evaluator.ShallowCopy(),
+			encoder:   encoder.ShallowCopy(),
+			encryptor: encryptor.ShallowCopy(),
+			decryptor: decryptor.ShallowCopy(),
+		}
+		go func() {
+			defer wg.Done()
+			for p := range packets {
+				encryptedInput := anomaly_model_lattigo.Main__encrypt__arg0(wk.evaluator, params, wk.encoder, wk.encryptor, p.Features)
+				res0, _ := anomaly_model_lattigo.Main__preprocessed(
+					wk.evaluator, params, wk.encoder, encryptedInput, preprocessedPlaintexts,
+				)
+				decryptedSSE := anomaly_model_lattigo.Main__decrypt__result0(wk.evaluator, params, wk.encoder, wk.decryptor, res0)
+				anomalyMSE := float64(decryptedSSE[0]) / float64(numFeatures)
+				decisions <- decision{
+					seq:       p.Seq,
+					mse:       anomalyMSE,
+					isAnomaly: anomalyMSE >= threshold,
+					latency:   time.Since(p.Arrival),
+				}
+			}
+		}()
+	}
+	go func() {
+		wg.Wait()
+		close(decisions)
+	}()
+
+	var latencies []time.Duration
+	anomCount := 0
+	for d := range decisions {
+		latencies = append(latencies, d.latency)
+		flagStr := "BENIGN"
+		if d.isAnomaly {
+			flagStr = "ANOMALY"
+			anomCount++
+		}
+		fmt.Printf("  Packet %6d -> FHE MSE: %11.6e | Result: %-7s | E2E Latency: %v\n",
+			d.seq, d.mse, flagStr, d.latency)
+	}
+	streamDuration := time.Since(streamStart)
+	if err := stopProfiles(); err != nil {
+		fmt.Fprintf(os.Stderr, "Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
+
+	numPackets := len(latencies)
+	if numPackets == 0 {
+		fmt.Println("\nNo packets received.")
+		return
+	}
+	sort.Slice(latencies, func(i, j int) bool { return latencies[i] < latencies[j] })
+	var sumLatency time.Duration
+	for _, l := range latencies {
+		sumLatency += l
+	}
+
+	fmt.Println("\n================================================================================")
+	fmt.Println("  Streaming FHE Evaluation Summary")
+	fmt.Println("================================================================================")
+	fmt.Printf("Packets Evaluated:         %d\n", numPackets)
+	fmt.Printf("Packets Flagged Anomaly:   %d / %d (%.2f%%)\n",
+		anomCount, numPackets, float64(anomCount)/float64(numPackets)*100.0)
+	fmt.Printf("Backpressure Events:       %d\n", backpressureEvents.Load())
+	fmt.Printf("Stream Duration:           %v\n", streamDuration)
+	fmt.Printf("Throughput:                %.2f packets/s\n", float64(numPackets)/streamDuration.Seconds())
+	fmt.Printf("E2E Latency mean:          %v\n", sumLatency/time.Duration(numPackets))
+	fmt.Printf("E2E Latency p50/p95/p99:   %v / %v / %v\n",
+		pipeline.Percentile(latencies, 50), pipeline.Percentile(latencies, 95), pipeline.Percentile(latencies, 99))
+	fmt.Printf("E2E Latency max:           %v\n", latencies[numPackets-1])
+	fmt.Println("================================================================================")
+}
@@ -6,14 +6,29 @@ import (
 	"fmt"
 	"math"
 	"os"
+	"runtime"
 	"time"
 
+	"fully_homomorphic_encryption/demos/common/go/profiling"
+	"fully_homomorphic_encryption/demos/common/go/suitereport"
+	"fully_homomorphic_encryption/demos/common/go/workerpool"
+	"fully_homomorphic_encryption/demos/common/lattigo/keystore"
 	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/anomaly_model_lattigo"
 	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/anomaly_model_lattigo_utils"
 	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/utils"
 	"github.com/tuneinsight/lattigo/v6/core/rlwe"
+	"github.com/tuneinsight/lattigo/v6/schemes/ckks"
 )
 
+// worker holds the per-goroutine copies of the Lattigo objects, which are not
+// safe for concurrent use. Only the fields its phase needs are set.
+type worker struct {
+	evaluator *ckks.Evaluator
+	encoder   *ckks.Encoder
+	encryptor *rlwe.Encryptor
+	decryptor *rlwe.Decryptor
+}
+
 func main() {
 	numSamplesFlag := flag.Int("num_samples", 10, "Number of packet samples to evaluate in suite")
 	dataPathFlag := flag.String(
@@ -27,6 +42,11 @@ func main() {
 		"Path to ground truth labels CSV file",
 	)
 	thresholdFlag := flag.Float64("threshold", 0.005, "Anomaly detection MSE threshold")
+	workersFlag := flag.Int("workers", runtime.NumCPU(), "Number of concurrent evaluation workers")
+	encryptWorkersFlag := flag.Int("encrypt_workers", runtime.NumCPU(), "Number of concurrent encryption workers")
+	decryptWorkersFlag := flag.Int("decrypt_workers", runtime.NumCPU(), "Number of concurrent decryption workers")
+	keyDirFlag := flag.String("key_dir", "", "Directory to load the parameters and keys from, or to save them to on the first run (empty means generate fresh keys)")
+	reportFlag := flag.String("report", "", "Write a suite report for compare_backends to this file")
 	flag.Parse()
 
 	numSamples := *numSamplesFlag
@@ -42,7 +62,9 @@ func main() {
 	fmt.Printf("Labels File:        %s\n", labelsPath)
 	fmt.Printf("Target Samples:     %d\n", numSamples)
 	fmt.Printf("Number of Features: %d\n", numFeatures)
-	fmt.Printf("Anomaly Threshold:  %e\n\n", threshold)
+	fmt.Printf("Anomaly Threshold:  %e\n", threshold)
+	fmt.Printf("Workers:            %d encrypt / %d evaluate / %d decrypt\n\n",
+		*encryptWorkersFlag, *workersFlag, *decryptWorkersFlag)
 
 	// 1. Load Packet Samples
 	fmt.Println("[1/4] Loading packet samples...")
@@ -53,6 +75,7 @@ func main() {
 		os.Exit(1)
 	}
 	actualSamples := len(allSamples)
+	report := suitereport.New("network_anomaly", "lattigo", actualSamples)
 	fmt.Printf("  Loaded %d samples in %v\n", actualSamples, time.Since(t0))
 
 	// 2. Load Ground Truth Labels
@@ -66,42 +89,94 @@ func main() {
 	// 3. Configure Lattigo CKKS Context
 	fmt.Println("\n[2/4] Initializing Lattigo CKKS cryptocontext & keys...")
 	t0 = time.Now()
-	evaluator, params, encoder, encryptor, decryptor := anomaly_model_lattigo.Main__configure()
+	evaluator, params, encoder, encryptor, decryptor, err := keystore.Configure(*keyDirFlag, anomaly_model_lattigo.Main__configure)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Error configuring Lattigo context: %v\n", err)
+		os.Exit(1)
+	}
+	report.Setup = time.Since(t0).Seconds()
 	fmt.Printf("  Context ready in %v\n", time.Since(t0))
+	if keys, ok := evaluator.GetEvaluationKeySet().(interface{ BinarySize() int }); ok {
+		report.EvalKeyBytes = int64(keys.BinarySize())
+	}
 
 	// 4. Preprocess Weights
 	fmt.Println("\n[3/4] Preprocessing weights into plaintexts...")
 	t0 = time.Now()
 	preprocessedPlaintexts := anomaly_model_lattigo_utils.Main__preprocessing(params, encoder)
+	report.Preprocessing = time.Since(t0).Seconds()
 	fmt.Printf("  Preprocessed %d weight plaintexts in %v\n", len(preprocessedPlaintexts), time.Since(t0))
 
-	// 5. Evaluate FHE Loop
+	// 5. Encrypt, evaluate and decrypt all samples, each phase on its own pool
 	fmt.Println("\n[4/4] Evaluating encrypted samples...")
 	fheScores := make([]float64, actualSamples)
 	isAnomaly := make([]bool, actualSamples)
+	encryptedInputs := make([][]*rlwe.Ciphertext, actualSamples)
+	encryptedResults := make([][]*rlwe.Ciphertext, actualSamples)
+	latencies := make([]time.Duration, actualSamples)
+
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
 
 	suiteStart := time.Now()
+	encStats := workerpool.Run(actualSamples, workerpool.Config{Workers: *encryptWorkersFlag},
+		func() worker {
+			return worker{evaluator: evaluator.ShallowCopy(), encoder: encoder.ShallowCopy(), encryptor: encryptor.ShallowCopy()}
+		},
+		func(w worker, i int) {
+			encryptedInputs[i] = anomaly_model_lattigo.Main__encrypt__arg0(w.evaluator, params, w.encoder, w.encryptor, allSamples[i])
+		})
+	report.Encrypt = encStats.Total.Seconds()
+	fmt.Printf("  Encrypted %d samples on %d workers in %v\n", actualSamples, encStats.Workers, encStats.Total)
+
+	mem := workerpool.TakeMemSnapshot()
+	evalStats := workerpool.Run(actualSamples, workerpool.Config{Workers: *workersFlag},
+		func() worker {
+			return worker{evaluator: evaluator.ShallowCopy(), encoder: encoder.ShallowCopy()}
+		},
+		func(w worker, i int) {
+			sampleStart := time.Now()
+			encryptedResults[i], _ = anomaly_model_lattigo.Main__preprocessed(
+				w.evaluator, params, w.encoder, encryptedInputs[i], preprocessedPlaintexts,
+			)
+			latencies[i] = time.Since(sampleStart)
+			encryptedInputs[i] = nil
+		})
+	memDelta := mem.Since()
+	report.Evaluate = evalStats.Total.Seconds()
+	fmt.Printf("  Evaluated %d samples on %d workers in %v\n", actualSamples, evalStats.Workers, evalStats.Total)
+	fmt.Printf("  Memory: %v\n", memDelta)
+
+	decStats := workerpool.Run(actualSamples, workerpool.Config{Workers: *decryptWorkersFlag},
+		func() worker {
+			return worker{evaluator: evaluator.ShallowCopy(), encoder: encoder.ShallowCopy(), decryptor: decryptor.ShallowCopy()}
+		},
+		func(w worker, i int) {
+			decryptedSSE := anomaly_model_lattigo.Main__decrypt__result0(w.evaluator, params, w.encoder, w.decryptor, encryptedResults[i])
+			rawSSE := float64(decryptedSSE[0])
+			fheScores[i] = rawSSE / float64(numFeatures)
+			isAnomaly[i] = fheScores[i] >= threshold
+		})
+	report.Decrypt = decStats.Total.Seconds()
+	fmt.Printf("  Decrypted %d samples on %d workers in %v\n\n", actualSamples, decStats.Workers, decStats.Total)
+	totalFheDuration := time.Since(suiteStart)
+	if err := stopProfiles(); err != nil {
+		fmt.Fprintf(os.Stderr, "Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
+
 	for i := 0; i < actualSamples; i++ {
-		sampleStart := time.Now()
-		encryptedInput := anomaly_model_lattigo.Main__encrypt__arg0(evaluator, params, encoder, encryptor, allSamples[i])
-		res0, _ := anomaly_model_lattigo.Main__preprocessed(
-			evaluator, params, encoder, encryptedInput, preprocessedPlaintexts,
-		)
-		decryptedSSE := anomaly_model_lattigo.Main__decrypt__result0(evaluator, params, encoder, decryptor, res0)
-		rawSSE := float64(decryptedSSE[0])
-		anomalyMSE := rawSSE / float64(numFeatures)
-		fheScores[i] = anomalyMSE
-		isAnomaly[i] = anomalyMSE >= threshold
-
-		sampleDur := time.Since(sampleStart)
+		report.EvalLatency[i] = latencies[i].Seconds()
 		flagStr := "BENIGN"
 		if isAnomaly[i] {
 			flagStr = "ANOMALY"
 		}
-		fmt.Printf("  Sample [%2d/%2d] -> FHE MSE: %11.6e | Result: %-7s | Latency: %v\n",
-			i+1, actualSamples, anomalyMSE, flagStr, sampleDur)
+		fmt.Printf("  Sample [%2d/%2d] -> FHE MSE: %11.6e | Result: %-7s | Eval Latency: %v\n",
+			i+1, actualSamples, fheScores[i], flagStr, latencies[i])
 	}
-	totalFheDuration := time.Since(suiteStart)
 
 	// Summary Statistics
 	var sumScore, minScore, maxScore float64
@@ -131,10 +206,11 @@ func main() {
 	fmt.Printf("Packets Flagged Anomaly:   %d / %d (%.2f%%)\n",
 		anomCount, actualSamples, float64(anomCount)/float64(actualSamples)*100.0)
 	fmt.Printf("Total Evaluation Time:     %v\n", totalFheDuration)
-	fmt.Printf("Average FHE Latency:       %v / sample\n", totalFheDuration/time.Duration(actualSamples))
+	fmt.Printf("Average FHE Latency:       %v / sample (wall time)\n", totalFheDuration/time.Duration(actualSamples))
 
 	if labels != nil && len(labels) == actualSamples {
 		cm := utils.CalculateConfusionMatrix(labels, isAnomaly)
+		report.Correct = cm.TP + cm.TN
 		fmt.Println("\n--- Ground Truth Validation & Confusion Matrix ---")
 		fmt.Printf("  • True Positives  (TP): %d\n", cm.TP)
 		fmt.Printf("  • True Negatives  (TN): %d\n", cm.TN)
@@ -145,6 +221,8 @@ func main() {
 	}
 	fmt.Println("================================================================================")
 
-	// Avoid compiler unused warning
-	_ = rlwe.Ciphertext{}
+	if err := report.Write(*reportFlag); err != nil {
+		fmt.Fprintf(os.Stderr, "Error writing report: %v\n", err)
+		os.Exit(1)
+	}
 }
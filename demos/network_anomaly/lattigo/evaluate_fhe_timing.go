@@ -6,6 +6,7 @@ import (
 	"os"
 	"time"
 
+	"fully_homomorphic_encryption/demos/common/go/profiling"
 	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/anomaly_model_lattigo_timing"
 	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/anomaly_model_lattigo_timing_utils"
 	"fully_homomorphic_encryption/demos/network_anomaly/lattigo/utils"
@@ -57,6 +58,12 @@ func main() {
 	fmt.Printf("[Phase 3] Weight Preprocessing:   %10v (%d plaintexts)\n",
 		prepDur, len(preprocessedPlaintexts))
 
+	stopProfiles, err := profiling.Start()
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Error starting profiles: %v\n", err)
+		os.Exit(1)
+	}
+
 	// 4. Repeated Evaluation Runs
 	fmt.Printf("\n--- Running %d FHE Evaluation Iterations ---\n", runs)
 	var totalEnc, totalFhe, totalDec time.Duration
@@ -84,6 +91,10 @@ func main() {
 		fmt.Printf("  Run %d/%d -> Encrypt: %8v | FHE Eval: %8v | Decrypt: %8v | Total: %8v\n",
 			r, runs, encDur, fheDur, decDur, encDur+fheDur+decDur)
 	}
+	if err := stopProfiles(); err != nil {
+		fmt.Fprintf(os.Stderr, "Error writing profiles: %v\n", err)
+		os.Exit(1)
+	}
 
 	avgEnc := totalEnc / time.Duration(runs)
 	avgFhe := totalFhe / time.Duration(runs)
@@ -0,0 +1,112 @@
+package utils
+
+import (
+	"bufio"
+	"encoding/binary"
+	"fmt"
+	"io"
+	"math"
+	"net"
+	"os"
+	"strings"
+	"time"
+
+	"fully_homomorphic_encryption/demos/common/go/pathutils"
+)
+
+// PacketStream reads packet samples continuously from a file, a pipe or a
+// Unix socket. Each packet is numFeatures little-endian float64 values, the
+// same layout as the Mirai dataset files.
+type PacketStream struct {
+	src          io.ReadCloser
+	reader       *bufio.Reader
+	numFeatures  int
+	follow       bool
+	pollInterval time.Duration
+	buf          []byte
+	filled       int
+}
+
+// OpenPacketStream opens a packet source. The source is interpreted as:
+//
+//   - "-" for standard input,
+//   - "unix:<path>" for a Unix domain stream socket to connect to,
+//   - anything else as a file path (regular file or named pipe).
+//
+// If follow is set, reaching the end of a regular file waits for more data
+// to be appended instead of ending the stream (like `tail -f`).
+func OpenPacketStream(source string, numFeatures int, follow bool) (*PacketStream, error) {
+	var src io.ReadCloser
+	switch {
+	case source == "-":
+		src = os.Stdin
+	case strings.HasPrefix(source, "unix:"):
+		conn, err := net.Dial("unix", strings.TrimPrefix(source, "unix:"))
+		if err != nil {
+			return nil, fmt.Errorf("failed to connect to packet socket: %w", err)
+		}
+		src = conn
+	default:
+		file, err := os.Open(pathutils.ResolvePath(source))
+		if err != nil {
+			return nil, fmt.Errorf("failed to open packet stream: %w", err)
+		}
+		src = file
+	}
+	return newPacketStream(src, numFeatures, follow), nil
+}
+
+func newPacketStream(src io.ReadCloser, numFeatures int, follow bool) *PacketStream {
+	return &PacketStream{
+		src:          src,
+		reader:       bufio.NewReaderSize(src, 64*numFeatures*8),
+		numFeatures:  numFeatures,
+		follow:       follow,
+		pollInterval: 50 * time.Millisecond,
+		buf:          make([]byte, numFeatures*8),
+	}
+}
+
+// Next blocks until a full packet is available and returns its features.
+// It returns io.EOF once the source is exhausted; a trailing partial packet
+// is reported as io.ErrUnexpectedEOF.
+func (s *PacketStream) Next() ([]float32, error) {
+	for s.filled < len(s.buf) {
+		n, err := s.reader.Read(s.buf[s.filled:])
+		s.filled += n
+		if err == io.EOF && s.follow {
+			time.Sleep(s.pollInterval)
+			continue
+		}
+		if err == io.EOF {
+			if s.filled == 0 {
+				return nil, io.EOF
+			}
+			return nil, io.ErrUnexpectedEOF
+		}
+		if err != nil {
+			return nil, fmt.Errorf("failed reading packet: %w", err)
+		}
+	}
+	s.filled = 0
+
+	features := make([]float32, s.numFeatures)
+	for j := 0; j < s.numFeatures; j++ {
+		bits := binary.LittleEndian.Uint64(s.buf[j*8 : (j+1)*8])
+		features[j] = float32(math.Float64frombits(bits))
+	}
+	return features, nil
+}
+
+// Close releases the underlying source.
+func (s *PacketStream) Close() error {
+	return s.src.Close()
+}
+
+// Packet is one packet read from a PacketStream.
+type Packet struct {
+	Seq      int
+	Features []float32
+	// Arrival is when the packet was read, the start of its end-to-end latency.
+	Arrival time.Time
+}
@@ -0,0 +1,108 @@
+package utils
+
+import (
+	"encoding/binary"
+	"errors"
+	"io"
+	"math"
+	"os"
+	"path/filepath"
+	"reflect"
+	"testing"
+	"time"
+)
+
+// encodePackets returns packets in the wire format of a PacketStream.
+func encodePackets(packets ...[]float64) []byte {
+	var data []byte
+	for _, p := range packets {
+		for _, v := range p {
+			data = binary.LittleEndian.AppendUint64(data, math.Float64bits(v))
+		}
+	}
+	return data
+}
+
+func TestPacketStreamReadsPacketsAsTheyArrive(t *testing.T) {
+	r, w := io.Pipe()
+	s := newPacketStream(r, 2, false)
+	go func() {
+		data := encodePackets([]float64{1, 2}, []float64{3, 4})
+		// Split the second packet across writes.
+		w.Write(data[:20])
+		w.Write(data[20:])
+		w.Close()
+	}()
+
+	for _, want := range [][]float32{{1, 2}, {3, 4}} {
+		got, err := s.Next()
+		if err != nil || !reflect.DeepEqual(got, want) {
+			t.Fatalf("Next() = %v, %v, want %v", got, err, want)
+		}
+	}
+	if _, err := s.Next(); err != io.EOF {
+		t.Errorf("Next() at the end = %v, want io.EOF", err)
+	}
+}
+
+func TestPacketStreamTruncatedPacket(t *testing.T) {
+	r, w := io.Pipe()
+	s := newPacketStream(r, 2, false)
+	go func() {
+		w.Write(encodePackets([]float64{1, 2})[:12])
+		w.Close()
+	}()
+	if _, err := s.Next(); err != io.ErrUnexpectedEOF {
+		t.Errorf("Next() on a partial packet = %v, want io.ErrUnexpectedEOF", err)
+	}
+}
+
+func TestPacketStreamFollowsAppendedData(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "packets.bin")
+	if err := os.WriteFile(path, encodePackets([]float64{1, 2}), 0o600); err != nil {
+		t.Fatal(err)
+	}
+	src, err := os.Open(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	s := newPacketStream(src, 2, true)
+	s.pollInterval = time.Millisecond
+	defer s.Close()
+
+	if got, err := s.Next(); err != nil || !reflect.DeepEqual(got, []float32{1, 2}) {
+		t.Fatalf("Next() = %v, %v, want [1 2]", got, err)
+	}
+	go func() {
+		time.Sleep(10 * time.Millisecond)
+		f, err := os.OpenFile(path, os.O_APPEND|os.O_WRONLY, 0)
+		if err != nil {
+			return
+		}
+		f.Write(encodePackets([]float64{3, 4}))
+		f.Close()
+	}()
+	if got, err := s.Next(); err != nil || !reflect.DeepEqual(got, []float32{3, 4}) {
+		t.Errorf("Next() after an append = %v, %v, want [3 4]", got, err)
+	}
+}
+
+func TestPacketStreamCloseUnblocksNext(t *testing.T) {
+	r, _ := io.Pipe()
+	s := newPacketStream(r, 2, false)
+	errs := make(chan error)
+	go func() {
+		_, err := s.Next()
+		errs <- err
+	}()
+	time.Sleep(5 * time.Millisecond)
+	s.Close()
+	select {
+	case err := <-errs:
+		if !errors.Is(err, io.ErrClosedPipe) {
+			t.Errorf("Next() after Close = %v, want io.ErrClosedPipe", err)
+		}
+	case <-time.After(time.Second):
+		t.Fatal("Next() still blocked after Close")
+	}
+}
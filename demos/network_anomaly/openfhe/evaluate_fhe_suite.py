@@ -0,0 +1,251 @@
+"""Evaluate a suite of packet samples with the KitNET model using OpenFHE.
+
+Packets are evaluated one after another, each on all OpenMP threads, unless
+--pipeline runs encryption, evaluation and decryption as concurrent stages.
+"""
+
+import argparse
+import time
+
+import numpy as np
+
+from demos.common.python import pipeline
+from demos.common.python import suite_report
+from demos.network_anomaly.openfhe import anomaly_model_50_pybind
+from demos.network_anomaly.openfhe import anomaly_model_pybind
+from demos.network_anomaly.openfhe import packet_data
+
+# Generated module of each model, by number of features.
+MODELS = {
+    5: anomaly_model_pybind,
+    50: anomaly_model_50_pybind,
+}
+
+
+def main():
+  parser = argparse.ArgumentParser()
+  parser.add_argument(
+      "--features",
+      type=int,
+      choices=sorted(MODELS),
+      default=5,
+      help="Evaluate the 5-feature or the 50-feature KitNET model",
+  )
+  parser.add_argument(
+      "--num_samples",
+      type=int,
+      default=10,
+      help="Number of packet samples to evaluate",
+  )
+  parser.add_argument(
+      "--data_path",
+      type=str,
+      default=None,
+      help="Binary float64 dataset file (default: the one of the model)",
+  )
+  parser.add_argument(
+      "--labels_path", type=str, default=packet_data.LABELS_PATH
+  )
+  parser.add_argument(
+      "--threshold",
+      type=float,
+      default=0.005,
+      help="Anomaly detection MSE threshold",
+  )
+  parser.add_argument(
+      "--pipeline",
+      action="store_true",
+      help=(
+          "Run encryption, evaluation and decryption as concurrent stages"
+          " connected by bounded queues"
+      ),
+  )
+  parser.add_argument(
+      "--encrypt_workers",
+      type=int,
+      default=1,
+      help="Number of encryption threads in pipeline mode",
+  )
+  parser.add_argument(
+      "--evaluate_workers",
+      type=int,
+      default=1,
+      help="Number of evaluation threads in pipeline mode",
+  )
+  parser.add_argument(
+      "--decrypt_workers",
+      type=int,
+      default=1,
+      help="Number of decryption threads in pipeline mode",
+  )
+  parser.add_argument(
+      "--queue_depth",
+      type=int,
+      default=2,
+      help="Maximum number of samples waiting between two pipeline stages",
+  )
+  parser.add_argument(
+      "--report",
+      type=str,
+      default=None,
+      help="Write a suite report for compare_backends to this file",
+  )
+  args = parser.parse_args()
+
+  model = MODELS[args.features]
+  num_features = args.features
+  data_path = args.data_path or packet_data.DATA_PATHS[num_features]
+
+  print(f"Loading packet samples from {data_path}...")
+  t0 = time.time()
+  all_samples = packet_data.load_packets(
+      data_path, args.num_samples, num_features
+  )
+  num_samples = len(all_samples)
+  labels = packet_data.load_labels(args.labels_path, num_samples)
+  if labels is not None and len(labels) != num_samples:
+    labels = None
+  print(f"  Loaded {num_samples} samples in {time.time() - t0:.4f} seconds")
+  if labels is None:
+    print("  Notice: no ground truth labels, skipping validation")
+  report_data = suite_report.SuiteReport(
+      "network_anomaly", "openfhe", num_samples
+  )
+
+  # Initialize crypto context (ONCE)
+  print("Generating crypto context...")
+  t_setup = time.time()
+  t0 = time.time()
+  cc = model.main__generate_crypto_context()
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Generating key pair...")
+  t0 = time.time()
+  key_pair = cc.KeyGen()
+  public_key = key_pair.publicKey
+  secret_key = key_pair.secretKey
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Configuring crypto context...")
+  t0 = time.time()
+  cc = model.main__configure_crypto_context(cc, secret_key)
+  print(f"  Took {time.time() - t0:.4f} seconds")
+  report_data.setup_s = time.time() - t_setup
+
+  # Run preprocessing (ONCE)
+  print("Running preprocessing for model weights...")
+  t0 = time.time()
+  prep_struct = model.main__preprocessing(cc)
+  report_data.preprocessing_s = time.time() - t0
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  # The zero accumulators are passed in the order of their index; sorting the
+  # names as strings would put main__encrypt__zero__10 before __2.
+  num_zeros = sum(
+      name.startswith("main__encrypt__zero__") for name in dir(model)
+  )
+  encrypt_zeros = [
+      getattr(model, f"main__encrypt__zero__{i}") for i in range(num_zeros)
+  ]
+
+  def encrypt(idx):
+    t0 = time.perf_counter()
+    encrypted_features = model.main__encrypt__arg0(
+        cc, all_samples[idx], public_key
+    )
+    ct_zeros = [fn(cc, public_key) for fn in encrypt_zeros]
+    report_data.record_phase("encrypt", t0, time.perf_counter())
+    return encrypted_features, ct_zeros
+
+  def evaluate(idx, encrypted_inputs):
+    encrypted_features, ct_zeros = encrypted_inputs
+    t0 = time.perf_counter()
+    # The model returns the SSE score and the reconstruction; only the
+    # score is decrypted.
+    encrypted_sse, _ = model.main__preprocessed(
+        cc, encrypted_features, *ct_zeros, prep_struct
+    )
+    t1 = time.perf_counter()
+    report_data.eval_latency_s[idx] = t1 - t0
+    report_data.record_phase("evaluate", t0, t1)
+    return encrypted_sse
+
+  def decrypt(idx, encrypted_sse):
+    t0 = time.perf_counter()
+    decrypted_sse = model.main__decrypt__result0(
+        cc, encrypted_sse, secret_key
+    )
+    report_data.record_phase("decrypt", t0, time.perf_counter())
+    return float(decrypted_sse[0]) / num_features
+
+  scores = [0.0] * num_samples
+
+  def report(idx, score):
+    scores[idx] = score
+    result = "ANOMALY" if score >= args.threshold else "BENIGN"
+    print(
+        f"  Sample [{idx + 1:2d}/{num_samples:2d}] -> FHE MSE: {score:11.6e} |"
+        f" Result: {result:<7} | Eval Latency:"
+        f" {report_data.eval_latency_s[idx] * 1000:.2f} ms"
+    )
+
+  if args.pipeline:
+    print("\nStarting pipelined FHE evaluation suite...")
+    print(
+        f"  Workers: {args.encrypt_workers} encrypt /"
+        f" {args.evaluate_workers} evaluate / {args.decrypt_workers} decrypt,"
+        f" queue depth {args.queue_depth}"
+    )
+    stats = pipeline.run_pipeline(
+        num_samples,
+        encrypt,
+        evaluate,
+        decrypt,
+        report,
+        encrypt_workers=args.encrypt_workers,
+        evaluate_workers=args.evaluate_workers,
+        decrypt_workers=args.decrypt_workers,
+        queue_depth=args.queue_depth,
+    )
+    total_time = stats.total_s
+    print(
+        f"\nTime to first result: {stats.first_result_s:.2f} seconds, max"
+        f" samples in flight: {stats.max_in_flight}"
+    )
+  else:
+    print("\nStarting FHE evaluation suite...")
+    suite_start_time = time.time()
+    for idx in range(num_samples):
+      report(idx, decrypt(idx, evaluate(idx, encrypt(idx))))
+    total_time = time.time() - suite_start_time
+
+  is_anomaly = np.array(scores) >= args.threshold
+  if labels is not None:
+    report_data.correct = int(np.sum(is_anomaly == (np.array(labels) == 1)))
+  report_data.write(args.report)
+
+  if num_samples == 0:
+    return
+  print("\n--- Suite FHE Evaluation Summary ---")
+  print(f"Total Samples Evaluated:   {num_samples}")
+  print(f"Average Anomaly MSE Score: {np.mean(scores):e}")
+  print(f"Min Anomaly MSE Score:     {np.min(scores):e}")
+  print(f"Max Anomaly MSE Score:     {np.max(scores):e}")
+  print(
+      f"Packets Flagged Anomaly:   {int(np.sum(is_anomaly))} / {num_samples}"
+      f" ({np.mean(is_anomaly):.2%})"
+  )
+  print(f"Total Evaluation Time:     {total_time:.2f} seconds")
+  print(
+      f"Throughput:                {num_samples / total_time:.2f} samples/s"
+      f" (average {total_time / num_samples * 1000:.2f} ms per sample)"
+  )
+  if labels is not None:
+    print(
+        f"Accuracy:                  {report_data.correct}/{num_samples}"
+        f" ({report_data.correct / num_samples:.2%})"
+    )
+
+
+if __name__ == "__main__":
+  main()
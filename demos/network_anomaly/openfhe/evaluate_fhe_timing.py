@@ -0,0 +1,95 @@
+"""Evaluate the 5-feature KitNET model with timing callbacks using OpenFHE."""
+
+import argparse
+import time
+
+from demos.network_anomaly.openfhe import anomaly_model_timing_pybind
+from demos.network_anomaly.openfhe import packet_data
+
+NUM_FEATURES = 5
+
+
+def main():
+  parser = argparse.ArgumentParser()
+  parser.add_argument(
+      "--sample_idx", type=int, default=0, help="Packet sample index"
+  )
+  parser.add_argument(
+      "--data_path", type=str, default=packet_data.DATA_PATHS[NUM_FEATURES]
+  )
+  parser.add_argument(
+      "--runs", type=int, default=3, help="Number of repeated evaluations"
+  )
+  args = parser.parse_args()
+
+  print(f"Loading packet sample {args.sample_idx} from {args.data_path}...")
+  packets = packet_data.load_packets(
+      args.data_path, 1, NUM_FEATURES, start=args.sample_idx
+  )
+  if not packets:
+    raise ValueError(f"Sample {args.sample_idx} is out of range")
+  features = packets[0]
+
+  print("Generating crypto context...")
+  t0 = time.time()
+  cc = anomaly_model_timing_pybind.main__generate_crypto_context()
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Generating key pair...")
+  t0 = time.time()
+  key_pair = cc.KeyGen()
+  public_key = key_pair.publicKey
+  secret_key = key_pair.secretKey
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Configuring crypto context...")
+  t0 = time.time()
+  cc = anomaly_model_timing_pybind.main__configure_crypto_context(
+      cc, secret_key
+  )
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  print("Running preprocessing...")
+  t0 = time.time()
+  prep_struct = anomaly_model_timing_pybind.main__preprocessing(cc)
+  print(f"  Took {time.time() - t0:.4f} seconds")
+
+  # Each run prints the timing of every annotated layer, followed by the
+  # phase latencies of the run.
+  total_enc = total_eval = total_dec = 0.0
+  sse = 0.0
+  for run in range(1, args.runs + 1):
+    print(f"\n--- Run {run}/{args.runs} ---")
+    t0 = time.perf_counter()
+    encrypted_features = anomaly_model_timing_pybind.main__encrypt__arg0(
+        cc, features, public_key
+    )
+    t1 = time.perf_counter()
+    encrypted_sse, _ = anomaly_model_timing_pybind.main__preprocessed(
+        cc, secret_key, encrypted_features, prep_struct
+    )
+    t2 = time.perf_counter()
+    decrypted_sse = anomaly_model_timing_pybind.main__decrypt__result0(
+        cc, encrypted_sse, secret_key
+    )
+    t3 = time.perf_counter()
+    sse = float(decrypted_sse[0])
+    total_enc += t1 - t0
+    total_eval += t2 - t1
+    total_dec += t3 - t2
+    print(
+        f"Run {run}/{args.runs} -> Encrypt: {(t1 - t0) * 1000:8.2f} ms |"
+        f" FHE Eval: {(t2 - t1) * 1000:8.2f} ms | Decrypt:"
+        f" {(t3 - t2) * 1000:8.2f} ms"
+    )
+
+  runs = max(args.runs, 1)
+  print("\n--- Timing Summary (averages over runs) ---")
+  print(f"Encryption Latency:     {total_enc / runs * 1000:10.2f} ms")
+  print(f"FHE Evaluation Latency: {total_eval / runs * 1000:10.2f} ms")
+  print(f"Decryption Latency:     {total_dec / runs * 1000:10.2f} ms")
+  print(f"Decrypted SSE Score:    {sse:e} (MSE: {sse / NUM_FEATURES:e})")
+
+
+if __name__ == "__main__":
+  main()
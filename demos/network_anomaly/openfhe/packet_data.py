@@ -0,0 +1,59 @@
+"""Loads KitNET packet features and labels for the OpenFHE drivers.
+
+The dataset files hold the packets back to back, each as num_features
+little-endian float64 values, and are read directly with numpy.
+"""
+
+import csv
+import os
+
+import numpy as np
+
+from demos.common.python import path_utils
+
+resolve_path = path_utils.resolve_path
+
+DATA_DIR = "demos/network_anomaly/data"
+LABELS_PATH = os.path.join(DATA_DIR, "Mirai_labels.csv")
+
+# Dataset file of each model, by number of features.
+DATA_PATHS = {
+    5: os.path.join(DATA_DIR, "Mirai_first_batch_32K.bin"),
+    50: os.path.join(DATA_DIR, "Mirai_full_50_features_32K.bin"),
+}
+
+
+def load_packets(
+    data_path: str, num_samples: int, num_features: int, start: int = 0
+) -> list[list[float]]:
+  """Returns up to num_samples packets from sample index start on."""
+  bytes_per_sample = num_features * 8
+  with open(resolve_path(data_path), "rb") as f:
+    f.seek(start * bytes_per_sample)
+    raw_bytes = f.read(num_samples * bytes_per_sample)
+  num_read = len(raw_bytes) // bytes_per_sample
+  packets = np.frombuffer(
+      raw_bytes[: num_read * bytes_per_sample], dtype="<f8"
+  ).reshape((num_read, num_features))
+  return packets.astype(np.float32).tolist()
+
+
+def load_labels(labels_path: str, max_samples: int) -> list[int] | None:
+  """Returns the first labels (0=benign, 1=anomaly), or None if missing."""
+  resolved_path = resolve_path(labels_path)
+  if not os.path.exists(resolved_path):
+    return None
+  labels = []
+  with open(resolved_path, "r", encoding="utf-8") as f:
+    reader = csv.reader(f)
+    next(reader, None)
+    for row in reader:
+      if len(labels) >= max_samples:
+        break
+      if not row:
+        continue
+      try:
+        labels.append(int(float(row[1] if len(row) >= 2 else row[0])))
+      except ValueError:
+        continue
+  return labels